@@ -3,8 +3,39 @@
 #include <stdio.h>
 #include <math.h>
 #include <limits.h>
+#include <errno.h>
 #include "duckdb.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define DUCKDB_EX_AVX2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DUCKDB_EX_NEON 1
+#endif
+
+// Linux USDT probes (provider duckdb_ex) marking where dirty-scheduler time goes, for perf and
+// bpftrace. Built with -DDUCKDB_EX_USDT (`make profile`) when <sys/sdt.h> is available, and
+// no-ops otherwise. Arguments are not evaluated when the probes are compiled out.
+//   query_start(sql)              query_done(ok)      sql is NULL for prepared statements
+//   decode_start(rows, columns)   decode_done(rows)   one pair per decoded chunk
+//   append_batch_start(rows, columns)   append_batch_done(ok)
+//   append_row_done(ok)           one per row appended value by value (end_row)
+//   flush_start()                 flush_done(ok)      appender flush and close
+#if defined(DUCKDB_EX_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define PROBE0(name) DTRACE_PROBE(duckdb_ex, name)
+#define PROBE1(name, a) DTRACE_PROBE1(duckdb_ex, name, a)
+#define PROBE2(name, a, b) DTRACE_PROBE2(duckdb_ex, name, a, b)
+#endif
+#endif
+#ifndef PROBE0
+#define PROBE0(name) ((void)0)
+#define PROBE1(name, a) ((void)0)
+#define PROBE2(name, a, b) ((void)0)
+#endif
+
 // Resource types
 static ErlNifResourceType *database_resource_type;
 static ErlNifResourceType *connection_resource_type;
@@ -13,32 +44,161 @@ static ErlNifResourceType *prepared_statement_resource_type;
 static ErlNifResourceType *data_chunk_resource_type;
 static ErlNifResourceType *appender_resource_type;
 static ErlNifResourceType *config_resource_type;
+static ErlNifResourceType *decode_state_resource_type;
 
 // Resource wrappers
+// Databases and connections can be closed explicitly while other processes still hold them.
+// Users take the read lock around each use of the handle and closing takes the write lock, so
+// a close waits for running queries and later users see a NULL handle.
 typedef struct {
 	duckdb_database db;
+	ErlNifRWLock *lock;
 } DatabaseResource;
 
 typedef struct {
 	duckdb_connection conn;
+	ErlNifRWLock *lock;
 } ConnectionResource;
 
+// Single-producer/single-consumer ring of prefetched chunks. A background thread pulls chunks
+// from a streaming result while the BEAM decodes the previous ones. `head` is only written by
+// the consumer and `tail` only by the producer, so the fast path needs no locking; the mutex
+// and condition variable are only used to park whichever side has to wait.
 typedef struct {
-	duckdb_result result;
-} ResultResource;
-
+	ErlNifTid thread;
+	duckdb_data_chunk *ring;
+	idx_t capacity;
+	idx_t head;
+	idx_t tail;
+	int done;
+	int stop;
+	int producer_waiting;
+	int consumer_waiting;
+	ErlNifMutex *mutex;
+	ErlNifCond *cond;
+} ChunkPrefetcher;
+
+// A statement can be shared by several processes, e.g. through DuckdbEx.Query. Binding its
+// parameters and starting execution happen under `lock`, so concurrent executions never see
+// each other's binds.
 typedef struct {
 	duckdb_prepared_statement stmt;
+	ErlNifMutex *lock;
 } PreparedStatementResource;
 
+// A result is either fully materialized by DuckDB, buffered (a streaming result drained into
+// `chunks` while enforcing materialization limits), or streaming (chunks are pulled on demand,
+// starting with whatever was already buffered). All access goes through `lock`; once
+// `destroyed` is set the DuckDB memory is gone and every accessor returns an error.
+typedef struct {
+	duckdb_result result;
+	ErlNifRWLock *lock;
+	bool destroyed;
+	bool buffered;
+	bool streaming;
+	// Streaming execution keeps the statement alive for as long as the result is readable
+	duckdb_prepared_statement stmt;
+	duckdb_pending_result pending;
+	duckdb_data_chunk *chunks;
+	idx_t chunk_total;
+	idx_t chunk_capacity;
+	idx_t buffered_rows;
+	// Next chunk handed out by result_fetch_chunk
+	idx_t cursor;
+	// Temporary Parquet file backing a spilled result, removed together with the result
+	char *spill_path;
+	// Background fetching for streaming results, NULL unless requested
+	ChunkPrefetcher *prefetch;
+	// Column descriptors from result_columns_full, built once and kept in their own environment
+	ErlNifEnv *columns_env;
+	ERL_NIF_TERM columns_full;
+	// Prepared statement a streamed execution reads from, kept until the result is freed
+	PreparedStatementResource *stmt_owner;
+	// String dictionaries of next_chunk reads with dedup_strings, shared by every chunk of the
+	// result; their terms stay in `dict_env` between calls
+	struct DecodeContext *fetch_ctx;
+	ErlNifEnv *dict_env;
+} ResultResource;
+
+// Chunks keep their parent result alive and are only readable while it has not been destroyed,
+// since DuckDB chunks may reference memory owned by the result. Chunks taken from a buffered
+// result are borrowed and freed together with it.
 typedef struct {
 	duckdb_data_chunk chunk;
+	ResultResource *owner;
+	bool borrowed;
 } DataChunkResource;
 
 typedef struct {
 	duckdb_appender appender;
 } AppenderResource;
 
+#define DECODE_MAX_JSON_KEYS 64
+// Nesting limit of decoded JSON documents, keeps the parser's recursion off the end of the stack
+#define JSON_MAX_DEPTH 512
+// Longest JSON integer turned into a bignum; the conversion is quadratic in the digit count
+#define JSON_MAX_INTEGER_DIGITS 1024
+
+// Options for the chunk decoders, parsed from the map built by DuckdbEx.Result
+typedef struct {
+	// Distinct VARCHAR values remembered per column before deduplication gives up; 0 disables it
+	idx_t dedup_strings;
+	// UUIDs as their 16 raw bytes instead of the canonical 36 character string
+	bool uuid_raw;
+	// DATE, TIME and TIMESTAMP values as plain integers in their storage unit
+	bool temporal_raw;
+	// LIST/ARRAY of fixed-width numbers as one binary of native-endian elements
+	bool numeric_lists_packed;
+	// NaN and infinities as nil instead of :nan, :infinity and :negative_infinity
+	bool nan_nil;
+	// JSON columns as decoded maps and lists instead of their text
+	bool json_decode;
+	// Object keys returned as atoms when they match one of these, all others stay binaries
+	unsigned json_key_count;
+	ERL_NIF_TERM json_keys[DECODE_MAX_JSON_KEYS];
+} DecodeOptions;
+
+// Open-addressing table of the distinct strings seen in one column, so repeated values reuse
+// the binary created for their first occurrence. `terms` is only valid within the NIF call that
+// filled it; rescheduling decoders carry it to the next call as a tuple.
+typedef struct {
+	uint64_t hash;
+	uint32_t length;
+	uint32_t slot;
+	char *bytes;
+} StringDictEntry;
+
+// Largest distinct-value cutoff accepted for dedup_strings
+#define STRING_DICT_MAX_COUNT (1 << 20)
+
+typedef struct {
+	bool disabled;
+	idx_t count;
+	idx_t max_count;
+	idx_t mask;
+	StringDictEntry *entries;
+	ERL_NIF_TERM *terms;
+	// Dictionaries kept across calls (next_chunk reads) also hold every term in `resident_env`.
+	// A call only copies the entries it hits into its own environment, marking them with the
+	// call's `generation`, so a chunk costs its own rows rather than the dictionary size.
+	ErlNifEnv *resident_env;
+	ERL_NIF_TERM *resident;
+	uint32_t *loaded;
+	uint32_t generation;
+} StringDict;
+
+typedef struct DecodeContext {
+	DecodeOptions opts;
+	idx_t column_count;
+	// One dictionary per column when string deduplication is enabled, NULL otherwise
+	StringDict *dicts;
+} DecodeContext;
+
+// Decode state of a result walk that spans several rescheduled NIF calls
+typedef struct {
+	DecodeContext ctx;
+} DecodeStateResource;
+
 typedef struct {
 	duckdb_config config;
 } ConfigResource;
@@ -49,6 +209,24 @@ static ERL_NIF_TERM atom_ok;
 static ERL_NIF_TERM atom_error;
 static ERL_NIF_TERM atom_nil;
 static ERL_NIF_TERM atom_memory;
+static ERL_NIF_TERM atom_done;
+static ERL_NIF_TERM atom_stream;
+static ERL_NIF_TERM atom_limit_exceeded;
+static ERL_NIF_TERM atom_spill;
+static ERL_NIF_TERM atom_dedup_strings;
+static ERL_NIF_TERM atom_raw;
+static ERL_NIF_TERM atom_string;
+static ERL_NIF_TERM atom_temporal;
+static ERL_NIF_TERM atom_native;
+static ERL_NIF_TERM atom_numeric_lists;
+static ERL_NIF_TERM atom_nan;
+static ERL_NIF_TERM atom_infinity;
+static ERL_NIF_TERM atom_negative_infinity;
+static ERL_NIF_TERM atom_atom;
+static ERL_NIF_TERM atom_packed;
+static ERL_NIF_TERM atom_json;
+static ERL_NIF_TERM atom_json_keys;
+static ERL_NIF_TERM atom_decode;
 
 // Type atoms for columns
 static ERL_NIF_TERM atom_boolean;
@@ -86,6 +264,42 @@ static ERL_NIF_TERM atom_timestamp_ns;
 static ERL_NIF_TERM atom_timestamp_tz;
 static ERL_NIF_TERM atom_unknown;
 
+// Keys and modules of the Date, Time and DateTime structs built by the decoders
+static ERL_NIF_TERM atom_struct_key;
+static ERL_NIF_TERM atom_date_module;
+static ERL_NIF_TERM atom_time_module;
+static ERL_NIF_TERM atom_datetime_module;
+static ERL_NIF_TERM atom_calendar;
+static ERL_NIF_TERM atom_calendar_iso;
+static ERL_NIF_TERM atom_year;
+static ERL_NIF_TERM atom_month;
+static ERL_NIF_TERM atom_day;
+static ERL_NIF_TERM atom_hour;
+static ERL_NIF_TERM atom_minute;
+static ERL_NIF_TERM atom_second;
+static ERL_NIF_TERM atom_microsecond;
+static ERL_NIF_TERM atom_time_zone;
+static ERL_NIF_TERM atom_zone_abbr;
+static ERL_NIF_TERM atom_utc_offset;
+static ERL_NIF_TERM atom_std_offset;
+
+// Keys of the column and logical type descriptors
+static ERL_NIF_TERM atom_name;
+static ERL_NIF_TERM atom_type;
+static ERL_NIF_TERM atom_logical_type;
+static ERL_NIF_TERM atom_width;
+static ERL_NIF_TERM atom_scale;
+static ERL_NIF_TERM atom_child;
+static ERL_NIF_TERM atom_size;
+static ERL_NIF_TERM atom_fields;
+static ERL_NIF_TERM atom_key;
+static ERL_NIF_TERM atom_value;
+static ERL_NIF_TERM atom_values;
+static ERL_NIF_TERM atom_members;
+static ERL_NIF_TERM atom_alias;
+static ERL_NIF_TERM atom_params;
+static ERL_NIF_TERM atom_columns;
+
 // Helper functions
 static ERL_NIF_TERM make_error(ErlNifEnv *env, const char *error_msg) {
 	ErlNifBinary bin;
@@ -100,32 +314,203 @@ static ERL_NIF_TERM make_ok(ErlNifEnv *env, ERL_NIF_TERM term) {
 	return enif_make_tuple2(env, atom_ok, term);
 }
 
-// Helper function to convert hugeint to Elixir integer with full precision
-// Helper function to convert hugeint using varchar extraction (preserves full precision)
-static ERL_NIF_TERM hugeint_to_elixir_integer_via_varchar(ErlNifEnv *env, duckdb_result *result, idx_t col, idx_t row) {
-	// Use DuckDB's built-in string conversion which preserves full precision
-	char *str = duckdb_value_varchar(result, col, row);
-	if (str == NULL) {
+static ERL_NIF_TERM make_text_term(ErlNifEnv *env, const char *text) {
+	size_t len = strlen(text);
+	ERL_NIF_TERM term;
+	memcpy(enif_make_new_binary(env, len, &term), text, len);
+	return term;
+}
+
+static ERL_NIF_TERM make_binary_from(ErlNifEnv *env, const char *data, size_t length) {
+	ErlNifBinary bin;
+	enif_alloc_binary(length, &bin);
+	memcpy(bin.data, data, length);
+	return enif_make_binary(env, &bin);
+}
+
+// Builds a bignum from its little-endian magnitude bytes by decoding it as a SMALL_BIG_EXT or
+// LARGE_BIG_EXT external term, which is the only way to create a bignum from a NIF
+static ERL_NIF_TERM make_bignum_term(ErlNifEnv *env, const unsigned char *magnitude, size_t length, bool negative) {
+	while (length > 0 && magnitude[length - 1] == 0) {
+		length--;
+	}
+
+	size_t header = length <= 255 ? 4 : 7;
+	unsigned char *ext = enif_alloc(header + length);
+	if (!ext) {
 		return atom_nil;
 	}
+	ext[0] = 131;
+	if (header == 4) {
+		ext[1] = 110;
+		ext[2] = (unsigned char)length;
+	} else {
+		ext[1] = 111;
+		for (int i = 0; i < 4; i++) {
+			ext[2 + i] = (unsigned char)(length >> (8 * (3 - i)));
+		}
+	}
+	ext[header - 1] = negative ? 1 : 0;
+	memcpy(ext + header, magnitude, length);
 
-	// Try to parse as int64 first for efficiency
-	char *endptr;
-	long long val = strtoll(str, &endptr, 10);
+	ERL_NIF_TERM term;
+	if (!enif_binary_to_term(env, ext, header + length, &term, 0)) {
+		term = atom_nil;
+	}
+	enif_free(ext);
+	return term;
+}
 
-	// If the entire string was consumed and fits in int64, return as integer
-	if (*endptr == '\0' && val != LLONG_MAX && val != LLONG_MIN) {
-		duckdb_free(str);
-		return enif_make_int64(env, val);
+// Builds an integer from a 128-bit value, as a bignum outside the 64-bit range
+static ERL_NIF_TERM make_int128_term(ErlNifEnv *env, uint64_t upper, uint64_t lower, bool is_signed) {
+	bool negative = is_signed && (int64_t)upper < 0;
+
+	if (!negative && upper == 0) {
+		return enif_make_uint64(env, lower);
+	}
+	if (negative && upper == UINT64_MAX && lower >= (((uint64_t)1) << 63)) {
+		return enif_make_int64(env, (int64_t)lower);
 	}
 
-	// For very large numbers, return as binary string for TypeConverter to parse
-	ErlNifBinary bin;
-	size_t len = strlen(str);
-	enif_alloc_binary(len, &bin);
-	memcpy(bin.data, str, len);
-	duckdb_free(str);
-	return enif_make_binary(env, &bin);
+	// Two's complement magnitude of negative values
+	if (negative) {
+		lower = ~lower + 1;
+		upper = ~upper + (lower == 0 ? 1 : 0);
+	}
+
+	unsigned char magnitude[16];
+	for (int i = 0; i < 8; i++) {
+		magnitude[i] = (unsigned char)(lower >> (8 * i));
+		magnitude[8 + i] = (unsigned char)(upper >> (8 * i));
+	}
+	return make_bignum_term(env, magnitude, sizeof(magnitude), negative);
+}
+
+// Fractional digits DuckDB prints for a microsecond value, trailing zeros dropped
+static int micros_precision(int32_t micros) {
+	if (micros == 0) {
+		return 0;
+	}
+	int precision = 6;
+	while (micros % 10 == 0) {
+		micros /= 10;
+		precision--;
+	}
+	return precision;
+}
+
+static ERL_NIF_TERM make_date_term(ErlNifEnv *env, duckdb_date_struct date) {
+	ERL_NIF_TERM keys[] = {atom_struct_key, atom_calendar, atom_year, atom_month, atom_day};
+	ERL_NIF_TERM values[] = {atom_date_module, atom_calendar_iso, enif_make_int(env, date.year),
+	                         enif_make_int(env, date.month), enif_make_int(env, date.day)};
+	ERL_NIF_TERM term;
+	enif_make_map_from_arrays(env, keys, values, 5, &term);
+	return term;
+}
+
+static ERL_NIF_TERM make_time_term(ErlNifEnv *env, duckdb_time_struct time, int precision) {
+	ERL_NIF_TERM keys[] = {atom_struct_key, atom_calendar, atom_hour, atom_minute, atom_second, atom_microsecond};
+	ERL_NIF_TERM values[] = {atom_time_module,
+	                         atom_calendar_iso,
+	                         enif_make_int(env, time.hour),
+	                         enif_make_int(env, time.min),
+	                         enif_make_int(env, time.sec),
+	                         enif_make_tuple2(env, enif_make_int(env, time.micros), enif_make_int(env, precision))};
+	ERL_NIF_TERM term;
+	enif_make_map_from_arrays(env, keys, values, 6, &term);
+	return term;
+}
+
+// TIMESTAMP values are UTC DateTimes
+static ERL_NIF_TERM make_datetime_term(ErlNifEnv *env, duckdb_timestamp_struct ts, int precision) {
+	ERL_NIF_TERM keys[] = {atom_struct_key, atom_calendar,    atom_year,      atom_month,    atom_day,
+	                       atom_hour,       atom_minute,      atom_second,    atom_microsecond,
+	                       atom_time_zone,  atom_zone_abbr,   atom_utc_offset, atom_std_offset};
+	ERL_NIF_TERM values[] = {atom_datetime_module,
+	                         atom_calendar_iso,
+	                         enif_make_int(env, ts.date.year),
+	                         enif_make_int(env, ts.date.month),
+	                         enif_make_int(env, ts.date.day),
+	                         enif_make_int(env, ts.time.hour),
+	                         enif_make_int(env, ts.time.min),
+	                         enif_make_int(env, ts.time.sec),
+	                         enif_make_tuple2(env, enif_make_int(env, ts.time.micros), enif_make_int(env, precision)),
+	                         make_text_term(env, "Etc/UTC"),
+	                         make_text_term(env, "UTC"),
+	                         enif_make_int(env, 0),
+	                         enif_make_int(env, 0)};
+	ERL_NIF_TERM term;
+	enif_make_map_from_arrays(env, keys, values, 13, &term);
+	return term;
+}
+
+// TIMESTAMP_S, _MS and _NS values, scaled to microseconds since the epoch
+static ERL_NIF_TERM make_epoch_datetime_term(ErlNifEnv *env, int64_t micros, int precision) {
+	duckdb_timestamp timestamp = {micros};
+	return make_datetime_term(env, duckdb_from_timestamp(timestamp), precision);
+}
+
+// FLOAT and DOUBLE values. enif_make_double rejects NaN and infinities, which become atoms or nil.
+static ERL_NIF_TERM make_float_term(ErlNifEnv *env, double value, bool nan_nil) {
+	if (isfinite(value)) {
+		return enif_make_double(env, value);
+	}
+	if (nan_nil) {
+		return atom_nil;
+	}
+	if (isnan(value)) {
+		return atom_nan;
+	}
+	return value > 0 ? atom_infinity : atom_negative_infinity;
+}
+
+// DATE and TIMESTAMP can hold infinity, which no Elixir calendar type represents
+static ERL_NIF_TERM make_infinity_term(ErlNifEnv *env, bool positive) {
+	return make_text_term(env, positive ? "infinity" : "-infinity");
+}
+
+// BIT values are stored as a padding count followed by the bits, left-padded to whole bytes.
+// Bitstrings that do not end on a byte boundary can only be created through the external term
+// format (BIT_BINARY_EXT), so the bits are shifted into place in an encoded term.
+static ERL_NIF_TERM make_bitstring_term(ErlNifEnv *env, const uint8_t *bytes, uint32_t length) {
+	if (length < 2 || bytes[0] >= 8) {
+		return make_text_term(env, "");
+	}
+
+	uint8_t padding = bytes[0];
+	const uint8_t *bits = bytes + 1;
+	size_t data_len = length - 1;
+	size_t bit_count = data_len * 8 - padding;
+	size_t byte_count = (bit_count + 7) / 8;
+	uint8_t tail_bits = (uint8_t)(bit_count % 8 == 0 ? 8 : bit_count % 8);
+
+	unsigned char *ext = enif_alloc(7 + byte_count);
+	if (!ext) {
+		return atom_nil;
+	}
+	ext[0] = 131;
+	ext[1] = 77;
+	ext[2] = (unsigned char)(byte_count >> 24);
+	ext[3] = (unsigned char)(byte_count >> 16);
+	ext[4] = (unsigned char)(byte_count >> 8);
+	ext[5] = (unsigned char)byte_count;
+	ext[6] = tail_bits;
+
+	for (size_t i = 0; i < byte_count; i++) {
+		uint8_t high = (uint8_t)(bits[i] << padding);
+		uint8_t low = padding > 0 && i + 1 < data_len ? (uint8_t)(bits[i + 1] >> (8 - padding)) : 0;
+		ext[7 + i] = high | low;
+	}
+	if (byte_count > 0) {
+		ext[6 + byte_count] &= (uint8_t)(0xFF << (8 - tail_bits));
+	}
+
+	ERL_NIF_TERM term;
+	if (!enif_binary_to_term(env, ext, 7 + byte_count, &term, 0)) {
+		term = atom_nil;
+	}
+	enif_free(ext);
+	return term;
 }
 
 // Forward declaration for robust type extraction
@@ -210,6 +595,9 @@ static void database_resource_destructor(ErlNifEnv *env, void *obj) {
 	if (res->db) {
 		duckdb_close(&res->db);
 	}
+	if (res->lock) {
+		enif_rwlock_destroy(res->lock);
+	}
 }
 
 static void connection_resource_destructor(ErlNifEnv *env, void *obj) {
@@ -217,23 +605,137 @@ static void connection_resource_destructor(ErlNifEnv *env, void *obj) {
 	if (res->conn) {
 		duckdb_disconnect(&res->conn);
 	}
+	if (res->lock) {
+		enif_rwlock_destroy(res->lock);
+	}
+}
+
+// Takes the connection's read lock. Returns false, with the lock already dropped, if the
+// connection was closed.
+static bool connection_acquire(ConnectionResource *res) {
+	enif_rwlock_rlock(res->lock);
+	if (!res->conn) {
+		enif_rwlock_runlock(res->lock);
+		return false;
+	}
+	return true;
+}
+
+static void connection_release(ConnectionResource *res) {
+	enif_rwlock_runlock(res->lock);
+}
+
+static const char *connection_closed_error = "Connection has been closed";
+
+static DatabaseResource *database_resource_alloc(void) {
+	DatabaseResource *res = enif_alloc_resource(database_resource_type, sizeof(DatabaseResource));
+	if (!res) {
+		return NULL;
+	}
+	res->db = NULL;
+	res->lock = enif_rwlock_create("duckdb_ex_database");
+	if (!res->lock) {
+		enif_release_resource(res);
+		return NULL;
+	}
+	return res;
+}
+
+static ConnectionResource *connection_resource_alloc(void) {
+	ConnectionResource *res = enif_alloc_resource(connection_resource_type, sizeof(ConnectionResource));
+	if (!res) {
+		return NULL;
+	}
+	res->conn = NULL;
+	res->lock = enif_rwlock_create("duckdb_ex_connection");
+	if (!res->lock) {
+		enif_release_resource(res);
+		return NULL;
+	}
+	return res;
+}
+
+static void prefetcher_stop(ChunkPrefetcher *prefetch);
+static void decode_context_free(DecodeContext *ctx);
+
+// Releases everything DuckDB owns for this result. Callers hold the write lock (or are the
+// destructor); safe to call more than once.
+static void result_resource_free_data(ResultResource *res) {
+	if (res->destroyed) {
+		return;
+	}
+	// The producer thread must be gone before the result it reads from is destroyed
+	if (res->prefetch) {
+		prefetcher_stop(res->prefetch);
+		res->prefetch = NULL;
+	}
+	for (idx_t i = 0; i < res->chunk_total; i++) {
+		if (res->chunks[i]) {
+			duckdb_destroy_data_chunk(&res->chunks[i]);
+		}
+	}
+	if (res->chunks) {
+		enif_free(res->chunks);
+		res->chunks = NULL;
+	}
+	res->chunk_total = 0;
+	res->chunk_capacity = 0;
+	duckdb_destroy_result(&res->result);
+	if (res->pending) {
+		duckdb_destroy_pending(&res->pending);
+	}
+	if (res->stmt) {
+		duckdb_destroy_prepare(&res->stmt);
+	}
+	if (res->stmt_owner) {
+		enif_release_resource(res->stmt_owner);
+		res->stmt_owner = NULL;
+	}
+	if (res->spill_path) {
+		remove(res->spill_path);
+		enif_free(res->spill_path);
+		res->spill_path = NULL;
+	}
+	if (res->columns_env) {
+		enif_free_env(res->columns_env);
+		res->columns_env = NULL;
+	}
+	if (res->fetch_ctx) {
+		decode_context_free(res->fetch_ctx);
+		enif_free(res->fetch_ctx);
+		res->fetch_ctx = NULL;
+	}
+	if (res->dict_env) {
+		enif_free_env(res->dict_env);
+		res->dict_env = NULL;
+	}
+	res->destroyed = true;
 }
 
 static void result_resource_destructor(ErlNifEnv *env, void *obj) {
 	ResultResource *res = (ResultResource *)obj;
-	duckdb_destroy_result(&res->result);
+	result_resource_free_data(res);
+	if (res->lock) {
+		enif_rwlock_destroy(res->lock);
+	}
 }
 
 static void prepared_statement_resource_destructor(ErlNifEnv *env, void *obj) {
 	PreparedStatementResource *res = (PreparedStatementResource *)obj;
 	duckdb_destroy_prepare(&res->stmt);
+	if (res->lock) {
+		enif_mutex_destroy(res->lock);
+	}
 }
 
 static void data_chunk_resource_destructor(ErlNifEnv *env, void *obj) {
 	DataChunkResource *res = (DataChunkResource *)obj;
-	if (res->chunk) {
+	if (res->chunk && !res->borrowed) {
 		duckdb_destroy_data_chunk(&res->chunk);
 	}
+	if (res->owner) {
+		enif_release_resource(res->owner);
+	}
 }
 
 static void appender_resource_destructor(ErlNifEnv *env, void *obj) {
@@ -250,6 +752,195 @@ static void config_resource_destructor(ErlNifEnv *env, void *obj) {
 	}
 }
 
+// Result lifecycle helpers
+static const char *result_destroyed_error = "Result has been destroyed";
+
+static ResultResource *result_resource_alloc(void) {
+	ResultResource *res = enif_alloc_resource(result_resource_type, sizeof(ResultResource));
+	if (!res) {
+		return NULL;
+	}
+	memset(res, 0, sizeof(ResultResource));
+	res->lock = enif_rwlock_create("duckdb_ex_result");
+	if (!res->lock) {
+		enif_release_resource(res);
+		return NULL;
+	}
+	return res;
+}
+
+static void result_release(ResultResource *res, bool exclusive) {
+	if (exclusive) {
+		enif_rwlock_rwunlock(res->lock);
+	} else {
+		enif_rwlock_runlock(res->lock);
+	}
+}
+
+// Takes the result lock. Returns false, with the lock already dropped, if the result was destroyed.
+static bool result_acquire(ResultResource *res, bool exclusive) {
+	if (exclusive) {
+		enif_rwlock_rwlock(res->lock);
+	} else {
+		enif_rwlock_rlock(res->lock);
+	}
+	if (res->destroyed) {
+		result_release(res, exclusive);
+		return false;
+	}
+	return true;
+}
+
+static bool result_buffer_chunk(ResultResource *res, duckdb_data_chunk chunk) {
+	if (res->chunk_total == res->chunk_capacity) {
+		idx_t capacity = res->chunk_capacity ? res->chunk_capacity * 2 : 16;
+		duckdb_data_chunk *chunks = enif_realloc(res->chunks, sizeof(duckdb_data_chunk) * capacity);
+		if (!chunks) {
+			return false;
+		}
+		res->chunks = chunks;
+		res->chunk_capacity = capacity;
+	}
+	res->chunks[res->chunk_total++] = chunk;
+	res->buffered_rows += duckdb_data_chunk_get_size(chunk);
+	return true;
+}
+
+// Wakes the other side of the prefetch ring if it is parked. The flag is set under the mutex
+// before waiting and the index is stored before it is read here, so a wakeup cannot be lost.
+static void prefetcher_wake(ChunkPrefetcher *prefetch, int *waiting) {
+	if (__atomic_load_n(waiting, __ATOMIC_SEQ_CST)) {
+		enif_mutex_lock(prefetch->mutex);
+		enif_cond_broadcast(prefetch->cond);
+		enif_mutex_unlock(prefetch->mutex);
+	}
+}
+
+static void *prefetcher_run(void *arg) {
+	ResultResource *res = (ResultResource *)arg;
+	ChunkPrefetcher *prefetch = res->prefetch;
+
+	for (;;) {
+		idx_t tail = prefetch->tail;
+		if (tail - __atomic_load_n(&prefetch->head, __ATOMIC_ACQUIRE) == prefetch->capacity) {
+			enif_mutex_lock(prefetch->mutex);
+			__atomic_store_n(&prefetch->producer_waiting, 1, __ATOMIC_SEQ_CST);
+			while (tail - __atomic_load_n(&prefetch->head, __ATOMIC_SEQ_CST) == prefetch->capacity &&
+			       !__atomic_load_n(&prefetch->stop, __ATOMIC_SEQ_CST)) {
+				enif_cond_wait(prefetch->cond, prefetch->mutex);
+			}
+			__atomic_store_n(&prefetch->producer_waiting, 0, __ATOMIC_SEQ_CST);
+			enif_mutex_unlock(prefetch->mutex);
+		}
+
+		if (__atomic_load_n(&prefetch->stop, __ATOMIC_ACQUIRE)) {
+			break;
+		}
+
+		duckdb_data_chunk chunk = duckdb_fetch_chunk(res->result);
+		if (!chunk) {
+			break;
+		}
+
+		prefetch->ring[tail % prefetch->capacity] = chunk;
+		__atomic_store_n(&prefetch->tail, tail + 1, __ATOMIC_SEQ_CST);
+		prefetcher_wake(prefetch, &prefetch->consumer_waiting);
+	}
+
+	__atomic_store_n(&prefetch->done, 1, __ATOMIC_SEQ_CST);
+	prefetcher_wake(prefetch, &prefetch->consumer_waiting);
+	return NULL;
+}
+
+// Starts a producer thread keeping up to `depth` chunks of a streaming result fetched ahead.
+static bool prefetcher_start(ResultResource *res, idx_t depth) {
+	ChunkPrefetcher *prefetch = enif_alloc(sizeof(ChunkPrefetcher));
+	if (!prefetch) {
+		return false;
+	}
+	memset(prefetch, 0, sizeof(ChunkPrefetcher));
+	prefetch->capacity = depth;
+	prefetch->ring = enif_alloc(sizeof(duckdb_data_chunk) * depth);
+	prefetch->mutex = enif_mutex_create("duckdb_ex_prefetch");
+	prefetch->cond = enif_cond_create("duckdb_ex_prefetch");
+
+	res->prefetch = prefetch;
+	if (!prefetch->ring || !prefetch->mutex || !prefetch->cond ||
+	    enif_thread_create("duckdb_ex_prefetch", &prefetch->thread, prefetcher_run, res, NULL) != 0) {
+		if (prefetch->cond) {
+			enif_cond_destroy(prefetch->cond);
+		}
+		if (prefetch->mutex) {
+			enif_mutex_destroy(prefetch->mutex);
+		}
+		if (prefetch->ring) {
+			enif_free(prefetch->ring);
+		}
+		enif_free(prefetch);
+		res->prefetch = NULL;
+		return false;
+	}
+	return true;
+}
+
+// Asks the producer to stop, waits for any fetch in flight and frees chunks nobody consumed.
+static void prefetcher_stop(ChunkPrefetcher *prefetch) {
+	__atomic_store_n(&prefetch->stop, 1, __ATOMIC_SEQ_CST);
+	enif_mutex_lock(prefetch->mutex);
+	enif_cond_broadcast(prefetch->cond);
+	enif_mutex_unlock(prefetch->mutex);
+	enif_thread_join(prefetch->thread, NULL);
+
+	for (idx_t i = prefetch->head; i < prefetch->tail; i++) {
+		duckdb_destroy_data_chunk(&prefetch->ring[i % prefetch->capacity]);
+	}
+	enif_cond_destroy(prefetch->cond);
+	enif_mutex_destroy(prefetch->mutex);
+	enif_free(prefetch->ring);
+	enif_free(prefetch);
+}
+
+// Takes the next chunk off the prefetch ring, parking until the producer delivers one.
+// NULL once the producer has finished and the ring is drained.
+static duckdb_data_chunk prefetcher_next_chunk(ChunkPrefetcher *prefetch) {
+	idx_t head = prefetch->head;
+
+	if (__atomic_load_n(&prefetch->tail, __ATOMIC_ACQUIRE) == head) {
+		enif_mutex_lock(prefetch->mutex);
+		__atomic_store_n(&prefetch->consumer_waiting, 1, __ATOMIC_SEQ_CST);
+		while (__atomic_load_n(&prefetch->tail, __ATOMIC_SEQ_CST) == head &&
+		       !__atomic_load_n(&prefetch->done, __ATOMIC_SEQ_CST)) {
+			enif_cond_wait(prefetch->cond, prefetch->mutex);
+		}
+		__atomic_store_n(&prefetch->consumer_waiting, 0, __ATOMIC_SEQ_CST);
+		enif_mutex_unlock(prefetch->mutex);
+
+		if (__atomic_load_n(&prefetch->tail, __ATOMIC_ACQUIRE) == head) {
+			return NULL;
+		}
+	}
+
+	duckdb_data_chunk chunk = prefetch->ring[head % prefetch->capacity];
+	__atomic_store_n(&prefetch->head, head + 1, __ATOMIC_SEQ_CST);
+	prefetcher_wake(prefetch, &prefetch->producer_waiting);
+	return chunk;
+}
+
+// Hands the next chunk of a streaming result to the caller, who owns it from then on. Chunks
+// buffered while checking limits come first, then the prefetch ring or DuckDB itself.
+// NULL once exhausted.
+static duckdb_data_chunk result_stream_next_chunk(ResultResource *res) {
+	if (res->cursor < res->chunk_total) {
+		duckdb_data_chunk chunk = res->chunks[res->cursor];
+		res->chunks[res->cursor++] = NULL;
+		return chunk;
+	}
+	if (res->prefetch) {
+		return prefetcher_next_chunk(res->prefetch);
+	}
+	return duckdb_fetch_chunk(res->result);
+}
+
 // Database operations
 static ERL_NIF_TERM database_open_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
 	char path[4096];
@@ -281,8 +972,10 @@ static ERL_NIF_TERM database_open_nif(ErlNifEnv *env, int argc, const ERL_NIF_TE
 		}
 	}
 
-	DatabaseResource *res = enif_alloc_resource(database_resource_type, sizeof(DatabaseResource));
-	res->db = NULL;
+	DatabaseResource *res = database_resource_alloc();
+	if (!res) {
+		return make_error(env, "Failed to allocate database");
+	}
 
 	duckdb_state state = duckdb_open(db_path, &res->db);
 	if (state == DuckDBError) {
@@ -332,8 +1025,10 @@ static ERL_NIF_TERM database_open_ext_nif(ErlNifEnv *env, int argc, const ERL_NI
 		return enif_make_badarg(env);
 	}
 
-	DatabaseResource *res = enif_alloc_resource(database_resource_type, sizeof(DatabaseResource));
-	res->db = NULL;
+	DatabaseResource *res = database_resource_alloc();
+	if (!res) {
+		return make_error(env, "Failed to allocate database");
+	}
 
 	char *error_message = NULL;
 	duckdb_state state = duckdb_open_ext(db_path, &res->db, config_res->config, &error_message);
@@ -429,10 +1124,19 @@ static ERL_NIF_TERM connection_open_nif(ErlNifEnv *env, int argc, const ERL_NIF_
 		return enif_make_badarg(env);
 	}
 
-	ConnectionResource *res = enif_alloc_resource(connection_resource_type, sizeof(ConnectionResource));
-	res->conn = NULL;
+	ConnectionResource *res = connection_resource_alloc();
+	if (!res) {
+		return make_error(env, "Failed to allocate connection");
+	}
 
+	enif_rwlock_rlock(db_res->lock);
+	if (!db_res->db) {
+		enif_rwlock_runlock(db_res->lock);
+		enif_release_resource(res);
+		return make_error(env, "Database has been closed");
+	}
 	duckdb_state state = duckdb_connect(db_res->db, &res->conn);
+	enif_rwlock_runlock(db_res->lock);
 	if (state == DuckDBError) {
 		enif_release_resource(res);
 		return make_error(env, "Failed to connect to database");
@@ -443,61 +1147,41 @@ static ERL_NIF_TERM connection_open_nif(ErlNifEnv *env, int argc, const ERL_NIF_
 	return make_ok(env, result);
 }
 
-static ERL_NIF_TERM connection_query_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-	ConnectionResource *conn_res;
-	ErlNifBinary sql_bin;
-	char *sql = NULL;
-	bool allocated_sql = false;
-
-	if (argc != 2) {
-		return enif_make_badarg(env);
-	}
+// Closes the database handle. The instance, with its file and memory, is released once every
+// connection to it is closed as well; new connections are refused right away.
+static ERL_NIF_TERM database_close_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	DatabaseResource *db_res;
 
-	if (!enif_get_resource(env, argv[0], connection_resource_type, (void **)&conn_res)) {
+	if (argc != 1 || !enif_get_resource(env, argv[0], database_resource_type, (void **)&db_res)) {
 		return enif_make_badarg(env);
 	}
 
-	// Try to get as binary first (for longer strings)
-	if (enif_inspect_binary(env, argv[1], &sql_bin)) {
-		sql = enif_alloc(sql_bin.size + 1);
-		if (!sql) {
-			return make_error(env, "Failed to allocate memory for SQL string");
-		}
-		memcpy(sql, sql_bin.data, sql_bin.size);
-		sql[sql_bin.size] = '\0';
-		allocated_sql = true;
-	} else {
-		// Fall back to string for smaller strings
-		static char sql_buffer[8192];
-		if (enif_get_string(env, argv[1], sql_buffer, sizeof(sql_buffer), ERL_NIF_LATIN1) <= 0) {
-			return enif_make_badarg(env);
-		}
-		sql = sql_buffer;
+	enif_rwlock_rwlock(db_res->lock);
+	if (db_res->db) {
+		duckdb_close(&db_res->db);
 	}
+	enif_rwlock_rwunlock(db_res->lock);
+	return atom_ok;
+}
 
-	ResultResource *res = enif_alloc_resource(result_resource_type, sizeof(ResultResource));
-
-	duckdb_state state = duckdb_query(conn_res->conn, sql, &res->result);
+// Disconnects after any query running on the connection finishes. Results, statements and
+// appenders created from it stay readable.
+static ERL_NIF_TERM connection_close_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	ConnectionResource *conn_res;
 
-	if (allocated_sql) {
-		enif_free(sql);
+	if (argc != 1 || !enif_get_resource(env, argv[0], connection_resource_type, (void **)&conn_res)) {
+		return enif_make_badarg(env);
 	}
 
-	if (state == DuckDBError) {
-		const char *error_msg = duckdb_result_error(&res->result);
-		ERL_NIF_TERM error_term = make_error(env, error_msg ? error_msg : "Query failed");
-		duckdb_destroy_result(&res->result);
-		enif_release_resource(res);
-		return error_term;
+	enif_rwlock_rwlock(conn_res->lock);
+	if (conn_res->conn) {
+		duckdb_disconnect(&conn_res->conn);
 	}
-
-	ERL_NIF_TERM result = enif_make_resource(env, res);
-	enif_release_resource(res);
-	return make_ok(env, result);
+	enif_rwlock_rwunlock(conn_res->lock);
+	return atom_ok;
 }
 
-// Prepared statement operations
-static ERL_NIF_TERM prepared_statement_prepare_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM connection_query_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
 	ConnectionResource *conn_res;
 	ErlNifBinary sql_bin;
 	char *sql = NULL;
@@ -529,19 +1213,35 @@ static ERL_NIF_TERM prepared_statement_prepare_nif(ErlNifEnv *env, int argc, con
 		sql = sql_buffer;
 	}
 
-	PreparedStatementResource *res =
-	    enif_alloc_resource(prepared_statement_resource_type, sizeof(PreparedStatementResource));
+	ResultResource *res = result_resource_alloc();
+	if (!res) {
+		if (allocated_sql) {
+			enif_free(sql);
+		}
+		return make_error(env, "Failed to allocate result");
+	}
+
+	if (!connection_acquire(conn_res)) {
+		if (allocated_sql) {
+			enif_free(sql);
+		}
+		enif_release_resource(res);
+		return make_error(env, connection_closed_error);
+	}
 
-	duckdb_state state = duckdb_prepare(conn_res->conn, sql, &res->stmt);
+	PROBE1(query_start, sql);
+	duckdb_state state = duckdb_query(conn_res->conn, sql, &res->result);
+	PROBE1(query_done, state == DuckDBSuccess);
+	connection_release(conn_res);
 
 	if (allocated_sql) {
 		enif_free(sql);
 	}
 
 	if (state == DuckDBError) {
-		const char *error_msg = duckdb_prepare_error(res->stmt);
-		ERL_NIF_TERM error_term = make_error(env, error_msg ? error_msg : "Failed to prepare statement");
-		duckdb_destroy_prepare(&res->stmt);
+		const char *error_msg = duckdb_result_error(&res->result);
+		ERL_NIF_TERM error_term = make_error(env, error_msg ? error_msg : "Query failed");
+		duckdb_destroy_result(&res->result);
 		enif_release_resource(res);
 		return error_term;
 	}
@@ -551,16 +1251,438 @@ static ERL_NIF_TERM prepared_statement_prepare_nif(ErlNifEnv *env, int argc, con
 	return make_ok(env, result);
 }
 
-// Helper function to bind a parameter based on Elixir term type
-static duckdb_state bind_parameter(duckdb_prepared_statement stmt, idx_t param_idx, ErlNifEnv *env,
-                                   ERL_NIF_TERM param) {
-	// Check if it's nil (NULL)
-	if (enif_compare(param, atom_nil) == 0) {
-		return duckdb_bind_null(stmt, param_idx);
-	}
-
-	// Check if it's a boolean
-	if (enif_compare(param, enif_make_atom(env, "true")) == 0) {
+// Rough in-memory footprint of the first `count` rows of a vector, used to enforce
+// max_result_bytes without decoding anything. Strings add their out-of-line payload and
+// nested types recurse into their children.
+static idx_t estimate_vector_bytes(duckdb_vector vector, duckdb_logical_type type, idx_t count) {
+	switch (duckdb_get_type_id(type)) {
+	case DUCKDB_TYPE_BOOLEAN:
+	case DUCKDB_TYPE_TINYINT:
+	case DUCKDB_TYPE_UTINYINT:
+		return count;
+	case DUCKDB_TYPE_SMALLINT:
+	case DUCKDB_TYPE_USMALLINT:
+		return count * 2;
+	case DUCKDB_TYPE_INTEGER:
+	case DUCKDB_TYPE_UINTEGER:
+	case DUCKDB_TYPE_FLOAT:
+	case DUCKDB_TYPE_DATE:
+	case DUCKDB_TYPE_ENUM:
+		return count * 4;
+	case DUCKDB_TYPE_BIGINT:
+	case DUCKDB_TYPE_UBIGINT:
+	case DUCKDB_TYPE_DOUBLE:
+	case DUCKDB_TYPE_TIME:
+	case DUCKDB_TYPE_TIME_TZ:
+	case DUCKDB_TYPE_TIMESTAMP:
+	case DUCKDB_TYPE_TIMESTAMP_S:
+	case DUCKDB_TYPE_TIMESTAMP_MS:
+	case DUCKDB_TYPE_TIMESTAMP_NS:
+	case DUCKDB_TYPE_TIMESTAMP_TZ:
+		return count * 8;
+	case DUCKDB_TYPE_VARCHAR:
+	case DUCKDB_TYPE_BLOB:
+	case DUCKDB_TYPE_BIT: {
+		duckdb_string_t *data = (duckdb_string_t *)duckdb_vector_get_data(vector);
+		uint64_t *validity = duckdb_vector_get_validity(vector);
+		idx_t bytes = count * sizeof(duckdb_string_t);
+		for (idx_t i = 0; i < count; i++) {
+			if (!duckdb_validity_row_is_valid(validity, i)) {
+				continue;
+			}
+			uint32_t length = data[i].value.inlined.length;
+			// Strings of up to 12 bytes are stored inline
+			if (length > 12) {
+				bytes += length;
+			}
+		}
+		return bytes;
+	}
+	case DUCKDB_TYPE_LIST: {
+		duckdb_logical_type child_type = duckdb_list_type_child_type(type);
+		idx_t child_count = duckdb_list_vector_get_size(vector);
+		idx_t bytes = count * sizeof(duckdb_list_entry) +
+		              estimate_vector_bytes(duckdb_list_vector_get_child(vector), child_type, child_count);
+		duckdb_destroy_logical_type(&child_type);
+		return bytes;
+	}
+	case DUCKDB_TYPE_MAP: {
+		duckdb_logical_type key_type = duckdb_map_type_key_type(type);
+		duckdb_logical_type value_type = duckdb_map_type_value_type(type);
+		duckdb_vector child_vector = duckdb_list_vector_get_child(vector);
+		idx_t child_count = duckdb_list_vector_get_size(vector);
+		idx_t bytes = count * sizeof(duckdb_list_entry) +
+		              estimate_vector_bytes(duckdb_struct_vector_get_child(child_vector, 0), key_type, child_count) +
+		              estimate_vector_bytes(duckdb_struct_vector_get_child(child_vector, 1), value_type, child_count);
+		duckdb_destroy_logical_type(&key_type);
+		duckdb_destroy_logical_type(&value_type);
+		return bytes;
+	}
+	case DUCKDB_TYPE_ARRAY: {
+		duckdb_logical_type child_type = duckdb_array_type_child_type(type);
+		idx_t child_count = count * duckdb_array_type_array_size(type);
+		idx_t bytes = estimate_vector_bytes(duckdb_array_vector_get_child(vector), child_type, child_count);
+		duckdb_destroy_logical_type(&child_type);
+		return bytes;
+	}
+	case DUCKDB_TYPE_STRUCT: {
+		idx_t bytes = 0;
+		idx_t child_count = duckdb_struct_type_child_count(type);
+		for (idx_t i = 0; i < child_count; i++) {
+			duckdb_logical_type child_type = duckdb_struct_type_child_type(type, i);
+			bytes += estimate_vector_bytes(duckdb_struct_vector_get_child(vector, i), child_type, count);
+			duckdb_destroy_logical_type(&child_type);
+		}
+		return bytes;
+	}
+	default:
+		// HUGEINT, UUID, INTERVAL, DECIMAL and anything else fit in 16 bytes
+		return count * 16;
+	}
+}
+
+static idx_t estimate_chunk_bytes(duckdb_data_chunk chunk) {
+	idx_t row_count = duckdb_data_chunk_get_size(chunk);
+	idx_t column_count = duckdb_data_chunk_get_column_count(chunk);
+	idx_t bytes = 0;
+
+	for (idx_t c = 0; c < column_count; c++) {
+		duckdb_vector vector = duckdb_data_chunk_get_vector(chunk, c);
+		duckdb_logical_type type = duckdb_vector_get_column_type(vector);
+		bytes += estimate_vector_bytes(vector, type, row_count);
+		duckdb_destroy_logical_type(&type);
+	}
+
+	return bytes;
+}
+
+static char *binary_to_cstring(ErlNifBinary *bin) {
+	char *str = enif_alloc(bin->size + 1);
+	if (str) {
+		memcpy(str, bin->data, bin->size);
+		str[bin->size] = '\0';
+	}
+	return str;
+}
+
+// Streaming executes one prepared statement and spilling wraps one statement in COPY, so scripts
+// are reported with this instead of DuckDB's parser error
+#define MULTI_STATEMENT_ERROR "Streaming and bounded queries take a single SQL statement"
+
+static bool is_multi_statement(duckdb_connection conn, const char *sql) {
+	duckdb_extracted_statements statements = NULL;
+	bool multi = duckdb_extract_statements(conn, sql, &statements) > 1;
+	duckdb_destroy_extracted(&statements);
+	return multi;
+}
+
+// Prepares `sql` and starts streaming execution into `res`, which then owns the statement and
+// pending result. On failure `*error_term` is set and the caller releases `res`.
+static bool result_start_streaming(ErlNifEnv *env, duckdb_connection conn, const char *sql, ResultResource *res,
+                                   ERL_NIF_TERM *error_term) {
+	PROBE1(query_start, sql);
+	if (duckdb_prepare(conn, sql, &res->stmt) == DuckDBError) {
+		const char *error_msg = duckdb_prepare_error(res->stmt);
+		*error_term = make_error(env, error_msg ? error_msg : "Failed to prepare statement");
+		if (is_multi_statement(conn, sql)) {
+			*error_term = make_error(env, MULTI_STATEMENT_ERROR);
+		}
+		PROBE1(query_done, 0);
+		return false;
+	}
+
+	if (duckdb_pending_prepared_streaming(res->stmt, &res->pending) == DuckDBError) {
+		const char *error_msg = duckdb_pending_error(res->pending);
+		*error_term = make_error(env, error_msg ? error_msg : "Failed to start query");
+		PROBE1(query_done, 0);
+		return false;
+	}
+
+	bool ok = duckdb_execute_pending(res->pending, &res->result) == DuckDBSuccess;
+	PROBE1(query_done, ok);
+	if (!ok) {
+		const char *error_msg = duckdb_result_error(&res->result);
+		*error_term = make_error(env, error_msg ? error_msg : "Query failed");
+		return false;
+	}
+
+	return true;
+}
+
+// Runs `sql` once as a COPY into a Parquet file at `path` and starts a streaming read of it
+// into `res`, so results larger than memory only ever live on disk and one chunk at a time in
+// RAM. The file belongs to the result and is removed when it is destroyed or collected.
+// On failure `*error_term` is set and the caller releases `res`.
+static bool result_start_spilled(ErlNifEnv *env, duckdb_connection conn, const char *sql, ErlNifBinary *path_bin,
+                                 ResultResource *res, ERL_NIF_TERM *error_term) {
+	// Single quotes in the path are doubled for the string literal; the statement itself must
+	// not carry a trailing semicolon inside COPY (...), and the closing parenthesis goes on its
+	// own line so a trailing -- comment cannot swallow it
+	size_t sql_len = strlen(sql);
+	while (sql_len > 0 && (sql[sql_len - 1] == ';' || sql[sql_len - 1] == ' ' || sql[sql_len - 1] == '\n' ||
+	                       sql[sql_len - 1] == '\t' || sql[sql_len - 1] == '\r')) {
+		sql_len--;
+	}
+
+	char *literal = enif_alloc(path_bin->size * 2 + 1);
+	if (!literal) {
+		*error_term = make_error(env, "Failed to allocate memory for spill path");
+		return false;
+	}
+	size_t literal_len = 0;
+	for (size_t i = 0; i < path_bin->size; i++) {
+		if (path_bin->data[i] == '\'') {
+			literal[literal_len++] = '\'';
+		}
+		literal[literal_len++] = (char)path_bin->data[i];
+	}
+	literal[literal_len] = '\0';
+
+	size_t copy_size = sql_len + literal_len + 64;
+	char *copy_sql = enif_alloc(copy_size);
+	char *read_sql = enif_alloc(literal_len + 64);
+	if (!copy_sql || !read_sql) {
+		enif_free(literal);
+		if (copy_sql) {
+			enif_free(copy_sql);
+		}
+		if (read_sql) {
+			enif_free(read_sql);
+		}
+		*error_term = make_error(env, "Failed to allocate memory for spilled result");
+		return false;
+	}
+
+	snprintf(copy_sql, copy_size, "COPY (%.*s\n) TO '%s' (FORMAT parquet)", (int)sql_len, sql, literal);
+	snprintf(read_sql, literal_len + 64, "SELECT * FROM read_parquet('%s')", literal);
+	enif_free(literal);
+
+	res->spill_path = binary_to_cstring(path_bin);
+
+	duckdb_result copy_result;
+	PROBE1(query_start, copy_sql);
+	duckdb_state state = duckdb_query(conn, copy_sql, &copy_result);
+	PROBE1(query_done, state == DuckDBSuccess);
+	enif_free(copy_sql);
+	if (state == DuckDBError) {
+		const char *error_msg = duckdb_result_error(&copy_result);
+		*error_term = is_multi_statement(conn, sql) ? make_error(env, MULTI_STATEMENT_ERROR)
+		                                            : make_error(env, error_msg ? error_msg : "Failed to spill result");
+		duckdb_destroy_result(&copy_result);
+		enif_free(read_sql);
+		return false;
+	}
+	duckdb_destroy_result(&copy_result);
+
+	bool started = result_start_streaming(env, conn, read_sql, res, error_term);
+	enif_free(read_sql);
+	return started;
+}
+
+// Runs a query through DuckDB's streaming execution so that materialization can be bounded.
+// argv: [conn, sql, max_rows, max_result_bytes, on_limit, prefetch]; a limit of 0 disables it.
+// Chunks are buffered until the result is exhausted. If a limit is crossed first, on_limit
+// decides what happens:
+//   :error           - the query is dropped and {:error, :limit_exceeded} returned
+//   :stream          - a streaming result resuming from the buffered chunks is returned
+//   {:spill, path}   - a streaming result resuming from the buffered chunks is returned; the
+//                      query was written to a Parquet file at `path` up front and is read
+//                      back from there, so it runs once and spills instead of buffering
+// Without limits and with :stream nothing is buffered at all. A non-zero prefetch depth lets
+// streaming results fetch that many chunks ahead on a background thread.
+static ERL_NIF_TERM connection_query_bounded_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	ConnectionResource *conn_res;
+	ErlNifBinary sql_bin;
+	ErlNifBinary spill_path_bin;
+	ErlNifUInt64 max_rows;
+	ErlNifUInt64 max_bytes;
+	ErlNifUInt64 prefetch_depth;
+	const ERL_NIF_TERM *spill_tuple;
+	int spill_arity;
+	bool stream_on_limit = false;
+	bool spill_on_limit = false;
+
+	if (argc != 6) {
+		return enif_make_badarg(env);
+	}
+
+	if (!enif_get_resource(env, argv[0], connection_resource_type, (void **)&conn_res)) {
+		return enif_make_badarg(env);
+	}
+
+	if (!enif_inspect_iolist_as_binary(env, argv[1], &sql_bin)) {
+		return enif_make_badarg(env);
+	}
+
+	if (!enif_get_uint64(env, argv[2], &max_rows) || !enif_get_uint64(env, argv[3], &max_bytes) ||
+	    !enif_get_uint64(env, argv[5], &prefetch_depth)) {
+		return enif_make_badarg(env);
+	}
+
+	if (enif_is_identical(argv[4], atom_stream)) {
+		stream_on_limit = true;
+	} else if (enif_get_tuple(env, argv[4], &spill_arity, &spill_tuple) && spill_arity == 2 &&
+	           enif_is_identical(spill_tuple[0], atom_spill) &&
+	           enif_inspect_binary(env, spill_tuple[1], &spill_path_bin)) {
+		spill_on_limit = true;
+	} else if (!enif_is_identical(argv[4], atom_error)) {
+		return enif_make_badarg(env);
+	}
+
+	char *sql = binary_to_cstring(&sql_bin);
+	if (!sql) {
+		return make_error(env, "Failed to allocate memory for SQL string");
+	}
+
+	ResultResource *res = result_resource_alloc();
+	if (!res) {
+		enif_free(sql);
+		return make_error(env, "Failed to allocate result");
+	}
+
+	if (!connection_acquire(conn_res)) {
+		enif_free(sql);
+		enif_release_resource(res);
+		return make_error(env, connection_closed_error);
+	}
+
+	// Once started the result only needs its own client context, not the connection
+	ERL_NIF_TERM error_term;
+	bool started = spill_on_limit
+	                   ? result_start_spilled(env, conn_res->conn, sql, &spill_path_bin, res, &error_term)
+	                   : result_start_streaming(env, conn_res->conn, sql, res, &error_term);
+	connection_release(conn_res);
+	enif_free(sql);
+	if (!started) {
+		enif_release_resource(res);
+		return error_term;
+	}
+
+	if (max_rows == 0 && max_bytes == 0 && stream_on_limit) {
+		res->streaming = true;
+	} else {
+		idx_t total_bytes = 0;
+		for (;;) {
+			duckdb_data_chunk chunk = duckdb_fetch_chunk(res->result);
+			if (!chunk) {
+				const char *error_msg = duckdb_result_error(&res->result);
+				if (error_msg) {
+					error_term = make_error(env, error_msg);
+					enif_release_resource(res);
+					return error_term;
+				}
+				res->buffered = true;
+				// Everything fit, so the spill file is not needed past the read that just ended
+				if (res->spill_path && remove(res->spill_path) == 0) {
+					enif_free(res->spill_path);
+					res->spill_path = NULL;
+				}
+				break;
+			}
+
+			total_bytes += estimate_chunk_bytes(chunk);
+			if (!result_buffer_chunk(res, chunk)) {
+				duckdb_destroy_data_chunk(&chunk);
+				enif_release_resource(res);
+				return make_error(env, "Failed to allocate memory for result chunks");
+			}
+
+			if ((max_rows > 0 && res->buffered_rows > max_rows) || (max_bytes > 0 && total_bytes > max_bytes)) {
+				if (stream_on_limit || spill_on_limit) {
+					res->streaming = true;
+					break;
+				}
+
+				enif_release_resource(res);
+				return enif_make_tuple2(env, atom_error, atom_limit_exceeded);
+			}
+		}
+	}
+
+	if (res->streaming && prefetch_depth > 0 && !prefetcher_start(res, (idx_t)prefetch_depth)) {
+		enif_release_resource(res);
+		return make_error(env, "Failed to start chunk prefetching");
+	}
+
+	ERL_NIF_TERM result = enif_make_resource(env, res);
+	enif_release_resource(res);
+	return make_ok(env, result);
+}
+
+// Prepared statement operations
+static ERL_NIF_TERM prepared_statement_prepare_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	ConnectionResource *conn_res;
+	ErlNifBinary sql_bin;
+	char *sql = NULL;
+	bool allocated_sql = false;
+
+	if (argc != 2) {
+		return enif_make_badarg(env);
+	}
+
+	if (!enif_get_resource(env, argv[0], connection_resource_type, (void **)&conn_res)) {
+		return enif_make_badarg(env);
+	}
+
+	// Try to get as binary first (for longer strings)
+	if (enif_inspect_binary(env, argv[1], &sql_bin)) {
+		sql = enif_alloc(sql_bin.size + 1);
+		if (!sql) {
+			return make_error(env, "Failed to allocate memory for SQL string");
+		}
+		memcpy(sql, sql_bin.data, sql_bin.size);
+		sql[sql_bin.size] = '\0';
+		allocated_sql = true;
+	} else {
+		// Fall back to string for smaller strings
+		static char sql_buffer[8192];
+		if (enif_get_string(env, argv[1], sql_buffer, sizeof(sql_buffer), ERL_NIF_LATIN1) <= 0) {
+			return enif_make_badarg(env);
+		}
+		sql = sql_buffer;
+	}
+
+	if (!connection_acquire(conn_res)) {
+		if (allocated_sql) {
+			enif_free(sql);
+		}
+		return make_error(env, connection_closed_error);
+	}
+
+	PreparedStatementResource *res =
+	    enif_alloc_resource(prepared_statement_resource_type, sizeof(PreparedStatementResource));
+	res->stmt = NULL;
+	res->lock = enif_mutex_create("duckdb_ex_prepared_statement");
+
+	duckdb_state state = res->lock ? duckdb_prepare(conn_res->conn, sql, &res->stmt) : DuckDBError;
+	connection_release(conn_res);
+
+	if (allocated_sql) {
+		enif_free(sql);
+	}
+
+	if (state == DuckDBError) {
+		const char *error_msg = res->stmt ? duckdb_prepare_error(res->stmt) : NULL;
+		ERL_NIF_TERM error_term = make_error(env, error_msg ? error_msg : "Failed to prepare statement");
+		enif_release_resource(res);
+		return error_term;
+	}
+
+	ERL_NIF_TERM result = enif_make_resource(env, res);
+	enif_release_resource(res);
+	return make_ok(env, result);
+}
+
+// Helper function to bind a parameter based on Elixir term type
+static duckdb_state bind_parameter(duckdb_prepared_statement stmt, idx_t param_idx, ErlNifEnv *env,
+                                   ERL_NIF_TERM param) {
+	// Check if it's nil (NULL)
+	if (enif_compare(param, atom_nil) == 0) {
+		return duckdb_bind_null(stmt, param_idx);
+	}
+
+	// Check if it's a boolean
+	if (enif_compare(param, enif_make_atom(env, "true")) == 0) {
 		return duckdb_bind_boolean(stmt, param_idx, true);
 	}
 	if (enif_compare(param, enif_make_atom(env, "false")) == 0) {
@@ -605,29 +1727,24 @@ static duckdb_state bind_parameter(duckdb_prepared_statement stmt, idx_t param_i
 	return DuckDBError;
 }
 
-static ERL_NIF_TERM prepared_statement_execute_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-	PreparedStatementResource *stmt_res;
-
-	if (argc != 2) {
-		return enif_make_badarg(env);
-	}
-
-	if (!enif_get_resource(env, argv[0], prepared_statement_resource_type, (void **)&stmt_res)) {
-		return enif_make_badarg(env);
-	}
-
-	// Handle parameter binding from argv[1] list
-	if (!enif_is_list(env, argv[1])) {
-		return enif_make_badarg(env);
+// Binds the `params` list to `stmt`. On failure `*error_term` holds the badarg or error tuple
+// to return.
+static bool bind_parameters(ErlNifEnv *env, duckdb_prepared_statement stmt, ERL_NIF_TERM params,
+                            ERL_NIF_TERM *error_term) {
+	// Handle parameter binding from the params list
+	if (!enif_is_list(env, params)) {
+		*error_term = enif_make_badarg(env);
+		return false;
 	}
 
 	// Get parameter count
-	idx_t param_count = duckdb_nparams(stmt_res->stmt);
+	idx_t param_count = duckdb_nparams(stmt);
 
 	// Get list length
 	unsigned int list_length;
-	if (!enif_get_list_length(env, argv[1], &list_length)) {
-		return enif_make_badarg(env);
+	if (!enif_get_list_length(env, params, &list_length)) {
+		*error_term = enif_make_badarg(env);
+		return false;
 	}
 
 	// Check parameter count matches
@@ -635,34 +1752,65 @@ static ERL_NIF_TERM prepared_statement_execute_nif(ErlNifEnv *env, int argc, con
 		char error_msg[256];
 		snprintf(error_msg, sizeof(error_msg), "Parameter count mismatch: expected %llu, got %u",
 		         (unsigned long long)param_count, list_length);
-		return make_error(env, error_msg);
+		*error_term = make_error(env, error_msg);
+		return false;
 	}
 
 	// Bind parameters
-	ERL_NIF_TERM list = argv[1];
+	ERL_NIF_TERM list = params;
 	ERL_NIF_TERM head, tail;
 
 	for (idx_t i = 0; i < param_count; i++) {
 		if (!enif_get_list_cell(env, list, &head, &tail)) {
-			return make_error(env, "Failed to get parameter from list");
+			*error_term = make_error(env, "Failed to get parameter from list");
+			return false;
 		}
 
-		duckdb_state bind_state = bind_parameter(stmt_res->stmt, i + 1, env, head); // DuckDB uses 1-based indexing
+		duckdb_state bind_state = bind_parameter(stmt, i + 1, env, head); // DuckDB uses 1-based indexing
 		if (bind_state == DuckDBError) {
 			char error_msg[256];
 			snprintf(error_msg, sizeof(error_msg), "Failed to bind parameter %llu", (unsigned long long)(i + 1));
-			return make_error(env, error_msg);
+			*error_term = make_error(env, error_msg);
+			return false;
 		}
 
 		list = tail;
 	}
 
-	ResultResource *res = enif_alloc_resource(result_resource_type, sizeof(ResultResource));
+	return true;
+}
+
+static ERL_NIF_TERM prepared_statement_execute_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	PreparedStatementResource *stmt_res;
+	ERL_NIF_TERM error_term;
+
+	if (argc != 2) {
+		return enif_make_badarg(env);
+	}
 
+	if (!enif_get_resource(env, argv[0], prepared_statement_resource_type, (void **)&stmt_res)) {
+		return enif_make_badarg(env);
+	}
+
+	ResultResource *res = result_resource_alloc();
+	if (!res) {
+		return make_error(env, "Failed to allocate result");
+	}
+
+	enif_mutex_lock(stmt_res->lock);
+	if (!bind_parameters(env, stmt_res->stmt, argv[1], &error_term)) {
+		enif_mutex_unlock(stmt_res->lock);
+		enif_release_resource(res);
+		return error_term;
+	}
+
+	PROBE1(query_start, (const char *)NULL);
 	duckdb_state state = duckdb_execute_prepared(stmt_res->stmt, &res->result);
+	PROBE1(query_done, state == DuckDBSuccess);
+	enif_mutex_unlock(stmt_res->lock);
 	if (state == DuckDBError) {
 		const char *error_msg = duckdb_result_error(&res->result);
-		ERL_NIF_TERM error_term = make_error(env, error_msg ? error_msg : "Failed to execute prepared statement");
+		error_term = make_error(env, error_msg ? error_msg : "Failed to execute prepared statement");
 		duckdb_destroy_result(&res->result);
 		enif_release_resource(res);
 		return error_term;
@@ -673,45 +1821,326 @@ static ERL_NIF_TERM prepared_statement_execute_nif(ErlNifEnv *env, int argc, con
 	return make_ok(env, result);
 }
 
-// Result operations
-static ERL_NIF_TERM result_columns_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-	ResultResource *res;
+// Executes a prepared statement with streaming execution, like connection_query_bounded with
+// stream: true. The result keeps the statement resource alive and reads from it chunk by chunk,
+// so the statement must not be executed again until the result is consumed or destroyed.
+static ERL_NIF_TERM prepared_statement_execute_stream_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	PreparedStatementResource *stmt_res;
+	ErlNifUInt64 prefetch_depth;
+	ERL_NIF_TERM error_term;
 
-	if (argc != 1) {
+	if (argc != 3) {
 		return enif_make_badarg(env);
 	}
 
-	if (!enif_get_resource(env, argv[0], result_resource_type, (void **)&res)) {
+	if (!enif_get_resource(env, argv[0], prepared_statement_resource_type, (void **)&stmt_res) ||
+	    !enif_get_uint64(env, argv[2], &prefetch_depth)) {
 		return enif_make_badarg(env);
 	}
 
-	idx_t column_count = duckdb_column_count(&res->result);
-	ERL_NIF_TERM *columns = enif_alloc(sizeof(ERL_NIF_TERM) * column_count);
+	ResultResource *res = result_resource_alloc();
+	if (!res) {
+		return make_error(env, "Failed to allocate result");
+	}
 
-	for (idx_t i = 0; i < column_count; i++) {
-		const char *name = duckdb_column_name(&res->result, i);
-		duckdb_type type = duckdb_column_type(&res->result, i);
+	// The statement belongs to its own resource; the result only holds a reference to it
+	enif_keep_resource(stmt_res);
+	res->stmt_owner = stmt_res;
 
-		// Create binary for column name
-		ErlNifBinary name_bin;
-		size_t name_len = strlen(name);
-		enif_alloc_binary(name_len, &name_bin);
-		memcpy(name_bin.data, name, name_len);
-		ERL_NIF_TERM name_term = enif_make_binary(env, &name_bin);
+	enif_mutex_lock(stmt_res->lock);
+	if (!bind_parameters(env, stmt_res->stmt, argv[1], &error_term)) {
+		enif_mutex_unlock(stmt_res->lock);
+		enif_release_resource(res);
+		return error_term;
+	}
+
+	PROBE1(query_start, (const char *)NULL);
+	if (duckdb_pending_prepared_streaming(stmt_res->stmt, &res->pending) == DuckDBError) {
+		enif_mutex_unlock(stmt_res->lock);
+		const char *error_msg = duckdb_pending_error(res->pending);
+		error_term = make_error(env, error_msg ? error_msg : "Failed to start query");
+		PROBE1(query_done, 0);
+		enif_release_resource(res);
+		return error_term;
+	}
+
+	bool ok = duckdb_execute_pending(res->pending, &res->result) == DuckDBSuccess;
+	enif_mutex_unlock(stmt_res->lock);
+	PROBE1(query_done, ok);
+	if (!ok) {
+		const char *error_msg = duckdb_result_error(&res->result);
+		error_term = make_error(env, error_msg ? error_msg : "Query failed");
+		enif_release_resource(res);
+		return error_term;
+	}
+
+	res->streaming = true;
+
+	if (prefetch_depth > 0 && !prefetcher_start(res, (idx_t)prefetch_depth)) {
+		enif_release_resource(res);
+		return make_error(env, "Failed to start chunk prefetching");
+	}
+
+	ERL_NIF_TERM result = enif_make_resource(env, res);
+	enif_release_resource(res);
+	return make_ok(env, result);
+}
+
+static ERL_NIF_TERM make_logical_type_term(ErlNifEnv *env, duckdb_logical_type type);
+
+// Describes what a prepared statement takes and returns without executing it:
+// %{params: [type], columns: [%{name, type, logical_type}]}. Parameter types DuckDB could
+// not infer from the statement are :unknown.
+static ERL_NIF_TERM prepared_statement_describe_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	PreparedStatementResource *stmt_res;
+
+	if (argc != 1) {
+		return enif_make_badarg(env);
+	}
+
+	if (!enif_get_resource(env, argv[0], prepared_statement_resource_type, (void **)&stmt_res)) {
+		return enif_make_badarg(env);
+	}
+
+	ERL_NIF_TERM params = enif_make_list(env, 0);
+	for (idx_t i = duckdb_nparams(stmt_res->stmt); i > 0; i--) {
+		params = enif_make_list_cell(env, duckdb_type_to_atom(duckdb_param_type(stmt_res->stmt, i)), params);
+	}
+
+	ERL_NIF_TERM columns = enif_make_list(env, 0);
+	for (idx_t i = duckdb_prepared_statement_column_count(stmt_res->stmt); i > 0; i--) {
+		const char *name = duckdb_prepared_statement_column_name(stmt_res->stmt, i - 1);
+		duckdb_logical_type type = duckdb_prepared_statement_column_logical_type(stmt_res->stmt, i - 1);
+		ERL_NIF_TERM keys[] = {atom_name, atom_type, atom_logical_type};
+		ERL_NIF_TERM values[] = {name ? make_text_term(env, name) : atom_nil,
+		                         duckdb_type_to_atom(duckdb_get_type_id(type)), make_logical_type_term(env, type)};
+		duckdb_destroy_logical_type(&type);
+		if (name) {
+			duckdb_free((void *)name);
+		}
+
+		ERL_NIF_TERM column;
+		enif_make_map_from_arrays(env, keys, values, 3, &column);
+		columns = enif_make_list_cell(env, column, columns);
+	}
+
+	ERL_NIF_TERM keys[] = {atom_params, atom_columns};
+	ERL_NIF_TERM values[] = {params, columns};
+	ERL_NIF_TERM description;
+	enif_make_map_from_arrays(env, keys, values, 2, &description);
+	return make_ok(env, description);
+}
+
+// Result operations
+static ERL_NIF_TERM result_columns_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	ResultResource *res;
+
+	if (argc != 1) {
+		return enif_make_badarg(env);
+	}
+
+	if (!enif_get_resource(env, argv[0], result_resource_type, (void **)&res)) {
+		return enif_make_badarg(env);
+	}
+
+	if (!result_acquire(res, false)) {
+		return make_error(env, result_destroyed_error);
+	}
+
+	idx_t column_count = duckdb_column_count(&res->result);
+	ERL_NIF_TERM *columns = enif_alloc(sizeof(ERL_NIF_TERM) * column_count);
+
+	for (idx_t i = 0; i < column_count; i++) {
+		const char *name = duckdb_column_name(&res->result, i);
+		duckdb_type type = duckdb_column_type(&res->result, i);
+
+		// Create binary for column name
+		ErlNifBinary name_bin;
+		size_t name_len = strlen(name);
+		enif_alloc_binary(name_len, &name_bin);
+		memcpy(name_bin.data, name, name_len);
+		ERL_NIF_TERM name_term = enif_make_binary(env, &name_bin);
 
 		ERL_NIF_TERM type_term = duckdb_type_to_atom(type);
 
-		ERL_NIF_TERM keys[] = {enif_make_atom(env, "name"), enif_make_atom(env, "type")};
+		ERL_NIF_TERM keys[] = {atom_name, atom_type};
 		ERL_NIF_TERM values[] = {name_term, type_term};
 
 		enif_make_map_from_arrays(env, keys, values, 2, &columns[i]);
 	}
 
+	result_release(res, false);
+
 	ERL_NIF_TERM result = enif_make_list_from_array(env, columns, column_count);
 	enif_free(columns);
 	return result;
 }
 
+// Named children of STRUCT and UNION types as an ordered [{name, descriptor}] list
+static ERL_NIF_TERM make_named_children_term(ErlNifEnv *env, duckdb_logical_type type, bool is_union) {
+	idx_t count = is_union ? duckdb_union_type_member_count(type) : duckdb_struct_type_child_count(type);
+	ERL_NIF_TERM list = enif_make_list(env, 0);
+
+	for (idx_t i = count; i > 0; i--) {
+		char *name = is_union ? duckdb_union_type_member_name(type, i - 1) : duckdb_struct_type_child_name(type, i - 1);
+		duckdb_logical_type child =
+		    is_union ? duckdb_union_type_member_type(type, i - 1) : duckdb_struct_type_child_type(type, i - 1);
+
+		ERL_NIF_TERM name_term = name ? make_text_term(env, name) : atom_nil;
+		ERL_NIF_TERM entry = enif_make_tuple2(env, name_term, make_logical_type_term(env, child));
+		list = enif_make_list_cell(env, entry, list);
+
+		if (name) {
+			duckdb_free(name);
+		}
+		duckdb_destroy_logical_type(&child);
+	}
+	return list;
+}
+
+// Describes a logical type as %{type: atom} plus its parameters: decimal width and scale, the
+// child of lists and arrays (and the size of arrays), struct fields, map key and value types,
+// enum values and union members. Aliased types such as JSON also carry their alias.
+static ERL_NIF_TERM make_logical_type_term(ErlNifEnv *env, duckdb_logical_type type) {
+	duckdb_type type_id = duckdb_get_type_id(type);
+	ERL_NIF_TERM keys[4];
+	ERL_NIF_TERM values[4];
+	size_t count = 0;
+
+	keys[count] = atom_type;
+	values[count++] = duckdb_type_to_atom(type_id);
+
+	switch (type_id) {
+	case DUCKDB_TYPE_DECIMAL:
+		keys[count] = atom_width;
+		values[count++] = enif_make_uint(env, duckdb_decimal_width(type));
+		keys[count] = atom_scale;
+		values[count++] = enif_make_uint(env, duckdb_decimal_scale(type));
+		break;
+	case DUCKDB_TYPE_LIST:
+	case DUCKDB_TYPE_ARRAY: {
+		bool is_array = type_id == DUCKDB_TYPE_ARRAY;
+		duckdb_logical_type child = is_array ? duckdb_array_type_child_type(type) : duckdb_list_type_child_type(type);
+		keys[count] = atom_child;
+		values[count++] = make_logical_type_term(env, child);
+		duckdb_destroy_logical_type(&child);
+		if (is_array) {
+			keys[count] = atom_size;
+			values[count++] = enif_make_uint64(env, duckdb_array_type_array_size(type));
+		}
+		break;
+	}
+	case DUCKDB_TYPE_STRUCT:
+		keys[count] = atom_fields;
+		values[count++] = make_named_children_term(env, type, false);
+		break;
+	case DUCKDB_TYPE_UNION:
+		keys[count] = atom_members;
+		values[count++] = make_named_children_term(env, type, true);
+		break;
+	case DUCKDB_TYPE_MAP: {
+		duckdb_logical_type key_type = duckdb_map_type_key_type(type);
+		duckdb_logical_type value_type = duckdb_map_type_value_type(type);
+		keys[count] = atom_key;
+		values[count++] = make_logical_type_term(env, key_type);
+		keys[count] = atom_value;
+		values[count++] = make_logical_type_term(env, value_type);
+		duckdb_destroy_logical_type(&key_type);
+		duckdb_destroy_logical_type(&value_type);
+		break;
+	}
+	case DUCKDB_TYPE_ENUM: {
+		uint32_t size = duckdb_enum_dictionary_size(type);
+		ERL_NIF_TERM list = enif_make_list(env, 0);
+		for (uint32_t i = size; i > 0; i--) {
+			char *entry = duckdb_enum_dictionary_value(type, i - 1);
+			list = enif_make_list_cell(env, entry ? make_text_term(env, entry) : atom_nil, list);
+			if (entry) {
+				duckdb_free(entry);
+			}
+		}
+		keys[count] = atom_values;
+		values[count++] = list;
+		break;
+	}
+	default:
+		break;
+	}
+
+	char *alias = duckdb_logical_type_get_alias(type);
+	if (alias) {
+		keys[count] = atom_alias;
+		values[count++] = make_text_term(env, alias);
+		duckdb_free(alias);
+	}
+
+	ERL_NIF_TERM term;
+	enif_make_map_from_arrays(env, keys, values, count, &term);
+	return term;
+}
+
+static ERL_NIF_TERM make_columns_full_term(ErlNifEnv *env, duckdb_result *result) {
+	idx_t column_count = duckdb_column_count(result);
+	ERL_NIF_TERM list = enif_make_list(env, 0);
+
+	for (idx_t i = column_count; i > 0; i--) {
+		duckdb_logical_type type = duckdb_column_logical_type(result, i - 1);
+		ERL_NIF_TERM keys[] = {atom_name, atom_type, atom_logical_type};
+		ERL_NIF_TERM values[] = {make_text_term(env, duckdb_column_name(result, i - 1)),
+		                         duckdb_type_to_atom(duckdb_get_type_id(type)), make_logical_type_term(env, type)};
+		duckdb_destroy_logical_type(&type);
+
+		ERL_NIF_TERM column;
+		enif_make_map_from_arrays(env, keys, values, 3, &column);
+		list = enif_make_list_cell(env, column, list);
+	}
+	return list;
+}
+
+static ERL_NIF_TERM result_columns_full_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	ResultResource *res;
+
+	if (argc != 1) {
+		return enif_make_badarg(env);
+	}
+
+	if (!enif_get_resource(env, argv[0], result_resource_type, (void **)&res)) {
+		return enif_make_badarg(env);
+	}
+
+	if (!result_acquire(res, false)) {
+		return make_error(env, result_destroyed_error);
+	}
+
+	if (res->columns_env) {
+		ERL_NIF_TERM columns = enif_make_copy(env, res->columns_full);
+		result_release(res, false);
+		return columns;
+	}
+
+	// First call: build the descriptors under the write lock so readers never see a partial cache
+	result_release(res, false);
+	if (!result_acquire(res, true)) {
+		return make_error(env, result_destroyed_error);
+	}
+
+	if (!res->columns_env) {
+		ErlNifEnv *columns_env = enif_alloc_env();
+		if (!columns_env) {
+			result_release(res, true);
+			return make_error(env, "Failed to allocate column descriptors");
+		}
+		res->columns_full = make_columns_full_term(columns_env, &res->result);
+		res->columns_env = columns_env;
+	}
+
+	ERL_NIF_TERM columns = enif_make_copy(env, res->columns_full);
+	result_release(res, true);
+	return columns;
+}
+
+static ERL_NIF_TERM result_rows_chunked_start(ErlNifEnv *env, ERL_NIF_TERM result_term, const DecodeOptions *opts);
+
 static ERL_NIF_TERM result_rows_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
 	ResultResource *res;
 
@@ -723,48 +2152,106 @@ static ERL_NIF_TERM result_rows_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM
 		return enif_make_badarg(env);
 	}
 
-	idx_t row_count = duckdb_row_count(&res->result);
-	idx_t column_count = duckdb_column_count(&res->result);
+	if (!result_acquire(res, false)) {
+		return make_error(env, result_destroyed_error);
+	}
 
-	// WORKAROUND: DuckDB has a memory corruption bug when extracting UUID values in multi-column contexts.
-	// Any attempt to call duckdb_value_varchar (or other extraction functions) on a result that contains
-	// UUID columns causes segfaults when processing subsequent columns. Until this is fixed in DuckDB,
-	// we need to be very careful with UUID extraction.
-	// The chunked API works correctly, so this issue is specific to the regular result API.
+	// Buffered and streaming results only exist as chunks, so the value API cannot read them.
+	// UUIDs cannot be read reliably through duckdb_value_* either, so results containing one
+	// are decoded from their chunks as well.
+	idx_t column_count = duckdb_column_count(&res->result);
 	bool has_uuid = false;
-	for (idx_t c = 0; c < column_count; c++) {
-		duckdb_type type = duckdb_column_type(&res->result, c);
-		if (type == DUCKDB_TYPE_UUID) {
-			has_uuid = true;
-			break;
-		}
+	for (idx_t c = 0; c < column_count && !has_uuid; c++) {
+		has_uuid = duckdb_column_type(&res->result, c) == DUCKDB_TYPE_UUID;
 	}
 
+	if (res->buffered || res->streaming || has_uuid) {
+		DecodeOptions opts = {0};
+		result_release(res, false);
+		return result_rows_chunked_start(env, argv[0], &opts);
+	}
+
+	idx_t row_count = duckdb_row_count(&res->result);
+
 	ERL_NIF_TERM *rows = enif_alloc(sizeof(ERL_NIF_TERM) * row_count);
 
 	for (idx_t r = 0; r < row_count; r++) {
 		ERL_NIF_TERM *row_values = enif_alloc(sizeof(ERL_NIF_TERM) * column_count);
 
-		if (has_uuid && column_count > 1) {
-			// If any column is UUID in multi-column context, set all columns to nil to avoid DuckDB corruption bug
-			for (idx_t c = 0; c < column_count; c++) {
+		for (idx_t c = 0; c < column_count; c++) {
+			duckdb_type type = duckdb_column_type(&res->result, c);
+
+			// Check for NULL first for all types
+			bool is_null = duckdb_value_is_null(&res->result, c, r);
+
+			if (is_null) {
 				row_values[c] = atom_nil;
+				continue;
 			}
-		} else {
-			// Normal processing for non-UUID results or single-column UUID
-			for (idx_t c = 0; c < column_count; c++) {
-				duckdb_type type = duckdb_column_type(&res->result, c);
 
-				// Check for NULL first for all types
-				bool is_null = duckdb_value_is_null(&res->result, c, r);
-
-				if (is_null) {
+			// For all other types, try the appropriate extraction method
+
+			switch (type) {
+			case DUCKDB_TYPE_BOOLEAN:
+				row_values[c] = duckdb_value_boolean(&res->result, c, r) ? enif_make_atom(env, "true")
+				                                                         : enif_make_atom(env, "false");
+				break;
+			case DUCKDB_TYPE_TINYINT:
+				row_values[c] = enif_make_int(env, duckdb_value_int8(&res->result, c, r));
+				break;
+			case DUCKDB_TYPE_SMALLINT:
+				row_values[c] = enif_make_int(env, duckdb_value_int16(&res->result, c, r));
+				break;
+			case DUCKDB_TYPE_INTEGER:
+				row_values[c] = enif_make_int(env, duckdb_value_int32(&res->result, c, r));
+				break;
+			case DUCKDB_TYPE_BIGINT:
+				row_values[c] = enif_make_long(env, duckdb_value_int64(&res->result, c, r));
+				break;
+			case DUCKDB_TYPE_UTINYINT:
+				row_values[c] = enif_make_uint(env, duckdb_value_uint8(&res->result, c, r));
+				break;
+			case DUCKDB_TYPE_USMALLINT:
+				row_values[c] = enif_make_uint(env, duckdb_value_uint16(&res->result, c, r));
+				break;
+			case DUCKDB_TYPE_UINTEGER:
+				row_values[c] = enif_make_uint(env, duckdb_value_uint32(&res->result, c, r));
+				break;
+			case DUCKDB_TYPE_UBIGINT:
+				row_values[c] = enif_make_uint64(env, duckdb_value_uint64(&res->result, c, r));
+				break;
+			case DUCKDB_TYPE_DECIMAL: {
+				// Parse DuckDB's exact decimal text rather than going through its double cast
+				char *str = duckdb_value_varchar(&res->result, c, r);
+				if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
+					row_values[c] = enif_make_double(env, strtod(str, NULL));
+					duckdb_free(str);
+				} else {
 					row_values[c] = atom_nil;
-					continue;
+					if (str)
+						duckdb_free(str);
 				}
-
-				// Handle UUID specially - only in single column context
-				if (type == DUCKDB_TYPE_UUID) {
+				break;
+			}
+			case DUCKDB_TYPE_TIMESTAMP: {
+				duckdb_timestamp timestamp = duckdb_value_timestamp(&res->result, c, r);
+				if (!duckdb_is_finite_timestamp(timestamp)) {
+					row_values[c] = make_infinity_term(env, timestamp.micros > 0);
+				} else {
+					// Same precision as DuckDB's text form, e.g. 14:30:45 or 14:30:45.123
+					duckdb_timestamp_struct ts_struct = duckdb_from_timestamp(timestamp);
+					row_values[c] = make_datetime_term(env, ts_struct, micros_precision(ts_struct.time.micros));
+				}
+				break;
+			}
+			case DUCKDB_TYPE_TIMESTAMP_S:
+			case DUCKDB_TYPE_TIMESTAMP_MS:
+			case DUCKDB_TYPE_TIMESTAMP_NS:
+			case DUCKDB_TYPE_TIMESTAMP_TZ: {
+				// Extract all timestamp types as varchar for consistency
+				if (duckdb_value_is_null(&res->result, c, r)) {
+					row_values[c] = atom_nil;
+				} else {
 					char *str = duckdb_value_varchar(&res->result, c, r);
 					if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
 						ErlNifBinary bin;
@@ -774,202 +2261,168 @@ static ERL_NIF_TERM result_rows_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM
 						row_values[c] = enif_make_binary(env, &bin);
 						duckdb_free(str);
 					} else {
-						row_values[c] = atom_nil;
-						if (str)
-							duckdb_free(str);
-					}
-					continue;
-				}
-
-				// For all other types, try the appropriate extraction method
-
-				switch (type) {
-				case DUCKDB_TYPE_BOOLEAN:
-					row_values[c] = duckdb_value_boolean(&res->result, c, r) ? enif_make_atom(env, "true")
-					                                                         : enif_make_atom(env, "false");
-					break;
-				case DUCKDB_TYPE_TINYINT:
-					row_values[c] = enif_make_int(env, duckdb_value_int8(&res->result, c, r));
-					break;
-				case DUCKDB_TYPE_SMALLINT:
-					row_values[c] = enif_make_int(env, duckdb_value_int16(&res->result, c, r));
-					break;
-				case DUCKDB_TYPE_INTEGER:
-					row_values[c] = enif_make_int(env, duckdb_value_int32(&res->result, c, r));
-					break;
-				case DUCKDB_TYPE_BIGINT:
-					row_values[c] = enif_make_long(env, duckdb_value_int64(&res->result, c, r));
-					break;
-				case DUCKDB_TYPE_UTINYINT:
-					row_values[c] = enif_make_uint(env, duckdb_value_uint8(&res->result, c, r));
-					break;
-				case DUCKDB_TYPE_USMALLINT:
-					row_values[c] = enif_make_uint(env, duckdb_value_uint16(&res->result, c, r));
-					break;
-				case DUCKDB_TYPE_UINTEGER:
-					row_values[c] = enif_make_uint(env, duckdb_value_uint32(&res->result, c, r));
-					break;
-				case DUCKDB_TYPE_UBIGINT:
-					row_values[c] = enif_make_uint64(env, duckdb_value_uint64(&res->result, c, r));
-					break;
-				case DUCKDB_TYPE_DECIMAL: {
-					// Extract DECIMAL as varchar for precision
-					char *str = duckdb_value_varchar(&res->result, c, r);
-					if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
+						// Varchar extraction failed for non-NULL timestamp, return placeholder
+						char buffer[64];
+						snprintf(buffer, sizeof(buffer), "<timestamp_extraction_failed>");
 						ErlNifBinary bin;
-						size_t len = strlen(str);
+						size_t len = strlen(buffer);
 						enif_alloc_binary(len, &bin);
-						memcpy(bin.data, str, len);
+						memcpy(bin.data, buffer, len);
 						row_values[c] = enif_make_binary(env, &bin);
-						duckdb_free(str);
-					} else {
-						row_values[c] = atom_nil;
 						if (str)
 							duckdb_free(str);
 					}
-					break;
-				}
-				case DUCKDB_TYPE_TIMESTAMP:
-				case DUCKDB_TYPE_TIMESTAMP_S:
-				case DUCKDB_TYPE_TIMESTAMP_MS:
-				case DUCKDB_TYPE_TIMESTAMP_NS:
-				case DUCKDB_TYPE_TIMESTAMP_TZ: {
-					// Extract all timestamp types as varchar for consistency
-					if (duckdb_value_is_null(&res->result, c, r)) {
-						row_values[c] = atom_nil;
-					} else {
-						char *str = duckdb_value_varchar(&res->result, c, r);
-						if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
-							ErlNifBinary bin;
-							size_t len = strlen(str);
-							enif_alloc_binary(len, &bin);
-							memcpy(bin.data, str, len);
-							row_values[c] = enif_make_binary(env, &bin);
-							duckdb_free(str);
-						} else {
-							// Varchar extraction failed for non-NULL timestamp, return placeholder
-							char buffer[64];
-							snprintf(buffer, sizeof(buffer), "<timestamp_extraction_failed>");
-							ErlNifBinary bin;
-							size_t len = strlen(buffer);
-							enif_alloc_binary(len, &bin);
-							memcpy(bin.data, buffer, len);
-							row_values[c] = enif_make_binary(env, &bin);
-							if (str)
-								duckdb_free(str);
-						}
-					}
-					break;
-				}
-				case DUCKDB_TYPE_HUGEINT: {
-					// Use varchar extraction to preserve full precision
-					row_values[c] = hugeint_to_elixir_integer_via_varchar(env, &res->result, c, r);
-					break;
 				}
-				case DUCKDB_TYPE_FLOAT: {
-					float val = duckdb_value_float(&res->result, c, r);
-					// Handle special float values (infinity, NaN)
-					if (isnan(val)) {
-						row_values[c] = enif_make_atom(env, "nan");
-					} else if (isinf(val)) {
-						if (val > 0) {
-							row_values[c] = enif_make_atom(env, "infinity");
-						} else {
-							row_values[c] = enif_make_atom(env, "negative_infinity");
-						}
-					} else {
-						row_values[c] = enif_make_double(env, (double)val);
-					}
-					break;
+				break;
+			}
+			case DUCKDB_TYPE_HUGEINT: {
+				duckdb_hugeint value = duckdb_value_hugeint(&res->result, c, r);
+				row_values[c] = make_int128_term(env, (uint64_t)value.upper, value.lower, true);
+				break;
+			}
+			case DUCKDB_TYPE_FLOAT: {
+				float val = duckdb_value_float(&res->result, c, r);
+				row_values[c] = make_float_term(env, val, false);
+				break;
+			}
+			case DUCKDB_TYPE_DOUBLE: {
+				double val = duckdb_value_double(&res->result, c, r);
+				row_values[c] = make_float_term(env, val, false);
+				break;
+			}
+			case DUCKDB_TYPE_DATE: {
+				duckdb_date date_val = duckdb_value_date(&res->result, c, r);
+				if (!duckdb_is_finite_date(date_val)) {
+					row_values[c] = make_infinity_term(env, date_val.days > 0);
+				} else {
+					row_values[c] = make_date_term(env, duckdb_from_date(date_val));
 				}
-				case DUCKDB_TYPE_DOUBLE: {
-					double val = duckdb_value_double(&res->result, c, r);
-					// Handle special double values (infinity, NaN)
-					if (isnan(val)) {
-						row_values[c] = enif_make_atom(env, "nan");
-					} else if (isinf(val)) {
-						if (val > 0) {
-							row_values[c] = enif_make_atom(env, "infinity");
-						} else {
-							row_values[c] = enif_make_atom(env, "negative_infinity");
-						}
-					} else {
-						row_values[c] = enif_make_double(env, val);
+				break;
+			}
+			case DUCKDB_TYPE_TIME: {
+				duckdb_time time_val = duckdb_value_time(&res->result, c, r);
+				row_values[c] = make_time_term(env, duckdb_from_time(time_val), 6);
+				break;
+			}
+
+			case DUCKDB_TYPE_INTERVAL: {
+				// Same {months, days, micros} shape as the chunked decoder
+				duckdb_interval interval_val = duckdb_value_interval(&res->result, c, r);
+				row_values[c] = enif_make_tuple3(env, enif_make_int(env, interval_val.months),
+				                                 enif_make_int(env, interval_val.days),
+				                                 enif_make_int64(env, interval_val.micros));
+				break;
+			}
+			case DUCKDB_TYPE_BLOB: {
+				duckdb_blob blob_val = duckdb_value_blob(&res->result, c, r);
+				if (blob_val.data && blob_val.size > 0) {
+					ErlNifBinary bin;
+					enif_alloc_binary(blob_val.size, &bin);
+					memcpy(bin.data, blob_val.data, blob_val.size);
+					row_values[c] = enif_make_binary(env, &bin);
+					duckdb_free(blob_val.data);
+				} else {
+					// Empty blob
+					ErlNifBinary bin;
+					enif_alloc_binary(0, &bin);
+					row_values[c] = enif_make_binary(env, &bin);
+					if (blob_val.data) {
+						duckdb_free(blob_val.data);
 					}
-					break;
 				}
-				case DUCKDB_TYPE_DATE: {
-					duckdb_date date_val = duckdb_value_date(&res->result, c, r);
-					duckdb_date_struct date_struct = duckdb_from_date(date_val);
-
-					char buffer[32];
-					snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", date_struct.year, date_struct.month,
-					         date_struct.day);
-					// Return as binary instead of charlist
+				break;
+			}
+			case DUCKDB_TYPE_VARCHAR: {
+				char *str = duckdb_value_varchar(&res->result, c, r);
+				if (str) {
 					ErlNifBinary bin;
-					size_t len = strlen(buffer);
+					size_t len = strlen(str);
 					enif_alloc_binary(len, &bin);
-					memcpy(bin.data, buffer, len);
+					memcpy(bin.data, str, len);
 					row_values[c] = enif_make_binary(env, &bin);
-					break;
+					duckdb_free(str);
+				} else {
+					row_values[c] = atom_nil;
 				}
-				case DUCKDB_TYPE_TIME: {
-					duckdb_time time_val = duckdb_value_time(&res->result, c, r);
-					duckdb_time_struct time_struct = duckdb_from_time(time_val);
-
-					char buffer[32];
-					snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d.%06d", time_struct.hour, time_struct.min,
-					         time_struct.sec, time_struct.micros);
-					// Return as binary instead of charlist
+				break;
+			}
+
+			case DUCKDB_TYPE_TIME_TZ: {
+				// Time with timezone - use varchar for string representation
+				char *str = duckdb_value_varchar(&res->result, c, r);
+				if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
 					ErlNifBinary bin;
-					size_t len = strlen(buffer);
+					size_t len = strlen(str);
 					enif_alloc_binary(len, &bin);
-					memcpy(bin.data, buffer, len);
+					memcpy(bin.data, str, len);
 					row_values[c] = enif_make_binary(env, &bin);
-					break;
+					duckdb_free(str);
+				} else {
+					row_values[c] = atom_nil;
+					if (str)
+						duckdb_free(str);
 				}
-
-				case DUCKDB_TYPE_INTERVAL: {
-					duckdb_interval interval_val = duckdb_value_interval(&res->result, c, r);
-
-					char buffer[128];
-					if (interval_val.months != 0) {
-						snprintf(buffer, sizeof(buffer), "%d months %d days %lld microseconds", interval_val.months,
-						         interval_val.days, (long long)interval_val.micros);
-					} else if (interval_val.days != 0) {
-						snprintf(buffer, sizeof(buffer), "%d days %lld microseconds", interval_val.days,
-						         (long long)interval_val.micros);
-					} else {
-						snprintf(buffer, sizeof(buffer), "%lld microseconds", (long long)interval_val.micros);
-					}
+				break;
+			}
+			case DUCKDB_TYPE_BIT: {
+				// Bit string - use varchar for string representation
+				char *str = duckdb_value_varchar(&res->result, c, r);
+				if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
 					ErlNifBinary bin;
-					enif_alloc_binary(strlen(buffer), &bin);
-					memcpy(bin.data, buffer, strlen(buffer));
+					size_t len = strlen(str);
+					enif_alloc_binary(len, &bin);
+					memcpy(bin.data, str, len);
 					row_values[c] = enif_make_binary(env, &bin);
-					break;
+					duckdb_free(str);
+				} else {
+					row_values[c] = atom_nil;
+					if (str)
+						duckdb_free(str);
 				}
-				case DUCKDB_TYPE_BLOB: {
-					duckdb_blob blob_val = duckdb_value_blob(&res->result, c, r);
-					if (blob_val.data && blob_val.size > 0) {
-						ErlNifBinary bin;
-						enif_alloc_binary(blob_val.size, &bin);
-						memcpy(bin.data, blob_val.data, blob_val.size);
-						row_values[c] = enif_make_binary(env, &bin);
-						duckdb_free(blob_val.data);
+				break;
+			}
+			case DUCKDB_TYPE_UHUGEINT: {
+				duckdb_uhugeint value = duckdb_value_uhugeint(&res->result, c, r);
+				row_values[c] = make_int128_term(env, value.upper, value.lower, false);
+				break;
+			}
+			case DUCKDB_TYPE_ENUM: {
+				// For ENUMs, duckdb_value_varchar() may not work reliably
+				char *str = duckdb_value_varchar(&res->result, c, r);
+				if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
+					ErlNifBinary bin;
+					size_t len = strlen(str);
+					enif_alloc_binary(len, &bin);
+					memcpy(bin.data, str, len);
+					row_values[c] = enif_make_binary(env, &bin);
+					duckdb_free(str);
+				} else {
+					if (str)
+						duckdb_free(str);
+
+					if (duckdb_value_is_null(&res->result, c, r)) {
+						row_values[c] = atom_nil;
 					} else {
-						// Empty blob
+						// ENUM extraction failed with regular API, return placeholder
+						char buffer[64];
+						snprintf(buffer, sizeof(buffer), "<regular_api_enum_limitation>");
 						ErlNifBinary bin;
-						enif_alloc_binary(0, &bin);
+						size_t len = strlen(buffer);
+						enif_alloc_binary(len, &bin);
+						memcpy(bin.data, buffer, len);
 						row_values[c] = enif_make_binary(env, &bin);
-						if (blob_val.data) {
-							duckdb_free(blob_val.data);
-						}
 					}
-					break;
 				}
-				case DUCKDB_TYPE_VARCHAR: {
+				break;
+			}
+			case DUCKDB_TYPE_LIST: {
+				// For LIST types, first check if it's truly NULL using duckdb_value_is_null
+				if (duckdb_value_is_null(&res->result, c, r)) {
+					row_values[c] = atom_nil;
+				} else {
+					// Not NULL, try varchar representation
 					char *str = duckdb_value_varchar(&res->result, c, r);
-					if (str) {
+					if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
 						ErlNifBinary bin;
 						size_t len = strlen(str);
 						enif_alloc_binary(len, &bin);
@@ -977,13 +2430,26 @@ static ERL_NIF_TERM result_rows_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM
 						row_values[c] = enif_make_binary(env, &bin);
 						duckdb_free(str);
 					} else {
-						row_values[c] = atom_nil;
+						// Varchar extraction failed for non-NULL list, return placeholder
+						char buffer[64];
+						snprintf(buffer, sizeof(buffer), "<unsupported_list_type>");
+						ErlNifBinary bin;
+						size_t len = strlen(buffer);
+						enif_alloc_binary(len, &bin);
+						memcpy(bin.data, buffer, len);
+						row_values[c] = enif_make_binary(env, &bin);
+						if (str)
+							duckdb_free(str);
 					}
-					break;
 				}
-
-				case DUCKDB_TYPE_TIME_TZ: {
-					// Time with timezone - use varchar for string representation
+				break;
+			}
+			case DUCKDB_TYPE_STRUCT: {
+				// For STRUCT types, first check if it's truly NULL using duckdb_value_is_null
+				if (duckdb_value_is_null(&res->result, c, r)) {
+					row_values[c] = atom_nil;
+				} else {
+					// Not NULL, try varchar representation
 					char *str = duckdb_value_varchar(&res->result, c, r);
 					if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
 						ErlNifBinary bin;
@@ -993,48 +2459,26 @@ static ERL_NIF_TERM result_rows_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM
 						row_values[c] = enif_make_binary(env, &bin);
 						duckdb_free(str);
 					} else {
-						row_values[c] = atom_nil;
-						if (str)
-							duckdb_free(str);
-					}
-					break;
-				}
-				case DUCKDB_TYPE_BIT: {
-					// Bit string - use varchar for string representation
-					char *str = duckdb_value_varchar(&res->result, c, r);
-					if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
-						ErlNifBinary bin;
-						size_t len = strlen(str);
-						enif_alloc_binary(len, &bin);
-						memcpy(bin.data, str, len);
-						row_values[c] = enif_make_binary(env, &bin);
-						duckdb_free(str);
-					} else {
-						row_values[c] = atom_nil;
-						if (str)
-							duckdb_free(str);
-					}
-					break;
-				}
-				case DUCKDB_TYPE_UHUGEINT: {
-					// Unsigned huge integer - use varchar for string representation
-					char *str = duckdb_value_varchar(&res->result, c, r);
-					if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
+						// Varchar extraction failed for non-NULL struct, return placeholder
+						char buffer[64];
+						snprintf(buffer, sizeof(buffer), "<unsupported_struct_type>");
 						ErlNifBinary bin;
-						size_t len = strlen(str);
+						size_t len = strlen(buffer);
 						enif_alloc_binary(len, &bin);
-						memcpy(bin.data, str, len);
+						memcpy(bin.data, buffer, len);
 						row_values[c] = enif_make_binary(env, &bin);
-						duckdb_free(str);
-					} else {
-						row_values[c] = atom_nil;
 						if (str)
 							duckdb_free(str);
 					}
-					break;
 				}
-				case DUCKDB_TYPE_ENUM: {
-					// For ENUMs, duckdb_value_varchar() may not work reliably
+				break;
+			}
+			case DUCKDB_TYPE_MAP: {
+				// For MAP types, first check if it's truly NULL using duckdb_value_is_null
+				if (duckdb_value_is_null(&res->result, c, r)) {
+					row_values[c] = atom_nil;
+				} else {
+					// Not NULL, try varchar representation
 					char *str = duckdb_value_varchar(&res->result, c, r);
 					if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
 						ErlNifBinary bin;
@@ -1044,160 +2488,26 @@ static ERL_NIF_TERM result_rows_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM
 						row_values[c] = enif_make_binary(env, &bin);
 						duckdb_free(str);
 					} else {
-						if (str)
-							duckdb_free(str);
-
-						if (duckdb_value_is_null(&res->result, c, r)) {
-							row_values[c] = atom_nil;
-						} else {
-							// ENUM extraction failed with regular API, return placeholder
-							char buffer[64];
-							snprintf(buffer, sizeof(buffer), "<regular_api_enum_limitation>");
-							ErlNifBinary bin;
-							size_t len = strlen(buffer);
-							enif_alloc_binary(len, &bin);
-							memcpy(bin.data, buffer, len);
-							row_values[c] = enif_make_binary(env, &bin);
-						}
-					}
-					break;
-				}
-				case DUCKDB_TYPE_UUID: {
-					// For UUIDs, duckdb_value_varchar() doesn't work reliably
-					// Use a special placeholder that the TypeConverter will handle
-					if (duckdb_value_is_null(&res->result, c, r)) {
-						row_values[c] = atom_nil;
-					} else {
-						// Not null, but we can't extract the value reliably with regular API
-						// Return a special placeholder for TypeConverter to handle
+						// Varchar extraction failed for non-NULL map, return placeholder
 						char buffer[64];
-						snprintf(buffer, sizeof(buffer), "<regular_api_uuid_limitation>");
+						snprintf(buffer, sizeof(buffer), "<unsupported_map_type>");
 						ErlNifBinary bin;
 						size_t len = strlen(buffer);
 						enif_alloc_binary(len, &bin);
 						memcpy(bin.data, buffer, len);
 						row_values[c] = enif_make_binary(env, &bin);
-					}
-					break;
-				}
-				case DUCKDB_TYPE_LIST: {
-					// For LIST types, first check if it's truly NULL using duckdb_value_is_null
-					if (duckdb_value_is_null(&res->result, c, r)) {
-						row_values[c] = atom_nil;
-					} else {
-						// Not NULL, try varchar representation
-						char *str = duckdb_value_varchar(&res->result, c, r);
-						if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
-							ErlNifBinary bin;
-							size_t len = strlen(str);
-							enif_alloc_binary(len, &bin);
-							memcpy(bin.data, str, len);
-							row_values[c] = enif_make_binary(env, &bin);
-							duckdb_free(str);
-						} else {
-							// Varchar extraction failed for non-NULL list, return placeholder
-							char buffer[64];
-							snprintf(buffer, sizeof(buffer), "<unsupported_list_type>");
-							ErlNifBinary bin;
-							size_t len = strlen(buffer);
-							enif_alloc_binary(len, &bin);
-							memcpy(bin.data, buffer, len);
-							row_values[c] = enif_make_binary(env, &bin);
-							if (str)
-								duckdb_free(str);
-						}
-					}
-					break;
-				}
-				case DUCKDB_TYPE_STRUCT: {
-					// For STRUCT types, first check if it's truly NULL using duckdb_value_is_null
-					if (duckdb_value_is_null(&res->result, c, r)) {
-						row_values[c] = atom_nil;
-					} else {
-						// Not NULL, try varchar representation
-						char *str = duckdb_value_varchar(&res->result, c, r);
-						if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
-							ErlNifBinary bin;
-							size_t len = strlen(str);
-							enif_alloc_binary(len, &bin);
-							memcpy(bin.data, str, len);
-							row_values[c] = enif_make_binary(env, &bin);
-							duckdb_free(str);
-						} else {
-							// Varchar extraction failed for non-NULL struct, return placeholder
-							char buffer[64];
-							snprintf(buffer, sizeof(buffer), "<unsupported_struct_type>");
-							ErlNifBinary bin;
-							size_t len = strlen(buffer);
-							enif_alloc_binary(len, &bin);
-							memcpy(bin.data, buffer, len);
-							row_values[c] = enif_make_binary(env, &bin);
-							if (str)
-								duckdb_free(str);
-						}
-					}
-					break;
-				}
-				case DUCKDB_TYPE_MAP: {
-					// For MAP types, first check if it's truly NULL using duckdb_value_is_null
-					if (duckdb_value_is_null(&res->result, c, r)) {
-						row_values[c] = atom_nil;
-					} else {
-						// Not NULL, try varchar representation
-						char *str = duckdb_value_varchar(&res->result, c, r);
-						if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
-							ErlNifBinary bin;
-							size_t len = strlen(str);
-							enif_alloc_binary(len, &bin);
-							memcpy(bin.data, str, len);
-							row_values[c] = enif_make_binary(env, &bin);
-							duckdb_free(str);
-						} else {
-							// Varchar extraction failed for non-NULL map, return placeholder
-							char buffer[64];
-							snprintf(buffer, sizeof(buffer), "<unsupported_map_type>");
-							ErlNifBinary bin;
-							size_t len = strlen(buffer);
-							enif_alloc_binary(len, &bin);
-							memcpy(bin.data, buffer, len);
-							row_values[c] = enif_make_binary(env, &bin);
-							if (str)
-								duckdb_free(str);
-						}
-					}
-					break;
-				}
-				case DUCKDB_TYPE_ARRAY: {
-					// For ARRAY types, first check if it's truly NULL using duckdb_value_is_null
-					if (duckdb_value_is_null(&res->result, c, r)) {
-						row_values[c] = atom_nil;
-					} else {
-						// Not NULL, try varchar representation
-						char *str = duckdb_value_varchar(&res->result, c, r);
-						if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
-							ErlNifBinary bin;
-							size_t len = strlen(str);
-							enif_alloc_binary(len, &bin);
-							memcpy(bin.data, str, len);
-							row_values[c] = enif_make_binary(env, &bin);
+						if (str)
 							duckdb_free(str);
-						} else {
-							// Varchar extraction failed for non-NULL array, return placeholder
-							char buffer[64];
-							snprintf(buffer, sizeof(buffer), "<unsupported_array_type>");
-							ErlNifBinary bin;
-							size_t len = strlen(buffer);
-							enif_alloc_binary(len, &bin);
-							memcpy(bin.data, buffer, len);
-							row_values[c] = enif_make_binary(env, &bin);
-							if (str)
-								duckdb_free(str);
-						}
 					}
-					break;
 				}
-				case DUCKDB_TYPE_UNION: {
-					// For UNION types, get varchar representation
+				break;
+			}
+			case DUCKDB_TYPE_ARRAY: {
+				// For ARRAY types, first check if it's truly NULL using duckdb_value_is_null
+				if (duckdb_value_is_null(&res->result, c, r)) {
+					row_values[c] = atom_nil;
+				} else {
+					// Not NULL, try varchar representation
 					char *str = duckdb_value_varchar(&res->result, c, r);
 					if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
 						ErlNifBinary bin;
@@ -1207,30 +2517,54 @@ static ERL_NIF_TERM result_rows_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM
 						row_values[c] = enif_make_binary(env, &bin);
 						duckdb_free(str);
 					} else {
-						row_values[c] = atom_nil;
-						if (str)
-							duckdb_free(str);
-					}
-					break;
-				}
-				default: {
-					// For unsupported types, try varchar extraction and fallback to nil
-					char *str = duckdb_value_varchar(&res->result, c, r);
-					if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
+						// Varchar extraction failed for non-NULL array, return placeholder
+						char buffer[64];
+						snprintf(buffer, sizeof(buffer), "<unsupported_array_type>");
 						ErlNifBinary bin;
-						size_t len = strlen(str);
+						size_t len = strlen(buffer);
 						enif_alloc_binary(len, &bin);
-						memcpy(bin.data, str, len);
+						memcpy(bin.data, buffer, len);
 						row_values[c] = enif_make_binary(env, &bin);
-						duckdb_free(str);
-					} else {
-						row_values[c] = atom_nil;
 						if (str)
 							duckdb_free(str);
 					}
-					break;
 				}
+				break;
+			}
+			case DUCKDB_TYPE_UNION: {
+				// For UNION types, get varchar representation
+				char *str = duckdb_value_varchar(&res->result, c, r);
+				if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
+					ErlNifBinary bin;
+					size_t len = strlen(str);
+					enif_alloc_binary(len, &bin);
+					memcpy(bin.data, str, len);
+					row_values[c] = enif_make_binary(env, &bin);
+					duckdb_free(str);
+				} else {
+					row_values[c] = atom_nil;
+					if (str)
+						duckdb_free(str);
+				}
+				break;
+			}
+			default: {
+				// For unsupported types, try varchar extraction and fallback to nil
+				char *str = duckdb_value_varchar(&res->result, c, r);
+				if (str != NULL && strlen(str) > 0 && strcmp(str, "NULL") != 0) {
+					ErlNifBinary bin;
+					size_t len = strlen(str);
+					enif_alloc_binary(len, &bin);
+					memcpy(bin.data, str, len);
+					row_values[c] = enif_make_binary(env, &bin);
+					duckdb_free(str);
+				} else {
+					row_values[c] = atom_nil;
+					if (str)
+						duckdb_free(str);
 				}
+				break;
+			}
 			}
 		}
 
@@ -1238,6 +2572,8 @@ static ERL_NIF_TERM result_rows_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM
 		enif_free(row_values);
 	}
 
+	result_release(res, false);
+
 	ERL_NIF_TERM result = enif_make_list_from_array(env, rows, row_count);
 	enif_free(rows);
 	return result;
@@ -1254,7 +2590,13 @@ static ERL_NIF_TERM result_row_count_nif(ErlNifEnv *env, int argc, const ERL_NIF
 		return enif_make_badarg(env);
 	}
 
-	idx_t count = duckdb_row_count(&res->result);
+	if (!result_acquire(res, false)) {
+		return make_error(env, result_destroyed_error);
+	}
+
+	// Streaming results report the rows buffered so far; DuckDB does not know the total upfront
+	idx_t count = res->buffered || res->streaming ? res->buffered_rows : duckdb_row_count(&res->result);
+	result_release(res, false);
 	return enif_make_uint64(env, count);
 }
 
@@ -1269,7 +2611,12 @@ static ERL_NIF_TERM result_column_count_nif(ErlNifEnv *env, int argc, const ERL_
 		return enif_make_badarg(env);
 	}
 
+	if (!result_acquire(res, false)) {
+		return make_error(env, result_destroyed_error);
+	}
+
 	idx_t count = duckdb_column_count(&res->result);
+	result_release(res, false);
 	return enif_make_uint64(env, count);
 }
 
@@ -1285,7 +2632,18 @@ static ERL_NIF_TERM result_chunk_count_nif(ErlNifEnv *env, int argc, const ERL_N
 		return enif_make_badarg(env);
 	}
 
-	idx_t chunk_count = duckdb_result_chunk_count(res->result);
+	if (!result_acquire(res, false)) {
+		return make_error(env, result_destroyed_error);
+	}
+
+	// Streaming results have no random chunk access; they are read with result_fetch_chunk
+	idx_t chunk_count = 0;
+	if (res->buffered) {
+		chunk_count = res->chunk_total;
+	} else if (!res->streaming) {
+		chunk_count = duckdb_result_chunk_count(res->result);
+	}
+	result_release(res, false);
 	return enif_make_uint64(env, chunk_count);
 }
 
@@ -1305,7 +2663,23 @@ static ERL_NIF_TERM result_get_chunk_nif(ErlNifEnv *env, int argc, const ERL_NIF
 		return enif_make_badarg(env);
 	}
 
-	duckdb_data_chunk chunk = duckdb_result_get_chunk(res->result, (idx_t)chunk_index);
+	if (!result_acquire(res, false)) {
+		return make_error(env, result_destroyed_error);
+	}
+
+	if (res->streaming) {
+		result_release(res, false);
+		return make_error(env, "Streaming results do not support random chunk access");
+	}
+
+	duckdb_data_chunk chunk = NULL;
+	if (res->buffered) {
+		chunk = (idx_t)chunk_index < res->chunk_total ? res->chunks[chunk_index] : NULL;
+	} else {
+		chunk = duckdb_result_get_chunk(res->result, (idx_t)chunk_index);
+	}
+	result_release(res, false);
+
 	if (!chunk) {
 		return make_error(env, "Invalid chunk index or no chunk available");
 	}
@@ -1313,6 +2687,9 @@ static ERL_NIF_TERM result_get_chunk_nif(ErlNifEnv *env, int argc, const ERL_NIF
 	// Create data chunk resource
 	DataChunkResource *chunk_res = enif_alloc_resource(data_chunk_resource_type, sizeof(DataChunkResource));
 	chunk_res->chunk = chunk;
+	chunk_res->owner = res;
+	chunk_res->borrowed = res->buffered;
+	enif_keep_resource(res);
 
 	ERL_NIF_TERM chunk_term = enif_make_resource(env, chunk_res);
 	enif_release_resource(chunk_res);
@@ -1321,138 +2698,815 @@ static ERL_NIF_TERM result_get_chunk_nif(ErlNifEnv *env, int argc, const ERL_NIF
 }
 
 // Helper function to extract value from vector based on type and position
-static ERL_NIF_TERM extract_vector_value(ErlNifEnv *env, duckdb_vector vector, duckdb_logical_type logical_type,
-                                         idx_t row_idx) {
-	duckdb_type type_id = duckdb_get_type_id(logical_type);
-	void *data = duckdb_vector_get_data(vector);
-	uint64_t *validity = duckdb_vector_get_validity(vector);
+static const char hex_digits[] = "0123456789abcdef";
 
-	// For complex types like STRUCT, LIST, MAP, the data pointer might be NULL
-	// because they store data differently. Only check data for primitive types.
-	bool is_complex_type = (type_id == DUCKDB_TYPE_STRUCT || type_id == DUCKDB_TYPE_LIST ||
-	                        type_id == DUCKDB_TYPE_ARRAY || type_id == DUCKDB_TYPE_MAP);
+// DuckDB stores a UUID as a hugeint with the top bit flipped so that it sorts correctly;
+// flipping it back gives the 16 bytes in canonical (RFC 4122, Ecto.UUID dump) order.
+static ERL_NIF_TERM make_uuid_term(ErlNifEnv *env, duckdb_hugeint value, const DecodeOptions *opts) {
+	uint8_t bytes[16];
+	uint64_t upper = (uint64_t)value.upper ^ (((uint64_t)1) << 63);
+	uint64_t lower = value.lower;
+	for (int i = 0; i < 8; i++) {
+		bytes[i] = (uint8_t)(upper >> (56 - 8 * i));
+		bytes[8 + i] = (uint8_t)(lower >> (56 - 8 * i));
+	}
 
-	// Check if data is NULL (only for non-complex types)
-	if (!is_complex_type && !data) {
-		return atom_nil;
+	ErlNifBinary bin;
+	if (opts->uuid_raw) {
+		enif_alloc_binary(16, &bin);
+		memcpy(bin.data, bytes, 16);
+		return enif_make_binary(env, &bin);
 	}
 
-	// Check if value is NULL
-	if (validity && !duckdb_validity_row_is_valid(validity, row_idx)) {
-		return atom_nil;
+	enif_alloc_binary(36, &bin);
+	unsigned char *out = bin.data;
+	for (int i = 0; i < 16; i++) {
+		if (i == 4 || i == 6 || i == 8 || i == 10) {
+			*out++ = '-';
+		}
+		*out++ = hex_digits[bytes[i] >> 4];
+		*out++ = hex_digits[bytes[i] & 0x0F];
 	}
+	return enif_make_binary(env, &bin);
+}
 
-	switch (type_id) {
-	case DUCKDB_TYPE_BOOLEAN: {
-		bool *bool_data = (bool *)data;
-		return bool_data[row_idx] ? enif_make_atom(env, "true") : enif_make_atom(env, "false");
+// Vector kernels used by the chunk decoders. The AVX2 variants are compiled for that target only
+// and picked at load time when the CPU has it; NEON is part of the aarch64 baseline.
+typedef struct {
+	const char *isa;
+	// True when every one of the 64-row validity words is all ones
+	bool (*words_all_set)(const uint64_t *words, idx_t count);
+	bool (*all_finite_f32)(const float *values, idx_t count);
+	bool (*all_finite_f64)(const double *values, idx_t count);
+} DecodeKernels;
+
+static bool words_all_set_scalar(const uint64_t *words, idx_t count) {
+	uint64_t acc = ~(uint64_t)0;
+	for (idx_t i = 0; i < count; i++) {
+		acc &= words[i];
+	}
+	return acc == ~(uint64_t)0;
+}
+
+// Checks the exponent bits directly, so the loop vectorizes without relying on isfinite
+static bool all_finite_f32_scalar(const float *values, idx_t count) {
+	uint32_t any = 0;
+	for (idx_t i = 0; i < count; i++) {
+		uint32_t bits;
+		memcpy(&bits, &values[i], sizeof(bits));
+		any |= (bits & 0x7F800000u) == 0x7F800000u;
 	}
-	case DUCKDB_TYPE_TINYINT: {
-		int8_t *int8_data = (int8_t *)data;
-		return enif_make_int(env, int8_data[row_idx]);
+	return !any;
+}
+
+static bool all_finite_f64_scalar(const double *values, idx_t count) {
+	uint64_t any = 0;
+	for (idx_t i = 0; i < count; i++) {
+		uint64_t bits;
+		memcpy(&bits, &values[i], sizeof(bits));
+		any |= (bits & 0x7FF0000000000000ull) == 0x7FF0000000000000ull;
 	}
-	case DUCKDB_TYPE_SMALLINT: {
-		int16_t *int16_data = (int16_t *)data;
-		return enif_make_int(env, int16_data[row_idx]);
+	return !any;
+}
+
+#if defined(DUCKDB_EX_AVX2)
+__attribute__((target("avx2"))) static bool words_all_set_avx2(const uint64_t *words, idx_t count) {
+	__m256i ones = _mm256_set1_epi64x(-1);
+	__m256i acc = ones;
+	idx_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		acc = _mm256_and_si256(acc, _mm256_loadu_si256((const __m256i *)(words + i)));
 	}
-	case DUCKDB_TYPE_INTEGER: {
-		int32_t *int32_data = (int32_t *)data;
-		return enif_make_int(env, int32_data[row_idx]);
+	return _mm256_testc_si256(acc, ones) && words_all_set_scalar(words + i, count - i);
+}
+
+__attribute__((target("avx2"))) static bool all_finite_f32_avx2(const float *values, idx_t count) {
+	__m256i mask = _mm256_set1_epi32(0x7F800000);
+	__m256i any = _mm256_setzero_si256();
+	idx_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i exponent = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(values + i)), mask);
+		any = _mm256_or_si256(any, _mm256_cmpeq_epi32(exponent, mask));
 	}
-	case DUCKDB_TYPE_BIGINT: {
-		int64_t *int64_data = (int64_t *)data;
-		return enif_make_long(env, int64_data[row_idx]);
+	return _mm256_testz_si256(any, any) && all_finite_f32_scalar(values + i, count - i);
+}
+
+__attribute__((target("avx2"))) static bool all_finite_f64_avx2(const double *values, idx_t count) {
+	__m256i mask = _mm256_set1_epi64x(0x7FF0000000000000ll);
+	__m256i any = _mm256_setzero_si256();
+	idx_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m256i exponent = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(values + i)), mask);
+		any = _mm256_or_si256(any, _mm256_cmpeq_epi64(exponent, mask));
 	}
-	case DUCKDB_TYPE_UTINYINT: {
-		uint8_t *uint8_data = (uint8_t *)data;
-		return enif_make_uint(env, uint8_data[row_idx]);
+	return _mm256_testz_si256(any, any) && all_finite_f64_scalar(values + i, count - i);
+}
+#endif
+
+#if defined(DUCKDB_EX_NEON)
+static bool words_all_set_neon(const uint64_t *words, idx_t count) {
+	uint64x2_t acc = vdupq_n_u64(~(uint64_t)0);
+	idx_t i = 0;
+	for (; i + 2 <= count; i += 2) {
+		acc = vandq_u64(acc, vld1q_u64(words + i));
 	}
-	case DUCKDB_TYPE_USMALLINT: {
-		uint16_t *uint16_data = (uint16_t *)data;
-		return enif_make_uint(env, uint16_data[row_idx]);
+	return (vgetq_lane_u64(acc, 0) & vgetq_lane_u64(acc, 1)) == ~(uint64_t)0 &&
+	       words_all_set_scalar(words + i, count - i);
+}
+
+static bool all_finite_f32_neon(const float *values, idx_t count) {
+	uint32x4_t mask = vdupq_n_u32(0x7F800000u);
+	uint32x4_t any = vdupq_n_u32(0);
+	idx_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		uint32x4_t exponent = vandq_u32(vld1q_u32((const uint32_t *)(values + i)), mask);
+		any = vorrq_u32(any, vceqq_u32(exponent, mask));
 	}
-	case DUCKDB_TYPE_UINTEGER: {
-		uint32_t *uint32_data = (uint32_t *)data;
-		return enif_make_uint(env, uint32_data[row_idx]);
+	return vmaxvq_u32(any) == 0 && all_finite_f32_scalar(values + i, count - i);
+}
+
+static bool all_finite_f64_neon(const double *values, idx_t count) {
+	uint64x2_t mask = vdupq_n_u64(0x7FF0000000000000ull);
+	uint64x2_t any = vdupq_n_u64(0);
+	idx_t i = 0;
+	for (; i + 2 <= count; i += 2) {
+		uint64x2_t exponent = vandq_u64(vld1q_u64((const uint64_t *)(values + i)), mask);
+		any = vorrq_u64(any, vceqq_u64(exponent, mask));
 	}
-	case DUCKDB_TYPE_UBIGINT: {
-		uint64_t *uint64_data = (uint64_t *)data;
-		return enif_make_uint64(env, uint64_data[row_idx]);
+	return (vgetq_lane_u64(any, 0) | vgetq_lane_u64(any, 1)) == 0 && all_finite_f64_scalar(values + i, count - i);
+}
+#endif
+
+static DecodeKernels decode_kernels = {"scalar", words_all_set_scalar, all_finite_f32_scalar, all_finite_f64_scalar};
+
+static void decode_kernels_init(void) {
+#if defined(DUCKDB_EX_AVX2)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		decode_kernels = (DecodeKernels){"avx2", words_all_set_avx2, all_finite_f32_avx2, all_finite_f64_avx2};
 	}
-	case DUCKDB_TYPE_HUGEINT: {
-		duckdb_hugeint *hugeint_data = (duckdb_hugeint *)data;
-		duckdb_hugeint value = hugeint_data[row_idx];
+#elif defined(DUCKDB_EX_NEON)
+	decode_kernels = (DecodeKernels){"neon", words_all_set_neon, all_finite_f32_neon, all_finite_f64_neon};
+#endif
+}
 
-		// Check if it fits in a 64-bit signed integer first
-		if (value.upper == 0 && value.lower <= 9223372036854775807ULL) {
-			// Positive number that fits in int64
-			return enif_make_int64(env, (int64_t)value.lower);
-		} else if (value.upper == -1 && value.lower >= 9223372036854775808ULL) {
-			// Negative number that fits in int64 (two's complement)
-			return enif_make_int64(env, (int64_t)value.lower);
-		} else {
-			// For large numbers, we need exact precision
-			// Since the chunked API doesn't allow varchar conversion,
-			// we'll return the raw components as a special format
-			// that the TypeConverter can handle
-			char buffer[128];
-			snprintf(buffer, sizeof(buffer), "hugeint:%lld:%llu", (long long)value.upper,
-			         (unsigned long long)value.lower);
-
-			// Return as binary string for TypeConverter to handle
-			ErlNifBinary bin;
-			size_t len = strlen(buffer);
-			enif_alloc_binary(len, &bin);
-			memcpy(bin.data, buffer, len);
-			return enif_make_binary(env, &bin);
-		}
+// True when rows [offset, offset + count) are all valid. Partial words at either end are masked,
+// whole words in between go through the vector kernel.
+static bool validity_range_all_valid(const uint64_t *validity, idx_t offset, idx_t count) {
+	if (!validity || count == 0) {
+		return true;
 	}
-	case DUCKDB_TYPE_FLOAT: {
-		float *float_data = (float *)data;
-		return enif_make_double(env, (double)float_data[row_idx]);
+
+	idx_t end = offset + count;
+	idx_t first_word = offset / 64;
+	idx_t last_word = (end - 1) / 64;
+	uint64_t head_mask = ~(uint64_t)0 << (offset % 64);
+	uint64_t tail_mask = end % 64 ? (((uint64_t)1 << (end % 64)) - 1) : ~(uint64_t)0;
+
+	if (first_word == last_word) {
+		uint64_t mask = head_mask & tail_mask;
+		return (validity[first_word] & mask) == mask;
 	}
-	case DUCKDB_TYPE_DOUBLE: {
-		double *double_data = (double *)data;
-		return enif_make_double(env, double_data[row_idx]);
+	if ((validity[first_word] & head_mask) != head_mask || (validity[last_word] & tail_mask) != tail_mask) {
+		return false;
 	}
-	case DUCKDB_TYPE_DECIMAL: {
-		// For DECIMAL, we need to get the scale and width from the logical type
-		// and treat the underlying data as the internal storage type
-		uint8_t width = duckdb_decimal_width(logical_type);
-		uint8_t scale = duckdb_decimal_scale(logical_type);
-		duckdb_type internal_type = duckdb_decimal_internal_type(logical_type);
+	return decode_kernels.words_all_set(validity + first_word + 1, last_word - first_word - 1);
+}
 
-		char buffer[64];
-		int64_t raw_value = 0;
+// Element width of the numeric types that can be packed into a binary, 0 for anything else
+static size_t packed_numeric_width(duckdb_type type_id) {
+	switch (type_id) {
+	case DUCKDB_TYPE_TINYINT:
+	case DUCKDB_TYPE_UTINYINT:
+		return 1;
+	case DUCKDB_TYPE_SMALLINT:
+	case DUCKDB_TYPE_USMALLINT:
+		return 2;
+	case DUCKDB_TYPE_INTEGER:
+	case DUCKDB_TYPE_UINTEGER:
+	case DUCKDB_TYPE_FLOAT:
+		return 4;
+	case DUCKDB_TYPE_BIGINT:
+	case DUCKDB_TYPE_UBIGINT:
+	case DUCKDB_TYPE_DOUBLE:
+		return 8;
+	default:
+		return 0;
+	}
+}
 
-		// Get the raw value based on internal storage type
-		switch (internal_type) {
-		case DUCKDB_TYPE_SMALLINT: {
-			int16_t *int16_data = (int16_t *)data;
-			raw_value = int16_data[row_idx];
-			break;
-		}
-		case DUCKDB_TYPE_INTEGER: {
-			int32_t *int32_data = (int32_t *)data;
-			raw_value = int32_data[row_idx];
-			break;
-		}
-		case DUCKDB_TYPE_BIGINT: {
-			int64_t *int64_data = (int64_t *)data;
-			raw_value = int64_data[row_idx];
-			break;
+// Copies count elements of a numeric child vector, starting at offset, into a single binary.
+// Returns false when one of them is NULL so the caller can fall back to a list.
+static bool make_packed_numeric(ErlNifEnv *env, duckdb_vector child_vector, size_t width, idx_t offset,
+                                idx_t count, ERL_NIF_TERM *out) {
+	if (!validity_range_all_valid(duckdb_vector_get_validity(child_vector), offset, count)) {
+		return false;
+	}
+
+	const unsigned char *data = (const unsigned char *)duckdb_vector_get_data(child_vector);
+	if (!data && count > 0) {
+		return false;
+	}
+
+	unsigned char *bytes = enif_make_new_binary(env, count * width, out);
+	if (count > 0) {
+		memcpy(bytes, data + offset * width, count * width);
+	}
+	return true;
+}
+
+// JSON columns are VARCHAR columns carrying the JSON alias
+static bool logical_type_is_json(duckdb_logical_type type) {
+	char *alias = duckdb_logical_type_get_alias(type);
+	if (!alias) {
+		return false;
+	}
+	bool is_json = strcmp(alias, "JSON") == 0;
+	duckdb_free(alias);
+	return is_json;
+}
+
+// Recursive descent JSON parser producing terms directly. Containers collect their elements on
+// a shared term stack, addressed by index because growing it moves it.
+typedef struct {
+	ErlNifEnv *env;
+	const char *pos;
+	const char *end;
+	const DecodeOptions *opts;
+	ERL_NIF_TERM *stack;
+	size_t stack_len;
+	size_t stack_cap;
+	int depth;
+} JsonParser;
+
+static bool json_parse_value(JsonParser *p, ERL_NIF_TERM *out);
+
+static bool json_push(JsonParser *p, ERL_NIF_TERM term) {
+	if (p->stack_len == p->stack_cap) {
+		size_t cap = p->stack_cap ? p->stack_cap * 2 : 64;
+		ERL_NIF_TERM *stack = enif_realloc(p->stack, sizeof(ERL_NIF_TERM) * cap);
+		if (!stack) {
+			return false;
 		}
-		case DUCKDB_TYPE_HUGEINT: {
-			// For hugeint, fall back to double conversion
-			duckdb_hugeint *hugeint_data = (duckdb_hugeint *)data;
+		p->stack = stack;
+		p->stack_cap = cap;
+	}
+	p->stack[p->stack_len++] = term;
+	return true;
+}
+
+static void json_skip_ws(JsonParser *p) {
+	while (p->pos < p->end && (*p->pos == ' ' || *p->pos == '\t' || *p->pos == '\n' || *p->pos == '\r')) {
+		p->pos++;
+	}
+}
+
+static int json_hex_value(char c) {
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	}
+	if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	}
+	if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+static bool json_parse_hex4(JsonParser *p, uint32_t *out) {
+	if (p->end - p->pos < 4) {
+		return false;
+	}
+	uint32_t value = 0;
+	for (int i = 0; i < 4; i++) {
+		int digit = json_hex_value(p->pos[i]);
+		if (digit < 0) {
+			return false;
+		}
+		value = (value << 4) | (uint32_t)digit;
+	}
+	p->pos += 4;
+	*out = value;
+	return true;
+}
+
+static size_t json_put_utf8(unsigned char *out, uint32_t cp) {
+	if (cp < 0x80) {
+		out[0] = (unsigned char)cp;
+		return 1;
+	}
+	if (cp < 0x800) {
+		out[0] = (unsigned char)(0xC0 | (cp >> 6));
+		out[1] = (unsigned char)(0x80 | (cp & 0x3F));
+		return 2;
+	}
+	if (cp < 0x10000) {
+		out[0] = (unsigned char)(0xE0 | (cp >> 12));
+		out[1] = (unsigned char)(0x80 | ((cp >> 6) & 0x3F));
+		out[2] = (unsigned char)(0x80 | (cp & 0x3F));
+		return 3;
+	}
+	out[0] = (unsigned char)(0xF0 | (cp >> 18));
+	out[1] = (unsigned char)(0x80 | ((cp >> 12) & 0x3F));
+	out[2] = (unsigned char)(0x80 | ((cp >> 6) & 0x3F));
+	out[3] = (unsigned char)(0x80 | (cp & 0x3F));
+	return 4;
+}
+
+// Object keys listed in the json_keys option become atoms; the atoms already exist, so looking
+// them up cannot grow the atom table
+static ERL_NIF_TERM json_key_term(JsonParser *p, const char *key, size_t len, ERL_NIF_TERM binary) {
+	ERL_NIF_TERM atom;
+	if (p->opts->json_key_count == 0 || len > 255 ||
+	    !enif_make_existing_atom_len(p->env, key, len, &atom, ERL_NIF_LATIN1)) {
+		return binary;
+	}
+	for (unsigned i = 0; i < p->opts->json_key_count; i++) {
+		if (enif_is_identical(atom, p->opts->json_keys[i])) {
+			return atom;
+		}
+	}
+	return binary;
+}
+
+// Parses the string starting after the opening quote. The decoded text is never longer than
+// its escaped form, so the binary is allocated at that size and shrunk afterwards.
+static bool json_parse_string(JsonParser *p, bool is_key, ERL_NIF_TERM *out) {
+	const char *start = p->pos;
+	const char *scan = start;
+	while (scan < p->end && *scan != '"' && *scan != '\\') {
+		scan++;
+	}
+	if (scan >= p->end) {
+		return false;
+	}
+
+	if (*scan == '"') {
+		size_t len = (size_t)(scan - start);
+		ERL_NIF_TERM binary;
+		memcpy(enif_make_new_binary(p->env, len, &binary), start, len);
+		*out = is_key ? json_key_term(p, start, len, binary) : binary;
+		p->pos = scan + 1;
+		return true;
+	}
+
+	const char *close = scan;
+	while (close < p->end && *close != '"') {
+		close += *close == '\\' ? 2 : 1;
+	}
+	if (close >= p->end) {
+		return false;
+	}
+
+	ErlNifBinary bin;
+	if (!enif_alloc_binary((size_t)(close - start), &bin)) {
+		return false;
+	}
+	size_t len = (size_t)(scan - start);
+	memcpy(bin.data, start, len);
+	p->pos = scan;
+
+	while (*p->pos != '"') {
+		char c = *p->pos++;
+		if (c != '\\') {
+			bin.data[len++] = (unsigned char)c;
+			continue;
+		}
+		c = *p->pos++;
+		switch (c) {
+		case '"':
+		case '\\':
+		case '/':
+			bin.data[len++] = (unsigned char)c;
+			break;
+		case 'b':
+			bin.data[len++] = '\b';
+			break;
+		case 'f':
+			bin.data[len++] = '\f';
+			break;
+		case 'n':
+			bin.data[len++] = '\n';
+			break;
+		case 'r':
+			bin.data[len++] = '\r';
+			break;
+		case 't':
+			bin.data[len++] = '\t';
+			break;
+		case 'u': {
+			uint32_t cp;
+			if (!json_parse_hex4(p, &cp)) {
+				enif_release_binary(&bin);
+				return false;
+			}
+			// Characters outside the BMP arrive as a surrogate pair
+			if (cp >= 0xD800 && cp <= 0xDBFF && p->end - p->pos >= 6 && p->pos[0] == '\\' && p->pos[1] == 'u') {
+				const char *pair = p->pos;
+				uint32_t low;
+				p->pos += 2;
+				if (json_parse_hex4(p, &low) && low >= 0xDC00 && low <= 0xDFFF) {
+					cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+				} else {
+					p->pos = pair;
+				}
+			}
+			// A lone surrogate has no UTF-8 encoding, so the document is kept as text
+			if (cp >= 0xD800 && cp <= 0xDFFF) {
+				enif_release_binary(&bin);
+				return false;
+			}
+			len += json_put_utf8(bin.data + len, cp);
+			break;
+		}
+		default:
+			enif_release_binary(&bin);
+			return false;
+		}
+	}
+	p->pos++;
+
+	enif_realloc_binary(&bin, len);
+	ERL_NIF_TERM binary = enif_make_binary(p->env, &bin);
+	*out = is_key ? json_key_term(p, (const char *)bin.data, len, binary) : binary;
+	return true;
+}
+
+// Builds an integer of any size from decimal text: an optional '-' followed by digits
+static bool json_make_integer(ErlNifEnv *env, const char *text, size_t length, ERL_NIF_TERM *out) {
+	bool negative = length > 0 && text[0] == '-';
+	const char *digits = negative ? text + 1 : text;
+	size_t count = negative ? length - 1 : length;
+	if (count == 0 || count > JSON_MAX_INTEGER_DIGITS) {
+		return false;
+	}
+
+	// 10^count < 256^(count / 2 + 1)
+	unsigned char *magnitude = enif_alloc(count / 2 + 1);
+	if (!magnitude) {
+		return false;
+	}
+	size_t used = 0;
+	for (size_t i = 0; i < count; i++) {
+		unsigned carry = (unsigned)(digits[i] - '0');
+		for (size_t b = 0; b < used; b++) {
+			unsigned value = magnitude[b] * 10u + carry;
+			magnitude[b] = (unsigned char)value;
+			carry = value >> 8;
+		}
+		while (carry > 0) {
+			magnitude[used++] = (unsigned char)carry;
+			carry >>= 8;
+		}
+	}
+
+	*out = make_bignum_term(env, magnitude, used, negative);
+	enif_free(magnitude);
+	return true;
+}
+
+// Integers become integers of any size, everything else a float. Numbers a double cannot hold,
+// such as 1e400, and integers longer than JSON_MAX_INTEGER_DIGITS are returned as their text.
+static bool json_number_term(ErlNifEnv *env, const char *text, size_t length, bool is_float, ERL_NIF_TERM *out) {
+	char *endptr;
+	if (!is_float) {
+		errno = 0;
+		long long value = strtoll(text, &endptr, 10);
+		if (*endptr != '\0') {
+			return false;
+		}
+		if (errno != ERANGE) {
+			*out = enif_make_int64(env, value);
+			return true;
+		}
+		if (json_make_integer(env, text, length, out)) {
+			return true;
+		}
+		*out = make_binary_from(env, text, length);
+		return true;
+	}
+
+	double value = strtod(text, &endptr);
+	if (*endptr != '\0') {
+		return false;
+	}
+	*out = isfinite(value) ? enif_make_double(env, value) : make_binary_from(env, text, length);
+	return true;
+}
+
+static bool json_parse_number(JsonParser *p, ERL_NIF_TERM *out) {
+	const char *start = p->pos;
+	bool is_float = false;
+
+	if (p->pos < p->end && *p->pos == '-') {
+		p->pos++;
+	}
+	while (p->pos < p->end) {
+		char c = *p->pos;
+		if (c >= '0' && c <= '9') {
+			p->pos++;
+		} else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+			is_float = true;
+			p->pos++;
+		} else {
+			break;
+		}
+	}
+
+	size_t len = (size_t)(p->pos - start);
+	if (len == 0) {
+		return false;
+	}
+
+	// strtoll and strtod need a terminated copy; long numbers get one from the heap
+	char small[64];
+	char *buffer = len < sizeof(small) ? small : enif_alloc(len + 1);
+	if (!buffer) {
+		return false;
+	}
+	memcpy(buffer, start, len);
+	buffer[len] = '\0';
+
+	bool ok = json_number_term(p->env, buffer, len, is_float, out);
+	if (buffer != small) {
+		enif_free(buffer);
+	}
+	return ok;
+}
+
+static bool json_parse_array(JsonParser *p, ERL_NIF_TERM *out) {
+	size_t base = p->stack_len;
+
+	json_skip_ws(p);
+	if (p->pos < p->end && *p->pos == ']') {
+		p->pos++;
+		*out = enif_make_list(p->env, 0);
+		return true;
+	}
+
+	for (;;) {
+		ERL_NIF_TERM element;
+		if (!json_parse_value(p, &element) || !json_push(p, element)) {
+			return false;
+		}
+		json_skip_ws(p);
+		if (p->pos >= p->end) {
+			return false;
+		}
+		char c = *p->pos++;
+		if (c == ']') {
+			break;
+		}
+		if (c != ',') {
+			return false;
+		}
+	}
+
+	*out = enif_make_list_from_array(p->env, p->stack + base, (unsigned)(p->stack_len - base));
+	p->stack_len = base;
+	return true;
+}
+
+static bool json_parse_object(JsonParser *p, ERL_NIF_TERM *out) {
+	size_t base = p->stack_len;
+
+	json_skip_ws(p);
+	if (p->pos < p->end && *p->pos == '}') {
+		p->pos++;
+		*out = enif_make_new_map(p->env);
+		return true;
+	}
+
+	for (;;) {
+		ERL_NIF_TERM key;
+		ERL_NIF_TERM value;
+		json_skip_ws(p);
+		if (p->pos >= p->end || *p->pos != '"') {
+			return false;
+		}
+		p->pos++;
+		if (!json_parse_string(p, true, &key)) {
+			return false;
+		}
+		json_skip_ws(p);
+		if (p->pos >= p->end || *p->pos != ':') {
+			return false;
+		}
+		p->pos++;
+		if (!json_parse_value(p, &value) || !json_push(p, key) || !json_push(p, value)) {
+			return false;
+		}
+		json_skip_ws(p);
+		if (p->pos >= p->end) {
+			return false;
+		}
+		char c = *p->pos++;
+		if (c == '}') {
+			break;
+		}
+		if (c != ',') {
+			return false;
+		}
+	}
+
+	// Keys and values are interleaved on the stack; split them for enif_make_map_from_arrays
+	size_t count = (p->stack_len - base) / 2;
+	ERL_NIF_TERM *keys = enif_alloc(sizeof(ERL_NIF_TERM) * count * 2);
+	if (!keys) {
+		return false;
+	}
+	ERL_NIF_TERM *values = keys + count;
+	for (size_t i = 0; i < count; i++) {
+		keys[i] = p->stack[base + 2 * i];
+		values[i] = p->stack[base + 2 * i + 1];
+	}
+
+	// Duplicate keys make enif_make_map_from_arrays fail; the last one wins, as with Jason
+	if (!enif_make_map_from_arrays(p->env, keys, values, count, out)) {
+		*out = enif_make_new_map(p->env);
+		for (size_t i = 0; i < count; i++) {
+			enif_make_map_put(p->env, *out, keys[i], values[i], out);
+		}
+	}
+
+	enif_free(keys);
+	p->stack_len = base;
+	return true;
+}
+
+static bool json_parse_value(JsonParser *p, ERL_NIF_TERM *out) {
+	json_skip_ws(p);
+	if (p->pos >= p->end) {
+		return false;
+	}
+
+	char c = *p->pos;
+	bool ok;
+	switch (c) {
+	case '{':
+	case '[':
+		if (++p->depth > JSON_MAX_DEPTH) {
+			return false;
+		}
+		p->pos++;
+		ok = c == '{' ? json_parse_object(p, out) : json_parse_array(p, out);
+		p->depth--;
+		return ok;
+	case '"':
+		p->pos++;
+		return json_parse_string(p, false, out);
+	case 't':
+		if (p->end - p->pos >= 4 && memcmp(p->pos, "true", 4) == 0) {
+			p->pos += 4;
+			*out = enif_make_atom(p->env, "true");
+			return true;
+		}
+		return false;
+	case 'f':
+		if (p->end - p->pos >= 5 && memcmp(p->pos, "false", 5) == 0) {
+			p->pos += 5;
+			*out = enif_make_atom(p->env, "false");
+			return true;
+		}
+		return false;
+	case 'n':
+		if (p->end - p->pos >= 4 && memcmp(p->pos, "null", 4) == 0) {
+			p->pos += 4;
+			*out = atom_nil;
+			return true;
+		}
+		return false;
+	default:
+		return json_parse_number(p, out);
+	}
+}
+
+// Decodes a JSON document; text that does not parse is returned unchanged as a binary
+static ERL_NIF_TERM json_decode_term(ErlNifEnv *env, const char *text, size_t length, const DecodeOptions *opts) {
+	JsonParser parser = {env, text, text + length, opts, NULL, 0, 0, 0};
+	ERL_NIF_TERM term;
+
+	bool ok = json_parse_value(&parser, &term);
+	if (ok) {
+		json_skip_ws(&parser);
+		ok = parser.pos == parser.end;
+	}
+	if (parser.stack) {
+		enif_free(parser.stack);
+	}
+
+	if (!ok) {
+		ERL_NIF_TERM binary;
+		memcpy(enif_make_new_binary(env, length, &binary), text, length);
+		return binary;
+	}
+	return term;
+}
+
+static ERL_NIF_TERM extract_vector_value(ErlNifEnv *env, duckdb_vector vector, duckdb_logical_type logical_type,
+                                         idx_t row_idx, const DecodeOptions *opts) {
+	duckdb_type type_id = duckdb_get_type_id(logical_type);
+	void *data = duckdb_vector_get_data(vector);
+	uint64_t *validity = duckdb_vector_get_validity(vector);
+
+	// For complex types like STRUCT, LIST, MAP, the data pointer might be NULL
+	// because they store data differently. Only check data for primitive types.
+	bool is_complex_type = (type_id == DUCKDB_TYPE_STRUCT || type_id == DUCKDB_TYPE_LIST ||
+	                        type_id == DUCKDB_TYPE_ARRAY || type_id == DUCKDB_TYPE_MAP || type_id == DUCKDB_TYPE_UNION);
+
+	// Check if data is NULL (only for non-complex types)
+	if (!is_complex_type && !data) {
+		return atom_nil;
+	}
+
+	// Check if value is NULL
+	if (validity && !duckdb_validity_row_is_valid(validity, row_idx)) {
+		return atom_nil;
+	}
+
+	switch (type_id) {
+	case DUCKDB_TYPE_BOOLEAN: {
+		bool *bool_data = (bool *)data;
+		return bool_data[row_idx] ? enif_make_atom(env, "true") : enif_make_atom(env, "false");
+	}
+	case DUCKDB_TYPE_TINYINT: {
+		int8_t *int8_data = (int8_t *)data;
+		return enif_make_int(env, int8_data[row_idx]);
+	}
+	case DUCKDB_TYPE_SMALLINT: {
+		int16_t *int16_data = (int16_t *)data;
+		return enif_make_int(env, int16_data[row_idx]);
+	}
+	case DUCKDB_TYPE_INTEGER: {
+		int32_t *int32_data = (int32_t *)data;
+		return enif_make_int(env, int32_data[row_idx]);
+	}
+	case DUCKDB_TYPE_BIGINT: {
+		int64_t *int64_data = (int64_t *)data;
+		return enif_make_long(env, int64_data[row_idx]);
+	}
+	case DUCKDB_TYPE_UTINYINT: {
+		uint8_t *uint8_data = (uint8_t *)data;
+		return enif_make_uint(env, uint8_data[row_idx]);
+	}
+	case DUCKDB_TYPE_USMALLINT: {
+		uint16_t *uint16_data = (uint16_t *)data;
+		return enif_make_uint(env, uint16_data[row_idx]);
+	}
+	case DUCKDB_TYPE_UINTEGER: {
+		uint32_t *uint32_data = (uint32_t *)data;
+		return enif_make_uint(env, uint32_data[row_idx]);
+	}
+	case DUCKDB_TYPE_UBIGINT: {
+		uint64_t *uint64_data = (uint64_t *)data;
+		return enif_make_uint64(env, uint64_data[row_idx]);
+	}
+	case DUCKDB_TYPE_HUGEINT: {
+		duckdb_hugeint *hugeint_data = (duckdb_hugeint *)data;
+		duckdb_hugeint value = hugeint_data[row_idx];
+		return make_int128_term(env, (uint64_t)value.upper, value.lower, true);
+	}
+	case DUCKDB_TYPE_FLOAT: {
+		float *float_data = (float *)data;
+		return make_float_term(env, (double)float_data[row_idx], opts->nan_nil);
+	}
+	case DUCKDB_TYPE_DOUBLE: {
+		double *double_data = (double *)data;
+		return make_float_term(env, double_data[row_idx], opts->nan_nil);
+	}
+	case DUCKDB_TYPE_DECIMAL: {
+		// For DECIMAL, we need to get the scale and width from the logical type
+		// and treat the underlying data as the internal storage type
+		uint8_t width = duckdb_decimal_width(logical_type);
+		uint8_t scale = duckdb_decimal_scale(logical_type);
+		duckdb_type internal_type = duckdb_decimal_internal_type(logical_type);
+
+		char buffer[64];
+		int64_t raw_value = 0;
+
+		// Get the raw value based on internal storage type
+		switch (internal_type) {
+		case DUCKDB_TYPE_SMALLINT: {
+			int16_t *int16_data = (int16_t *)data;
+			raw_value = int16_data[row_idx];
+			break;
+		}
+		case DUCKDB_TYPE_INTEGER: {
+			int32_t *int32_data = (int32_t *)data;
+			raw_value = int32_data[row_idx];
+			break;
+		}
+		case DUCKDB_TYPE_BIGINT: {
+			int64_t *int64_data = (int64_t *)data;
+			raw_value = int64_data[row_idx];
+			break;
+		}
+		case DUCKDB_TYPE_HUGEINT: {
+			// For hugeint, fall back to double conversion
+			duckdb_hugeint *hugeint_data = (duckdb_hugeint *)data;
 			duckdb_decimal decimal_val = {width, scale, hugeint_data[row_idx]};
-			double decimal_double = duckdb_decimal_to_double(decimal_val);
-			snprintf(buffer, sizeof(buffer), "%.10g", decimal_double);
-			ErlNifBinary bin;
-			size_t len = strlen(buffer);
-			enif_alloc_binary(len, &bin);
-			memcpy(bin.data, buffer, len);
-			return enif_make_binary(env, &bin);
+			return enif_make_double(env, duckdb_decimal_to_double(decimal_val));
 		}
 		default:
 			snprintf(buffer, sizeof(buffer), "unsupported_decimal_internal_type_%d", (int)internal_type);
@@ -1481,133 +3535,94 @@ static ERL_NIF_TERM extract_vector_value(ErlNifEnv *env, duckdb_vector vector, d
 		duckdb_date *date_data = (duckdb_date *)data;
 		duckdb_date date = date_data[row_idx];
 
-		// Convert date to proper ISO format using DuckDB's date conversion
-		duckdb_date_struct date_struct = duckdb_from_date(date);
-		char buffer[32];
-		snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", date_struct.year, date_struct.month, date_struct.day);
+		// Days since 1970-01-01
+		if (opts->temporal_raw) {
+			return enif_make_int(env, date.days);
+		}
 
-		ErlNifBinary bin;
-		size_t len = strlen(buffer);
-		enif_alloc_binary(len, &bin);
-		memcpy(bin.data, buffer, len);
-		return enif_make_binary(env, &bin);
+		if (!duckdb_is_finite_date(date)) {
+			return make_infinity_term(env, date.days > 0);
+		}
+		return make_date_term(env, duckdb_from_date(date));
 	}
 	case DUCKDB_TYPE_TIME: {
 		duckdb_time *time_data = (duckdb_time *)data;
 		duckdb_time time = time_data[row_idx];
 
-		// Convert time to proper ISO format using DuckDB's time conversion
-		duckdb_time_struct time_struct = duckdb_from_time(time);
-		char buffer[32];
-		snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d.%06d", time_struct.hour, time_struct.min, time_struct.sec,
-		         time_struct.micros);
+		// Microseconds since midnight
+		if (opts->temporal_raw) {
+			return enif_make_int64(env, time.micros);
+		}
 
-		ErlNifBinary bin;
-		size_t len = strlen(buffer);
-		enif_alloc_binary(len, &bin);
-		memcpy(bin.data, buffer, len);
-		return enif_make_binary(env, &bin);
+		return make_time_term(env, duckdb_from_time(time), 6);
 	}
-	case DUCKDB_TYPE_TIMESTAMP: {
+	case DUCKDB_TYPE_TIMESTAMP:
+	case DUCKDB_TYPE_TIMESTAMP_TZ: {
+		// TIMESTAMPTZ is stored like TIMESTAMP, as UTC microseconds since the epoch
 		duckdb_timestamp *timestamp_data = (duckdb_timestamp *)data;
 		duckdb_timestamp timestamp = timestamp_data[row_idx];
 
-		// Convert timestamp to proper ISO format using DuckDB's timestamp conversion
-		duckdb_timestamp_struct ts_struct = duckdb_from_timestamp(timestamp);
-		char buffer[64];
-		snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d.%06d", ts_struct.date.year,
-		         ts_struct.date.month, ts_struct.date.day, ts_struct.time.hour, ts_struct.time.min, ts_struct.time.sec,
-		         ts_struct.time.micros);
+		if (opts->temporal_raw) {
+			return enif_make_int64(env, timestamp.micros);
+		}
 
-		ErlNifBinary bin;
-		size_t len = strlen(buffer);
-		enif_alloc_binary(len, &bin);
-		memcpy(bin.data, buffer, len);
-		return enif_make_binary(env, &bin);
+		if (!duckdb_is_finite_timestamp(timestamp)) {
+			return make_infinity_term(env, timestamp.micros > 0);
+		}
+		return make_datetime_term(env, duckdb_from_timestamp(timestamp), 6);
 	}
 	case DUCKDB_TYPE_TIMESTAMP_S: {
 		duckdb_timestamp_s *timestamp_data = (duckdb_timestamp_s *)data;
 		duckdb_timestamp_s timestamp = timestamp_data[row_idx];
 
-		// Convert timestamp (seconds) to string representation
-		char buffer[32];
-		snprintf(buffer, sizeof(buffer), "%lld", (long long)timestamp.seconds);
+		if (opts->temporal_raw) {
+			return enif_make_int64(env, timestamp.seconds);
+		}
 
-		// Return as binary instead of charlist
-		ErlNifBinary bin;
-		size_t len = strlen(buffer);
-		enif_alloc_binary(len, &bin);
-		memcpy(bin.data, buffer, len);
-		return enif_make_binary(env, &bin);
+		if (!duckdb_is_finite_timestamp_s(timestamp)) {
+			return make_infinity_term(env, timestamp.seconds > 0);
+		}
+		return make_epoch_datetime_term(env, timestamp.seconds * 1000000, 0);
 	}
 	case DUCKDB_TYPE_TIMESTAMP_MS: {
 		duckdb_timestamp_ms *timestamp_data = (duckdb_timestamp_ms *)data;
 		duckdb_timestamp_ms timestamp = timestamp_data[row_idx];
 
-		// Convert timestamp (milliseconds) to string representation
-		char buffer[32];
-		snprintf(buffer, sizeof(buffer), "%lld", (long long)timestamp.millis);
+		if (opts->temporal_raw) {
+			return enif_make_int64(env, timestamp.millis);
+		}
 
-		// Return as binary instead of charlist
-		ErlNifBinary bin;
-		size_t len = strlen(buffer);
-		enif_alloc_binary(len, &bin);
-		memcpy(bin.data, buffer, len);
-		return enif_make_binary(env, &bin);
+		if (!duckdb_is_finite_timestamp_ms(timestamp)) {
+			return make_infinity_term(env, timestamp.millis > 0);
+		}
+		return make_epoch_datetime_term(env, timestamp.millis * 1000, 3);
 	}
 	case DUCKDB_TYPE_TIMESTAMP_NS: {
 		duckdb_timestamp_ns *timestamp_data = (duckdb_timestamp_ns *)data;
 		duckdb_timestamp_ns timestamp = timestamp_data[row_idx];
 
-		// Convert timestamp (nanoseconds) to string representation
-		char buffer[32];
-		snprintf(buffer, sizeof(buffer), "%lld", (long long)timestamp.nanos);
+		if (opts->temporal_raw) {
+			return enif_make_int64(env, timestamp.nanos);
+		}
 
-		// Return as binary instead of charlist
-		ErlNifBinary bin;
-		size_t len = strlen(buffer);
-		enif_alloc_binary(len, &bin);
-		memcpy(bin.data, buffer, len);
-		return enif_make_binary(env, &bin);
-	}
-	case DUCKDB_TYPE_TIMESTAMP_TZ: {
-		// TIMESTAMP_TZ is not directly supported as a C structure in DuckDB
-		// Return as unsupported for now
-		char buffer[64];
-		snprintf(buffer, sizeof(buffer), "unsupported_timestamp_tz_type");
-		return enif_make_atom(env, buffer);
+		if (!duckdb_is_finite_timestamp_ns(timestamp)) {
+			return make_infinity_term(env, timestamp.nanos > 0);
+		}
+		// DateTime holds microseconds; nanoseconds are floored so earlier instants stay earlier
+		int64_t micros = timestamp.nanos / 1000 - (timestamp.nanos % 1000 < 0 ? 1 : 0);
+		return make_epoch_datetime_term(env, micros, 6);
 	}
 	case DUCKDB_TYPE_TIME_TZ: {
 		duckdb_time_tz *time_data = (duckdb_time_tz *)data;
 		duckdb_time_tz time = time_data[row_idx];
 
-		// Return time with timezone as a tuple {micros, offset}
+		// {Time, offset in seconds east of UTC}
 		duckdb_time_tz_struct decomposed = duckdb_from_time_tz(time);
-		ERL_NIF_TERM micros = enif_make_long(env, decomposed.time.micros);
-		ERL_NIF_TERM offset = enif_make_int(env, decomposed.offset);
-
-		return enif_make_tuple2(env, micros, offset);
+		return enif_make_tuple2(env, make_time_term(env, decomposed.time, 6), enif_make_int(env, decomposed.offset));
 	}
 	case DUCKDB_TYPE_UUID: {
 		duckdb_hugeint *uuid_data = (duckdb_hugeint *)data;
-		duckdb_hugeint uuid = uuid_data[row_idx];
-
-		// Convert UUID (stored as hugeint) to standard UUID string format
-		// Format as xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
-		char buffer[64];
-		snprintf(buffer, sizeof(buffer), "%08llx-%04llx-%04llx-%04llx-%012llx",
-		         (unsigned long long)((uuid.upper >> 32) & 0xFFFFFFFF), // first 32 bits
-		         (unsigned long long)((uuid.upper >> 16) & 0xFFFF),     // next 16 bits
-		         (unsigned long long)(uuid.upper & 0xFFFF),             // next 16 bits
-		         (unsigned long long)((uuid.lower >> 48) & 0xFFFF),     // next 16 bits
-		         (unsigned long long)(uuid.lower & 0xFFFFFFFFFFFFLL));  // last 48 bits
-
-		// Return as binary instead of charlist
-		ErlNifBinary bin;
-		size_t len = strlen(buffer);
-		enif_alloc_binary(len, &bin);
-		memcpy(bin.data, buffer, len);
-		return enif_make_binary(env, &bin);
+		return make_uuid_term(env, uuid_data[row_idx], opts);
 	}
 	case DUCKDB_TYPE_ENUM: {
 		// Enum values are stored as their underlying integer type
@@ -1651,291 +3666,1081 @@ static ERL_NIF_TERM extract_vector_value(ErlNifEnv *env, duckdb_vector vector, d
 		return enif_make_atom(env, "invalid_enum_value");
 	}
 	case DUCKDB_TYPE_BIT: {
-		// Bit strings are typically stored as binary data
 		duckdb_string_t *bit_data = (duckdb_string_t *)data;
 		const char *bit_ptr = duckdb_string_t_data(&bit_data[row_idx]);
 		uint32_t bit_len = duckdb_string_t_length(bit_data[row_idx]);
+		return make_bitstring_term(env, (const uint8_t *)bit_ptr, bit_len);
+	}
+	case DUCKDB_TYPE_ARRAY: {
+		// Handle ARRAY type (similar to LIST but with fixed size)
+		idx_t array_size = duckdb_array_type_array_size(logical_type);
+
+		if (opts->numeric_lists_packed) {
+			duckdb_logical_type child_type = duckdb_array_type_child_type(logical_type);
+			size_t width = packed_numeric_width(duckdb_get_type_id(child_type));
+			duckdb_destroy_logical_type(&child_type);
+
+			ERL_NIF_TERM packed;
+			duckdb_vector child_vector = duckdb_array_vector_get_child(vector);
+			if (width > 0 && child_vector &&
+			    make_packed_numeric(env, child_vector, width, row_idx * array_size, array_size, &packed)) {
+				return packed;
+			}
+		}
+
+		if (array_size == 0) {
+			return enif_make_list(env, 0);
+		}
+
+		// Get child vector and type
+		duckdb_vector child_vector = duckdb_array_vector_get_child(vector);
+		if (!child_vector) {
+			return enif_make_list(env, 0);
+		}
+
+		duckdb_logical_type child_type = duckdb_array_type_child_type(logical_type);
+
+		// Build Elixir list from DuckDB array
+		ERL_NIF_TERM *array_elements = enif_alloc(sizeof(ERL_NIF_TERM) * array_size);
+		if (!array_elements) {
+			duckdb_destroy_logical_type(&child_type);
+			return atom_nil;
+		}
+
+		for (idx_t i = 0; i < array_size; i++) {
+			array_elements[i] = extract_vector_value(env, child_vector, child_type, row_idx * array_size + i, opts);
+		}
+
+		ERL_NIF_TERM result_list = enif_make_list_from_array(env, array_elements, array_size);
+		enif_free(array_elements);
+		duckdb_destroy_logical_type(&child_type);
+
+		return result_list;
+	}
+	case DUCKDB_TYPE_UHUGEINT: {
+		duckdb_uhugeint *uhugeint_data = (duckdb_uhugeint *)data;
+		duckdb_uhugeint value = uhugeint_data[row_idx];
+		return make_int128_term(env, value.upper, value.lower, false);
+	}
+	case DUCKDB_TYPE_INTERVAL: {
+		duckdb_interval *interval_data = (duckdb_interval *)data;
+		duckdb_interval interval = interval_data[row_idx];
+
+		// Return interval as a tuple {months, days, micros}
+		ERL_NIF_TERM months = enif_make_int(env, interval.months);
+		ERL_NIF_TERM days = enif_make_int(env, interval.days);
+		ERL_NIF_TERM micros = enif_make_long(env, interval.micros);
+
+		return enif_make_tuple3(env, months, days, micros);
+	}
+	case DUCKDB_TYPE_BLOB: {
+		duckdb_string_t *blob_data = (duckdb_string_t *)data;
+		const char *blob_ptr = duckdb_string_t_data(&blob_data[row_idx]);
+		uint32_t blob_len = duckdb_string_t_length(blob_data[row_idx]);
 
-		// Return bit string as binary data
+		// Return blob as binary data
 		ErlNifBinary bin;
-		enif_alloc_binary(bit_len, &bin);
-		memcpy(bin.data, bit_ptr, bit_len);
+		enif_alloc_binary(blob_len, &bin);
+		memcpy(bin.data, blob_ptr, blob_len);
 
 		return enif_make_binary(env, &bin);
 	}
-	case DUCKDB_TYPE_ARRAY: {
-		// Handle ARRAY type (similar to LIST but with fixed size)
-		idx_t array_size = duckdb_array_type_array_size(logical_type);
+	case DUCKDB_TYPE_VARCHAR: {
+		duckdb_string_t *string_data = (duckdb_string_t *)data;
+		const char *str = duckdb_string_t_data(&string_data[row_idx]);
+		uint32_t len = duckdb_string_t_length(string_data[row_idx]);
+
+		if (opts->json_decode && logical_type_is_json(logical_type)) {
+			return json_decode_term(env, str, len, opts);
+		}
+
+		ErlNifBinary bin;
+		enif_alloc_binary(len, &bin);
+		memcpy(bin.data, str, len);
+		return enif_make_binary(env, &bin);
+	}
+	case DUCKDB_TYPE_LIST: {
+		// Handle LIST type
+		duckdb_list_entry *list_data = (duckdb_list_entry *)data;
+		duckdb_list_entry entry = list_data[row_idx];
+
+		if (opts->numeric_lists_packed) {
+			duckdb_logical_type child_type = duckdb_list_type_child_type(logical_type);
+			size_t width = packed_numeric_width(duckdb_get_type_id(child_type));
+			duckdb_destroy_logical_type(&child_type);
+
+			ERL_NIF_TERM packed;
+			duckdb_vector child_vector = duckdb_list_vector_get_child(vector);
+			if (width > 0 && child_vector &&
+			    make_packed_numeric(env, child_vector, width, entry.offset, entry.length, &packed)) {
+				return packed;
+			}
+		}
+
+		// Safety check for list length
+		if (entry.length == 0) {
+			return enif_make_list(env, 0);
+		}
+
+		// Get child vector and type
+		duckdb_vector child_vector = duckdb_list_vector_get_child(vector);
+		if (!child_vector) {
+			return enif_make_list(env, 0);
+		}
+
+		duckdb_logical_type child_type = duckdb_list_type_child_type(logical_type);
+
+		// Build Elixir list from DuckDB list
+		ERL_NIF_TERM *list_elements = enif_alloc(sizeof(ERL_NIF_TERM) * entry.length);
+		if (!list_elements) {
+			duckdb_destroy_logical_type(&child_type);
+			return atom_nil;
+		}
+
+		for (idx_t i = 0; i < entry.length; i++) {
+			list_elements[i] = extract_vector_value(env, child_vector, child_type, entry.offset + i, opts);
+		}
+
+		ERL_NIF_TERM result_list = enif_make_list_from_array(env, list_elements, entry.length);
+		enif_free(list_elements);
+		duckdb_destroy_logical_type(&child_type);
+
+		return result_list;
+	}
+	case DUCKDB_TYPE_STRUCT: {
+		// Handle STRUCT type - return as a map
+		idx_t child_count = duckdb_struct_type_child_count(logical_type);
+
+		if (child_count == 0) {
+			return enif_make_new_map(env);
+		}
+
+		ERL_NIF_TERM *keys = enif_alloc(sizeof(ERL_NIF_TERM) * child_count);
+		ERL_NIF_TERM *values = enif_alloc(sizeof(ERL_NIF_TERM) * child_count);
+
+		if (!keys || !values) {
+			if (keys)
+				enif_free(keys);
+			if (values)
+				enif_free(values);
+			return atom_nil;
+		}
+
+		for (idx_t i = 0; i < child_count; i++) {
+			// Get child name and type
+			char *child_name = duckdb_struct_type_child_name(logical_type, i);
+			if (!child_name) {
+				// Clean up and return error
+				for (idx_t j = 0; j < i; j++) {
+					// Previous iterations may have allocated memory
+				}
+				enif_free(keys);
+				enif_free(values);
+				return atom_nil;
+			}
+
+			duckdb_logical_type child_type = duckdb_struct_type_child_type(logical_type, i);
+			duckdb_vector child_vector = duckdb_struct_vector_get_child(vector, i);
+
+			// Create key
+			size_t name_len = strlen(child_name);
+			ErlNifBinary name_bin;
+			enif_alloc_binary(name_len, &name_bin);
+			memcpy(name_bin.data, child_name, name_len);
+			keys[i] = enif_make_binary(env, &name_bin);
+
+			// Get value
+			values[i] = extract_vector_value(env, child_vector, child_type, row_idx, opts);
+
+			duckdb_free(child_name);
+			duckdb_destroy_logical_type(&child_type);
+		}
+
+		// Create a map from the key-value pairs
+		ERL_NIF_TERM result_map;
+		if (enif_make_map_from_arrays(env, keys, values, child_count, &result_map) == 0) {
+			result_map = enif_make_atom(env, "struct_conversion_failed");
+		}
+
+		enif_free(keys);
+		enif_free(values);
+
+		return result_map;
+	}
+	case DUCKDB_TYPE_MAP: {
+		// Handle MAP type - return as Elixir map
+		duckdb_logical_type key_type = duckdb_map_type_key_type(logical_type);
+		duckdb_logical_type value_type = duckdb_map_type_value_type(logical_type);
+
+		// Maps in DuckDB are stored as lists of {key, value} structs
+		duckdb_vector child_vector = duckdb_list_vector_get_child(vector);
+		duckdb_list_entry *list_data = (duckdb_list_entry *)data;
+		duckdb_list_entry entry = list_data[row_idx];
+
+		ERL_NIF_TERM *keys = enif_alloc(sizeof(ERL_NIF_TERM) * entry.length);
+		ERL_NIF_TERM *values = enif_alloc(sizeof(ERL_NIF_TERM) * entry.length);
+
+		for (idx_t i = 0; i < entry.length; i++) {
+			// Get key and value vectors from the struct
+			duckdb_vector key_vector = duckdb_struct_vector_get_child(child_vector, 0);
+			duckdb_vector value_vector = duckdb_struct_vector_get_child(child_vector, 1);
+
+			keys[i] = extract_vector_value(env, key_vector, key_type, entry.offset + i, opts);
+			values[i] = extract_vector_value(env, value_vector, value_type, entry.offset + i, opts);
+		}
+
+		ERL_NIF_TERM result_map;
+		if (enif_make_map_from_arrays(env, keys, values, entry.length, &result_map) == 0) {
+			result_map = enif_make_atom(env, "map_conversion_failed");
+		}
+
+		enif_free(keys);
+		enif_free(values);
+		duckdb_destroy_logical_type(&key_type);
+		duckdb_destroy_logical_type(&value_type);
+
+		return result_map;
+	}
+	case DUCKDB_TYPE_UNION: {
+		// A UNION vector is a struct whose first child holds the member tag of each row,
+		// followed by one child per member
+		duckdb_vector tag_vector = duckdb_struct_vector_get_child(vector, 0);
+		uint8_t *tags = (uint8_t *)duckdb_vector_get_data(tag_vector);
+		if (!tags) {
+			return atom_nil;
+		}
+
+		idx_t tag = tags[row_idx];
+		if (tag >= duckdb_union_type_member_count(logical_type)) {
+			return atom_nil;
+		}
+
+		// Tags come from the schema, so the set of atoms created here is bounded by it
+		char *tag_name = duckdb_union_type_member_name(logical_type, tag);
+		ERL_NIF_TERM tag_term = atom_nil;
+		if (tag_name) {
+			size_t tag_len = strlen(tag_name);
+			tag_term = tag_len < 256 ? enif_make_atom_len(env, tag_name, tag_len) : make_text_term(env, tag_name);
+			duckdb_free(tag_name);
+		}
+
+		duckdb_logical_type member_type = duckdb_union_type_member_type(logical_type, tag);
+		duckdb_vector member_vector = duckdb_struct_vector_get_child(vector, tag + 1);
+		ERL_NIF_TERM value = extract_vector_value(env, member_vector, member_type, row_idx, opts);
+		duckdb_destroy_logical_type(&member_type);
+
+		return enif_make_tuple2(env, tag_term, value);
+	}
+	default: {
+		// For unsupported types, return string representation
+		char buffer[256];
+		snprintf(buffer, sizeof(buffer), "unsupported_type_%d", (int)type_id);
+		return enif_make_atom(env, buffer);
+	}
+	}
+}
+
+static uint64_t fnv1a_hash(const char *data, uint32_t length) {
+	uint64_t hash = 14695981039346656037ULL;
+	for (uint32_t i = 0; i < length; i++) {
+		hash ^= (uint8_t)data[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+static void string_dict_free(StringDict *dict) {
+	if (dict->entries) {
+		for (idx_t i = 0; i <= dict->mask; i++) {
+			if (dict->entries[i].bytes) {
+				enif_free(dict->entries[i].bytes);
+			}
+		}
+		enif_free(dict->entries);
+		dict->entries = NULL;
+	}
+	if (dict->terms) {
+		enif_free(dict->terms);
+		dict->terms = NULL;
+	}
+	if (dict->resident) {
+		enif_free(dict->resident);
+		dict->resident = NULL;
+	}
+	if (dict->loaded) {
+		enif_free(dict->loaded);
+		dict->loaded = NULL;
+	}
+	dict->count = 0;
+}
+
+static bool string_dict_init(StringDict *dict, idx_t max_count) {
+	// Tables are allocated up front, so the cutoff is bounded before sizing them
+	if (max_count == 0 || max_count > STRING_DICT_MAX_COUNT) {
+		return false;
+	}
+
+	idx_t size = 16;
+	while (size < max_count * 2) {
+		size <<= 1;
+	}
+
+	dict->entries = enif_alloc(sizeof(StringDictEntry) * size);
+	dict->terms = enif_alloc(sizeof(ERL_NIF_TERM) * max_count);
+	if (dict->resident_env) {
+		dict->resident = enif_alloc(sizeof(ERL_NIF_TERM) * max_count);
+		dict->loaded = enif_alloc(sizeof(uint32_t) * max_count);
+	}
+	if (!dict->entries || !dict->terms || (dict->resident_env && (!dict->resident || !dict->loaded))) {
+		string_dict_free(dict);
+		return false;
+	}
+	memset(dict->entries, 0, sizeof(StringDictEntry) * size);
+	dict->mask = size - 1;
+	dict->max_count = max_count;
+	dict->count = 0;
+	return true;
+}
+
+// Returns the binary for a string, reusing the term of an earlier identical value. Once a column
+// has more distinct values than allowed its table is dropped and values are copied as usual.
+static ERL_NIF_TERM string_dict_intern(ErlNifEnv *env, StringDict *dict, const char *str, uint32_t length) {
+	if (!dict->entries && !string_dict_init(dict, dict->max_count)) {
+		dict->disabled = true;
+		return make_binary_from(env, str, length);
+	}
+
+	uint64_t hash = fnv1a_hash(str, length);
+	idx_t pos = hash & dict->mask;
+	while (dict->entries[pos].bytes) {
+		StringDictEntry *entry = &dict->entries[pos];
+		if (entry->hash == hash && entry->length == length && memcmp(entry->bytes, str, length) == 0) {
+			if (dict->resident_env && dict->loaded[entry->slot] != dict->generation) {
+				dict->terms[entry->slot] = enif_make_copy(env, dict->resident[entry->slot]);
+				dict->loaded[entry->slot] = dict->generation;
+			}
+			return dict->terms[entry->slot];
+		}
+		pos = (pos + 1) & dict->mask;
+	}
+
+	ERL_NIF_TERM term = make_binary_from(env, str, length);
+	char *bytes = dict->count < dict->max_count ? enif_alloc(length > 0 ? length : 1) : NULL;
+	if (!bytes) {
+		// Too many distinct values for deduplication to pay off
+		string_dict_free(dict);
+		dict->disabled = true;
+		return term;
+	}
+
+	memcpy(bytes, str, length);
+	dict->entries[pos].hash = hash;
+	dict->entries[pos].length = length;
+	dict->entries[pos].slot = (uint32_t)dict->count;
+	dict->entries[pos].bytes = bytes;
+	if (dict->resident_env) {
+		dict->resident[dict->count] = enif_make_copy(dict->resident_env, term);
+		dict->loaded[dict->count] = dict->generation;
+	}
+	dict->terms[dict->count++] = term;
+	return term;
+}
+
+static bool decode_options_parse(ErlNifEnv *env, ERL_NIF_TERM map, DecodeOptions *opts) {
+	ERL_NIF_TERM value;
+	ErlNifUInt64 number;
+
+	memset(opts, 0, sizeof(DecodeOptions));
+	if (!enif_is_map(env, map)) {
+		return false;
+	}
+
+	if (enif_get_map_value(env, map, atom_dedup_strings, &value)) {
+		if (!enif_get_uint64(env, value, &number)) {
+			return false;
+		}
+		opts->dedup_strings = (idx_t)number;
+	}
+
+	if (enif_get_map_value(env, map, atom_uuid, &value)) {
+		if (enif_is_identical(value, atom_raw)) {
+			opts->uuid_raw = true;
+		} else if (!enif_is_identical(value, atom_string)) {
+			return false;
+		}
+	}
+
+	if (enif_get_map_value(env, map, atom_temporal, &value)) {
+		if (enif_is_identical(value, atom_raw)) {
+			opts->temporal_raw = true;
+		} else if (!enif_is_identical(value, atom_native)) {
+			return false;
+		}
+	}
+
+	if (enif_get_map_value(env, map, atom_numeric_lists, &value)) {
+		if (enif_is_identical(value, atom_packed)) {
+			opts->numeric_lists_packed = true;
+		} else if (!enif_is_identical(value, atom_list)) {
+			return false;
+		}
+	}
+
+	if (enif_get_map_value(env, map, atom_nan, &value)) {
+		if (enif_is_identical(value, atom_nil)) {
+			opts->nan_nil = true;
+		} else if (!enif_is_identical(value, atom_atom)) {
+			return false;
+		}
+	}
+
+	if (enif_get_map_value(env, map, atom_json, &value)) {
+		if (enif_is_identical(value, atom_decode)) {
+			opts->json_decode = true;
+		} else if (!enif_is_identical(value, atom_string)) {
+			return false;
+		}
+	}
+
+	if (enif_get_map_value(env, map, atom_json_keys, &value)) {
+		ERL_NIF_TERM head;
+		while (enif_get_list_cell(env, value, &head, &value)) {
+			if (!enif_is_atom(env, head) || opts->json_key_count == DECODE_MAX_JSON_KEYS) {
+				return false;
+			}
+			opts->json_keys[opts->json_key_count++] = head;
+		}
+		if (!enif_is_empty_list(env, value)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void decode_context_init(DecodeContext *ctx, const DecodeOptions *opts, idx_t column_count) {
+	ctx->opts = *opts;
+	ctx->column_count = column_count;
+	ctx->dicts = NULL;
+
+	if (opts->dedup_strings > 0 && column_count > 0) {
+		ctx->dicts = enif_alloc(sizeof(StringDict) * column_count);
+		if (ctx->dicts) {
+			memset(ctx->dicts, 0, sizeof(StringDict) * column_count);
+			for (idx_t c = 0; c < column_count; c++) {
+				ctx->dicts[c].max_count = opts->dedup_strings;
+			}
+		}
+	}
+}
+
+static void decode_context_free(DecodeContext *ctx) {
+	if (ctx->dicts) {
+		for (idx_t c = 0; c < ctx->column_count; c++) {
+			string_dict_free(&ctx->dicts[c]);
+		}
+		enif_free(ctx->dicts);
+		ctx->dicts = NULL;
+	}
+}
+
+// Dictionary terms as one tuple per column, to survive a reschedule through argv
+static ERL_NIF_TERM decode_context_save_terms(ErlNifEnv *env, DecodeContext *ctx) {
+	if (!ctx->dicts) {
+		return enif_make_tuple(env, 0);
+	}
+
+	ERL_NIF_TERM *columns = enif_alloc(sizeof(ERL_NIF_TERM) * ctx->column_count);
+	for (idx_t c = 0; c < ctx->column_count; c++) {
+		StringDict *dict = &ctx->dicts[c];
+		columns[c] = enif_make_tuple_from_array(env, dict->terms, (unsigned)dict->count);
+	}
+	ERL_NIF_TERM saved = enif_make_tuple_from_array(env, columns, (unsigned)ctx->column_count);
+	enif_free(columns);
+	return saved;
+}
+
+static void decode_context_load_terms(ErlNifEnv *env, DecodeContext *ctx, ERL_NIF_TERM saved) {
+	const ERL_NIF_TERM *columns;
+	int column_count;
+
+	if (!ctx->dicts || !enif_get_tuple(env, saved, &column_count, &columns)) {
+		return;
+	}
+
+	for (idx_t c = 0; c < ctx->column_count && c < (idx_t)column_count; c++) {
+		StringDict *dict = &ctx->dicts[c];
+		const ERL_NIF_TERM *terms;
+		int count;
+		if (dict->count > 0 && enif_get_tuple(env, columns[c], &count, &terms) && (idx_t)count == dict->count) {
+			memcpy(dict->terms, terms, sizeof(ERL_NIF_TERM) * dict->count);
+		}
+	}
+}
+
+static void decode_state_resource_destructor(ErlNifEnv *env, void *obj) {
+	DecodeStateResource *state = (DecodeStateResource *)obj;
+	decode_context_free(&state->ctx);
+}
+
+static ERL_NIF_TERM decode_string_deduped(ErlNifEnv *env, duckdb_vector vector, idx_t row_idx, StringDict *dict) {
+	uint64_t *validity = duckdb_vector_get_validity(vector);
+	if (validity && !duckdb_validity_row_is_valid(validity, row_idx)) {
+		return atom_nil;
+	}
+
+	duckdb_string_t *string_data = (duckdb_string_t *)duckdb_vector_get_data(vector);
+	const char *str = duckdb_string_t_data(&string_data[row_idx]);
+	uint32_t length = duckdb_string_t_length(string_data[row_idx]);
+	return string_dict_intern(env, dict, str, length);
+}
+
+// Converts rows [start, end) of a fixed-width column; the type switch runs once per range
+static void convert_fixed_range(ErlNifEnv *env, duckdb_type type_id, const void *data, idx_t start, idx_t end,
+                                bool all_finite, bool nan_nil, ERL_NIF_TERM *out) {
+	switch (type_id) {
+	case DUCKDB_TYPE_BOOLEAN: {
+		ERL_NIF_TERM atom_true = enif_make_atom(env, "true");
+		ERL_NIF_TERM atom_false = enif_make_atom(env, "false");
+		for (idx_t i = start; i < end; i++) {
+			out[i] = ((const bool *)data)[i] ? atom_true : atom_false;
+		}
+		break;
+	}
+	case DUCKDB_TYPE_TINYINT:
+		for (idx_t i = start; i < end; i++) {
+			out[i] = enif_make_int(env, ((const int8_t *)data)[i]);
+		}
+		break;
+	case DUCKDB_TYPE_UTINYINT:
+		for (idx_t i = start; i < end; i++) {
+			out[i] = enif_make_uint(env, ((const uint8_t *)data)[i]);
+		}
+		break;
+	case DUCKDB_TYPE_SMALLINT:
+		for (idx_t i = start; i < end; i++) {
+			out[i] = enif_make_int(env, ((const int16_t *)data)[i]);
+		}
+		break;
+	case DUCKDB_TYPE_USMALLINT:
+		for (idx_t i = start; i < end; i++) {
+			out[i] = enif_make_uint(env, ((const uint16_t *)data)[i]);
+		}
+		break;
+	case DUCKDB_TYPE_INTEGER:
+		for (idx_t i = start; i < end; i++) {
+			out[i] = enif_make_int(env, ((const int32_t *)data)[i]);
+		}
+		break;
+	case DUCKDB_TYPE_UINTEGER:
+		for (idx_t i = start; i < end; i++) {
+			out[i] = enif_make_uint(env, ((const uint32_t *)data)[i]);
+		}
+		break;
+	case DUCKDB_TYPE_BIGINT:
+		for (idx_t i = start; i < end; i++) {
+			out[i] = enif_make_int64(env, ((const int64_t *)data)[i]);
+		}
+		break;
+	case DUCKDB_TYPE_UBIGINT:
+		for (idx_t i = start; i < end; i++) {
+			out[i] = enif_make_uint64(env, ((const uint64_t *)data)[i]);
+		}
+		break;
+	case DUCKDB_TYPE_FLOAT:
+		for (idx_t i = start; i < end; i++) {
+			double value = (double)((const float *)data)[i];
+			out[i] = all_finite ? enif_make_double(env, value) : make_float_term(env, value, nan_nil);
+		}
+		break;
+	case DUCKDB_TYPE_DOUBLE:
+		for (idx_t i = start; i < end; i++) {
+			double value = ((const double *)data)[i];
+			out[i] = all_finite ? enif_make_double(env, value) : make_float_term(env, value, nan_nil);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static bool is_fixed_width_column(duckdb_type type_id) {
+	return type_id == DUCKDB_TYPE_BOOLEAN || packed_numeric_width(type_id) > 0;
+}
+
+// Decodes a top-level VARCHAR column under json: :decode, with the JSON alias looked up once for
+// the column instead of for every cell
+static void decode_varchar_column(ErlNifEnv *env, duckdb_vector vector, bool is_json, idx_t count,
+                                  const DecodeOptions *opts, ERL_NIF_TERM *out) {
+	duckdb_string_t *data = (duckdb_string_t *)duckdb_vector_get_data(vector);
+	uint64_t *validity = duckdb_vector_get_validity(vector);
+
+	for (idx_t i = 0; i < count; i++) {
+		if (!data || (validity && !duckdb_validity_row_is_valid(validity, i))) {
+			out[i] = atom_nil;
+			continue;
+		}
+		const char *str = duckdb_string_t_data(&data[i]);
+		uint32_t len = duckdb_string_t_length(data[i]);
+		out[i] = is_json ? json_decode_term(env, str, len, opts) : make_binary_from(env, str, len);
+	}
+}
+
+// Element width of a LIST or ARRAY type that numeric_lists: :packed turns into binaries, 0 for
+// any other type
+static size_t packed_list_width(duckdb_logical_type type) {
+	duckdb_type type_id = duckdb_get_type_id(type);
+	duckdb_logical_type child;
+	if (type_id == DUCKDB_TYPE_LIST) {
+		child = duckdb_list_type_child_type(type);
+	} else if (type_id == DUCKDB_TYPE_ARRAY) {
+		child = duckdb_array_type_child_type(type);
+	} else {
+		return 0;
+	}
+	size_t width = packed_numeric_width(duckdb_get_type_id(child));
+	duckdb_destroy_logical_type(&child);
+	return width;
+}
 
-		if (array_size == 0) {
-			return enif_make_list(env, 0);
+// Packs a whole top-level LIST or ARRAY column with its element width resolved once instead of
+// per cell. NULL cells become nil; cells holding a NULL element are decoded as lists.
+static void decode_packed_list_column(ErlNifEnv *env, duckdb_vector vector, duckdb_logical_type type, size_t width,
+                                      idx_t count, const DecodeOptions *opts, ERL_NIF_TERM *out) {
+	bool is_array = duckdb_get_type_id(type) == DUCKDB_TYPE_ARRAY;
+	uint64_t *validity = duckdb_vector_get_validity(vector);
+	duckdb_vector child_vector =
+	    is_array ? duckdb_array_vector_get_child(vector) : duckdb_list_vector_get_child(vector);
+	idx_t array_size = is_array ? duckdb_array_type_array_size(type) : 0;
+	const duckdb_list_entry *entries = is_array ? NULL : (const duckdb_list_entry *)duckdb_vector_get_data(vector);
+
+	for (idx_t i = 0; i < count; i++) {
+		if (validity && !duckdb_validity_row_is_valid(validity, i)) {
+			out[i] = atom_nil;
+			continue;
 		}
-
-		// Get child vector and type
-		duckdb_vector child_vector = duckdb_array_vector_get_child(vector);
-		if (!child_vector) {
-			return enif_make_list(env, 0);
+		bool packed = false;
+		if (child_vector && (is_array || entries)) {
+			idx_t offset = is_array ? i * array_size : entries[i].offset;
+			idx_t length = is_array ? array_size : entries[i].length;
+			packed = make_packed_numeric(env, child_vector, width, offset, length, &out[i]);
+		}
+		if (!packed) {
+			out[i] = extract_vector_value(env, vector, type, i, opts);
 		}
+	}
+}
 
-		duckdb_logical_type child_type = duckdb_array_type_child_type(logical_type);
+// Converts a whole fixed-width column up front instead of dispatching per cell. Fully valid
+// vectors are converted in one pass; otherwise each 64-row validity word is tested at once and
+// only mixed words fall back to per-row checks. FLOAT and DOUBLE vectors without NaN or
+// infinities skip the per-value finiteness branch.
+static void decode_fixed_column(ErlNifEnv *env, duckdb_vector vector, duckdb_type type_id, idx_t count,
+                                const DecodeOptions *opts, ERL_NIF_TERM *out) {
+	const void *data = duckdb_vector_get_data(vector);
+	uint64_t *validity = duckdb_vector_get_validity(vector);
 
-		// Build Elixir list from DuckDB array
-		ERL_NIF_TERM *array_elements = enif_alloc(sizeof(ERL_NIF_TERM) * array_size);
-		if (!array_elements) {
-			duckdb_destroy_logical_type(&child_type);
-			return atom_nil;
+	if (!data) {
+		for (idx_t i = 0; i < count; i++) {
+			out[i] = atom_nil;
 		}
+		return;
+	}
 
-		for (idx_t i = 0; i < array_size; i++) {
-			array_elements[i] = extract_vector_value(env, child_vector, child_type, row_idx * array_size + i);
+	if (validity_range_all_valid(validity, 0, count)) {
+		bool all_finite = true;
+		if (type_id == DUCKDB_TYPE_FLOAT) {
+			all_finite = decode_kernels.all_finite_f32((const float *)data, count);
+		} else if (type_id == DUCKDB_TYPE_DOUBLE) {
+			all_finite = decode_kernels.all_finite_f64((const double *)data, count);
 		}
-
-		ERL_NIF_TERM result_list = enif_make_list_from_array(env, array_elements, array_size);
-		enif_free(array_elements);
-		duckdb_destroy_logical_type(&child_type);
-
-		return result_list;
+		convert_fixed_range(env, type_id, data, 0, count, all_finite, opts->nan_nil, out);
+		return;
 	}
-	case DUCKDB_TYPE_UHUGEINT: {
-		duckdb_uhugeint *uhugeint_data = (duckdb_uhugeint *)data;
-		duckdb_uhugeint value = uhugeint_data[row_idx];
 
-		// Convert uhugeint to string representation
-		char buffer[64];
-		if (value.upper == 0) {
-			// Simple case: value fits in lower 64 bits
-			snprintf(buffer, sizeof(buffer), "%llu", (unsigned long long)value.lower);
+	// NULL slots may hold any bits, so mixed vectors check finiteness per value
+	for (idx_t start = 0; start < count; start += 64) {
+		idx_t end = start + 64 < count ? start + 64 : count;
+		uint64_t word = validity[start / 64];
+		uint64_t mask = end - start == 64 ? ~(uint64_t)0 : (((uint64_t)1 << (end - start)) - 1);
+
+		if ((word & mask) == mask) {
+			convert_fixed_range(env, type_id, data, start, end, false, opts->nan_nil, out);
+		} else if ((word & mask) == 0) {
+			for (idx_t i = start; i < end; i++) {
+				out[i] = atom_nil;
+			}
 		} else {
-			// Complex case: use approximation for very large numbers
-			// For unsigned, we can safely use the upper and lower parts
-			snprintf(buffer, sizeof(buffer), "%llu%016llx", (unsigned long long)value.upper,
-			         (unsigned long long)value.lower);
+			for (idx_t i = start; i < end; i++) {
+				if (word & ((uint64_t)1 << (i - start))) {
+					convert_fixed_range(env, type_id, data, i, i + 1, false, opts->nan_nil, out);
+				} else {
+					out[i] = atom_nil;
+				}
+			}
 		}
-
-		ErlNifBinary bin;
-		size_t len = strlen(buffer);
-		enif_alloc_binary(len, &bin);
-		memcpy(bin.data, buffer, len);
-		return enif_make_binary(env, &bin);
 	}
-	case DUCKDB_TYPE_INTERVAL: {
-		duckdb_interval *interval_data = (duckdb_interval *)data;
-		duckdb_interval interval = interval_data[row_idx];
+}
 
-		// Return interval as a tuple {months, days, micros}
-		ERL_NIF_TERM months = enif_make_int(env, interval.months);
-		ERL_NIF_TERM days = enif_make_int(env, interval.days);
-		ERL_NIF_TERM micros = enif_make_long(env, interval.micros);
+// Decodes every row of a chunk into tuples and conses them onto `tail`, last row first, so
+// callers can build one list across many chunks without intermediate arrays or flattening.
+// With `reversed` the first row is consed first instead, for callers that walk chunks forward
+// and reverse the whole list once at the end.
+// Column vectors and logical types are resolved once per chunk rather than once per cell.
+static ERL_NIF_TERM decode_chunk_rows(ErlNifEnv *env, duckdb_data_chunk chunk, ERL_NIF_TERM tail, bool reversed,
+                                      DecodeContext *ctx) {
+	idx_t row_count = duckdb_data_chunk_get_size(chunk);
+	idx_t column_count = duckdb_data_chunk_get_column_count(chunk);
 
-		return enif_make_tuple3(env, months, days, micros);
+	if (row_count == 0) {
+		return tail;
 	}
-	case DUCKDB_TYPE_BLOB: {
-		duckdb_string_t *blob_data = (duckdb_string_t *)data;
-		const char *blob_ptr = duckdb_string_t_data(&blob_data[row_idx]);
-		uint32_t blob_len = duckdb_string_t_length(blob_data[row_idx]);
 
-		// Return blob as binary data
-		ErlNifBinary bin;
-		enif_alloc_binary(blob_len, &bin);
-		memcpy(bin.data, blob_ptr, blob_len);
+	PROBE2(decode_start, row_count, column_count);
 
-		return enif_make_binary(env, &bin);
-	}
-	case DUCKDB_TYPE_VARCHAR: {
-		duckdb_string_t *string_data = (duckdb_string_t *)data;
-		const char *str = duckdb_string_t_data(&string_data[row_idx]);
-		uint32_t len = duckdb_string_t_length(string_data[row_idx]);
+	duckdb_vector *vectors = enif_alloc(sizeof(duckdb_vector) * column_count);
+	duckdb_logical_type *types = enif_alloc(sizeof(duckdb_logical_type) * column_count);
+	StringDict **dicts = enif_alloc(sizeof(StringDict *) * column_count);
+	ERL_NIF_TERM **decoded = enif_alloc(sizeof(ERL_NIF_TERM *) * column_count);
+	ERL_NIF_TERM *row_values = enif_alloc(sizeof(ERL_NIF_TERM) * column_count);
 
-		ErlNifBinary bin;
-		enif_alloc_binary(len, &bin);
-		memcpy(bin.data, str, len);
-		return enif_make_binary(env, &bin);
+	for (idx_t c = 0; c < column_count; c++) {
+		vectors[c] = duckdb_data_chunk_get_vector(chunk, c);
+		types[c] = duckdb_vector_get_column_type(vectors[c]);
+		duckdb_type type_id = duckdb_get_type_id(types[c]);
+		dicts[c] = NULL;
+		decoded[c] = NULL;
+		if (ctx->dicts && c < ctx->column_count && type_id == DUCKDB_TYPE_VARCHAR &&
+		    !(ctx->opts.json_decode && logical_type_is_json(types[c]))) {
+			dicts[c] = &ctx->dicts[c];
+		}
+		if (is_fixed_width_column(type_id)) {
+			decoded[c] = enif_alloc(sizeof(ERL_NIF_TERM) * row_count);
+			if (decoded[c]) {
+				decode_fixed_column(env, vectors[c], type_id, row_count, &ctx->opts, decoded[c]);
+			}
+		} else if (type_id == DUCKDB_TYPE_VARCHAR && ctx->opts.json_decode && !dicts[c]) {
+			decoded[c] = enif_alloc(sizeof(ERL_NIF_TERM) * row_count);
+			if (decoded[c]) {
+				decode_varchar_column(env, vectors[c], logical_type_is_json(types[c]), row_count, &ctx->opts,
+				                      decoded[c]);
+			}
+		} else if (ctx->opts.numeric_lists_packed) {
+			size_t width = packed_list_width(types[c]);
+			decoded[c] = width > 0 ? enif_alloc(sizeof(ERL_NIF_TERM) * row_count) : NULL;
+			if (decoded[c]) {
+				decode_packed_list_column(env, vectors[c], types[c], width, row_count, &ctx->opts, decoded[c]);
+			}
+		}
 	}
-	case DUCKDB_TYPE_LIST: {
-		// Handle LIST type
-		duckdb_list_entry *list_data = (duckdb_list_entry *)data;
-		duckdb_list_entry entry = list_data[row_idx];
 
-		// Safety check for list length
-		if (entry.length == 0) {
-			return enif_make_list(env, 0);
+	for (idx_t i = 0; i < row_count; i++) {
+		idx_t r = reversed ? i : row_count - 1 - i;
+		for (idx_t c = 0; c < column_count; c++) {
+			if (decoded[c]) {
+				row_values[c] = decoded[c][r];
+			} else if (dicts[c] && !dicts[c]->disabled) {
+				row_values[c] = decode_string_deduped(env, vectors[c], r, dicts[c]);
+			} else {
+				row_values[c] = extract_vector_value(env, vectors[c], types[c], r, &ctx->opts);
+			}
 		}
+		tail = enif_make_list_cell(env, enif_make_tuple_from_array(env, row_values, column_count), tail);
+	}
 
-		// Get child vector and type
-		duckdb_vector child_vector = duckdb_list_vector_get_child(vector);
-		if (!child_vector) {
-			return enif_make_list(env, 0);
+	for (idx_t c = 0; c < column_count; c++) {
+		duckdb_destroy_logical_type(&types[c]);
+		if (decoded[c]) {
+			enif_free(decoded[c]);
 		}
+	}
+	enif_free(row_values);
+	enif_free(decoded);
+	enif_free(dicts);
+	enif_free(types);
+	enif_free(vectors);
 
-		duckdb_logical_type child_type = duckdb_list_type_child_type(logical_type);
+	PROBE1(decode_done, row_count);
+	return tail;
+}
 
-		// Build Elixir list from DuckDB list
-		ERL_NIF_TERM *list_elements = enif_alloc(sizeof(ERL_NIF_TERM) * entry.length);
-		if (!list_elements) {
-			duckdb_destroy_logical_type(&child_type);
-			return atom_nil;
-		}
+// Decodes a single chunk into a fresh list with its own decode context
+static ERL_NIF_TERM decode_chunk_rows_with(ErlNifEnv *env, duckdb_data_chunk chunk, const DecodeOptions *opts) {
+	DecodeContext ctx;
+	decode_context_init(&ctx, opts, duckdb_data_chunk_get_column_count(chunk));
+	ERL_NIF_TERM rows = decode_chunk_rows(env, chunk, enif_make_list(env, 0), false, &ctx);
+	decode_context_free(&ctx);
+	return rows;
+}
 
-		for (idx_t i = 0; i < entry.length; i++) {
-			list_elements[i] = extract_vector_value(env, child_vector, child_type, entry.offset + i);
-		}
+static ERL_NIF_TERM data_chunk_get_data_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	DataChunkResource *chunk_res;
+	DecodeOptions opts = {0};
 
-		ERL_NIF_TERM result_list = enif_make_list_from_array(env, list_elements, entry.length);
-		enif_free(list_elements);
-		duckdb_destroy_logical_type(&child_type);
+	if (argc != 1) {
+		return enif_make_badarg(env);
+	}
 
-		return result_list;
+	if (!enif_get_resource(env, argv[0], data_chunk_resource_type, (void **)&chunk_res)) {
+		return enif_make_badarg(env);
 	}
-	case DUCKDB_TYPE_STRUCT: {
-		// Handle STRUCT type - return as a map
-		idx_t child_count = duckdb_struct_type_child_count(logical_type);
 
-		if (child_count == 0) {
-			return enif_make_new_map(env);
-		}
+	if (!chunk_res->owner) {
+		return decode_chunk_rows_with(env, chunk_res->chunk, &opts);
+	}
 
-		ERL_NIF_TERM *keys = enif_alloc(sizeof(ERL_NIF_TERM) * child_count);
-		ERL_NIF_TERM *values = enif_alloc(sizeof(ERL_NIF_TERM) * child_count);
+	if (!result_acquire(chunk_res->owner, false)) {
+		return make_error(env, result_destroyed_error);
+	}
+	ERL_NIF_TERM rows = decode_chunk_rows_with(env, chunk_res->chunk, &opts);
+	result_release(chunk_res->owner, false);
+	return rows;
+}
 
-		if (!keys || !values) {
-			if (keys)
-				enif_free(keys);
-			if (values)
-				enif_free(values);
-			return atom_nil;
-		}
+// Decodes one chunk per call, walking the result from the last chunk to the first so the final
+// list is built tail-first. Between chunks the NIF reschedules itself with the accumulated list.
+// Streaming results can only be read forward: their chunks are consumed first to last, consed
+// reversed, and the list is reversed once the stream is exhausted.
+// argv: [result, chunks_remaining, acc, decode_state, dictionary_terms]
+static ERL_NIF_TERM result_rows_chunked_step(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	ResultResource *res;
+	DecodeStateResource *state;
+	ErlNifUInt64 remaining;
 
-		for (idx_t i = 0; i < child_count; i++) {
-			// Get child name and type
-			char *child_name = duckdb_struct_type_child_name(logical_type, i);
-			if (!child_name) {
-				// Clean up and return error
-				for (idx_t j = 0; j < i; j++) {
-					// Previous iterations may have allocated memory
-				}
-				enif_free(keys);
-				enif_free(values);
-				return atom_nil;
-			}
+	if (argc != 5) {
+		return enif_make_badarg(env);
+	}
 
-			duckdb_logical_type child_type = duckdb_struct_type_child_type(logical_type, i);
-			duckdb_vector child_vector = duckdb_struct_vector_get_child(vector, i);
+	if (!enif_get_resource(env, argv[0], result_resource_type, (void **)&res)) {
+		return enif_make_badarg(env);
+	}
 
-			// Create key
-			size_t name_len = strlen(child_name);
-			ErlNifBinary name_bin;
-			enif_alloc_binary(name_len, &name_bin);
-			memcpy(name_bin.data, child_name, name_len);
-			keys[i] = enif_make_binary(env, &name_bin);
+	if (!enif_get_uint64(env, argv[1], &remaining)) {
+		return enif_make_badarg(env);
+	}
 
-			// Get value
-			values[i] = extract_vector_value(env, child_vector, child_type, row_idx);
+	if (!enif_get_resource(env, argv[3], decode_state_resource_type, (void **)&state)) {
+		return enif_make_badarg(env);
+	}
 
-			duckdb_free(child_name);
-			duckdb_destroy_logical_type(&child_type);
-		}
+	// Streaming reads move the result's cursor, everything else only reads it
+	bool exclusive = res->streaming;
+	if (!result_acquire(res, exclusive)) {
+		return make_error(env, result_destroyed_error);
+	}
 
-		// Create a map from the key-value pairs
-		ERL_NIF_TERM result_map;
-		if (enif_make_map_from_arrays(env, keys, values, child_count, &result_map) == 0) {
-			result_map = enif_make_atom(env, "struct_conversion_failed");
+	decode_context_load_terms(env, &state->ctx, argv[4]);
+
+	ERL_NIF_TERM acc = argv[2];
+	idx_t chunk_index = 0;
+
+	if (res->streaming) {
+		duckdb_data_chunk chunk = result_stream_next_chunk(res);
+		if (!chunk) {
+			const char *error_msg = duckdb_result_error(&res->result);
+			ERL_NIF_TERM out = error_msg ? make_error(env, error_msg) : acc;
+			result_release(res, exclusive);
+			if (!error_msg) {
+				enif_make_reverse_list(env, acc, &out);
+			}
+			return out;
+		}
+		acc = decode_chunk_rows(env, chunk, acc, true, &state->ctx);
+		duckdb_destroy_data_chunk(&chunk);
+		result_release(res, exclusive);
+	} else {
+		if (remaining == 0) {
+			result_release(res, exclusive);
+			return acc;
 		}
 
-		enif_free(keys);
-		enif_free(values);
+		chunk_index = (idx_t)remaining - 1;
+		if (res->buffered) {
+			acc = decode_chunk_rows(env, res->chunks[chunk_index], acc, false, &state->ctx);
+		} else {
+			duckdb_data_chunk chunk = duckdb_result_get_chunk(res->result, chunk_index);
+			if (chunk) {
+				acc = decode_chunk_rows(env, chunk, acc, false, &state->ctx);
+				duckdb_destroy_data_chunk(&chunk);
+			}
+		}
+		result_release(res, exclusive);
 
-		return result_map;
+		if (chunk_index == 0) {
+			return acc;
+		}
 	}
-	case DUCKDB_TYPE_MAP: {
-		// Handle MAP type - return as Elixir map
-		duckdb_logical_type key_type = duckdb_map_type_key_type(logical_type);
-		duckdb_logical_type value_type = duckdb_map_type_value_type(logical_type);
 
-		// Maps in DuckDB are stored as lists of {key, value} structs
-		duckdb_vector child_vector = duckdb_list_vector_get_child(vector);
-		duckdb_list_entry *list_data = (duckdb_list_entry *)data;
-		duckdb_list_entry entry = list_data[row_idx];
+	ERL_NIF_TERM next_argv[5] = {argv[0], enif_make_uint64(env, chunk_index), acc, argv[3],
+	                             decode_context_save_terms(env, &state->ctx)};
+	return enif_schedule_nif(env, "result_rows_chunked", ERL_NIF_DIRTY_JOB_CPU_BOUND, result_rows_chunked_step, 5,
+	                         next_argv);
+}
 
-		ERL_NIF_TERM *keys = enif_alloc(sizeof(ERL_NIF_TERM) * entry.length);
-		ERL_NIF_TERM *values = enif_alloc(sizeof(ERL_NIF_TERM) * entry.length);
+static ERL_NIF_TERM result_rows_chunked_start(ErlNifEnv *env, ERL_NIF_TERM result_term, const DecodeOptions *opts) {
+	ResultResource *res;
 
-		for (idx_t i = 0; i < entry.length; i++) {
-			// Get key and value vectors from the struct
-			duckdb_vector key_vector = duckdb_struct_vector_get_child(child_vector, 0);
-			duckdb_vector value_vector = duckdb_struct_vector_get_child(child_vector, 1);
+	if (!enif_get_resource(env, result_term, result_resource_type, (void **)&res)) {
+		return enif_make_badarg(env);
+	}
 
-			keys[i] = extract_vector_value(env, key_vector, key_type, entry.offset + i);
-			values[i] = extract_vector_value(env, value_vector, value_type, entry.offset + i);
-		}
+	if (!result_acquire(res, false)) {
+		return make_error(env, result_destroyed_error);
+	}
 
-		ERL_NIF_TERM result_map;
-		if (enif_make_map_from_arrays(env, keys, values, entry.length, &result_map) == 0) {
-			result_map = enif_make_atom(env, "map_conversion_failed");
-		}
+	idx_t chunk_count = 0;
+	if (res->buffered) {
+		chunk_count = res->chunk_total;
+	} else if (!res->streaming) {
+		chunk_count = duckdb_result_chunk_count(res->result);
+	}
+	idx_t column_count = duckdb_column_count(&res->result);
+	result_release(res, false);
 
-		enif_free(keys);
-		enif_free(values);
-		duckdb_destroy_logical_type(&key_type);
-		duckdb_destroy_logical_type(&value_type);
+	DecodeStateResource *state = enif_alloc_resource(decode_state_resource_type, sizeof(DecodeStateResource));
+	if (!state) {
+		return make_error(env, "Failed to allocate decode state");
+	}
+	decode_context_init(&state->ctx, opts, column_count);
+	ERL_NIF_TERM state_term = enif_make_resource(env, state);
+	enif_release_resource(state);
 
-		return result_map;
+	ERL_NIF_TERM step_argv[5] = {result_term, enif_make_uint64(env, chunk_count), enif_make_list(env, 0), state_term,
+	                             enif_make_tuple(env, 0)};
+	return result_rows_chunked_step(env, 5, step_argv);
+}
+
+// argv: [result, decode_options]
+static ERL_NIF_TERM result_rows_chunked_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	DecodeOptions opts;
+
+	if (argc != 2) {
+		return enif_make_badarg(env);
 	}
-	case DUCKDB_TYPE_UNION: {
-		// Handle UNION type - for now, return as unsupported since the API is complex
-		char buffer[64];
-		snprintf(buffer, sizeof(buffer), "unsupported_union_type_%d", (int)type_id);
-		return enif_make_atom(env, buffer);
+
+	if (!decode_options_parse(env, argv[1], &opts)) {
+		return enif_make_badarg(env);
 	}
-	default: {
-		// For unsupported types, return string representation
-		char buffer[256];
-		snprintf(buffer, sizeof(buffer), "unsupported_type_%d", (int)type_id);
-		return enif_make_atom(env, buffer);
+
+	return result_rows_chunked_start(env, argv[0], &opts);
+}
+
+// Decodes a chunk read by result_fetch_chunk. With dedup_strings the dictionaries live on the
+// result, so repeated values are matched across the whole result rather than within one chunk.
+// Reading with a different dedup_strings cutoff starts new dictionaries.
+// The caller holds the write lock.
+static ERL_NIF_TERM result_decode_fetched(ErlNifEnv *env, ResultResource *res, duckdb_data_chunk chunk,
+                                          const DecodeOptions *opts) {
+	if (res->fetch_ctx && res->fetch_ctx->opts.dedup_strings != opts->dedup_strings) {
+		decode_context_free(res->fetch_ctx);
+		enif_free(res->fetch_ctx);
+		res->fetch_ctx = NULL;
+		enif_free_env(res->dict_env);
+		res->dict_env = NULL;
+	}
+
+	if (opts->dedup_strings == 0) {
+		return decode_chunk_rows_with(env, chunk, opts);
+	}
+
+	if (!res->fetch_ctx) {
+		res->fetch_ctx = enif_alloc(sizeof(DecodeContext));
+		res->dict_env = res->fetch_ctx ? enif_alloc_env() : NULL;
+		if (!res->dict_env) {
+			enif_free(res->fetch_ctx);
+			res->fetch_ctx = NULL;
+			return decode_chunk_rows_with(env, chunk, opts);
+		}
+		decode_context_init(res->fetch_ctx, opts, duckdb_column_count(&res->result));
+		for (idx_t c = 0; res->fetch_ctx->dicts && c < res->fetch_ctx->column_count; c++) {
+			res->fetch_ctx->dicts[c].resident_env = res->dict_env;
+		}
 	}
+	res->fetch_ctx->opts = *opts;
+
+	// Terms copied into an earlier call's environment are stale in this one
+	for (idx_t c = 0; res->fetch_ctx->dicts && c < res->fetch_ctx->column_count; c++) {
+		StringDict *dict = &res->fetch_ctx->dicts[c];
+		if (++dict->generation == 0) {
+			if (dict->loaded) {
+				memset(dict->loaded, 0, sizeof(uint32_t) * dict->max_count);
+			}
+			dict->generation = 1;
+		}
 	}
+
+	return decode_chunk_rows(env, chunk, enif_make_list(env, 0), false, res->fetch_ctx);
 }
 
-// Helper function to extract problematic types robustly using result API
-static ERL_NIF_TERM data_chunk_get_data_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-	DataChunkResource *chunk_res;
+// Returns the rows of the next chunk as {:ok, rows}, or :done once every chunk was handed out.
+// Works on every kind of result; streaming results are consumed as they are read.
+// argv: [result, decode_options]
+static ERL_NIF_TERM result_fetch_chunk_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	ResultResource *res;
+	DecodeOptions opts;
 
-	if (argc != 1) {
+	if (argc != 2) {
 		return enif_make_badarg(env);
 	}
 
-	if (!enif_get_resource(env, argv[0], data_chunk_resource_type, (void **)&chunk_res)) {
+	if (!enif_get_resource(env, argv[0], result_resource_type, (void **)&res)) {
 		return enif_make_badarg(env);
 	}
 
-	duckdb_data_chunk chunk = chunk_res->chunk;
-	idx_t row_count = duckdb_data_chunk_get_size(chunk);
-	idx_t column_count = duckdb_data_chunk_get_column_count(chunk);
+	if (!decode_options_parse(env, argv[1], &opts)) {
+		return enif_make_badarg(env);
+	}
 
-	if (row_count == 0) {
-		return enif_make_list(env, 0);
+	if (!result_acquire(res, true)) {
+		return make_error(env, result_destroyed_error);
 	}
 
-	ERL_NIF_TERM *rows = enif_alloc(sizeof(ERL_NIF_TERM) * row_count);
+	ERL_NIF_TERM out;
+	if (res->buffered) {
+		if (res->cursor < res->chunk_total) {
+			out = make_ok(env, result_decode_fetched(env, res, res->chunks[res->cursor++], &opts));
+		} else {
+			out = atom_done;
+		}
+	} else {
+		duckdb_data_chunk chunk = NULL;
+		if (res->streaming) {
+			chunk = result_stream_next_chunk(res);
+		} else if (res->cursor < duckdb_result_chunk_count(res->result)) {
+			chunk = duckdb_result_get_chunk(res->result, res->cursor++);
+		}
 
-	for (idx_t r = 0; r < row_count; r++) {
-		ERL_NIF_TERM *row_values = enif_alloc(sizeof(ERL_NIF_TERM) * column_count);
+		if (chunk) {
+			out = make_ok(env, result_decode_fetched(env, res, chunk, &opts));
+			duckdb_destroy_data_chunk(&chunk);
+		} else {
+			const char *error_msg = duckdb_result_error(&res->result);
+			out = error_msg ? make_error(env, error_msg) : atom_done;
+		}
+	}
 
-		for (idx_t c = 0; c < column_count; c++) {
-			duckdb_vector vector = duckdb_data_chunk_get_vector(chunk, c);
-			duckdb_logical_type logical_type = duckdb_vector_get_column_type(vector);
+	result_release(res, true);
+	return out;
+}
 
-			row_values[c] = extract_vector_value(env, vector, logical_type, r);
+// Frees the DuckDB memory behind a result right away instead of waiting for garbage collection.
+// Chunks taken from the result stay valid terms but can no longer be read.
+static ERL_NIF_TERM result_destroy_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	ResultResource *res;
 
-			duckdb_destroy_logical_type(&logical_type);
-		}
+	if (argc != 1) {
+		return enif_make_badarg(env);
+	}
 
-		rows[r] = enif_make_tuple_from_array(env, row_values, column_count);
-		enif_free(row_values);
+	if (!enif_get_resource(env, argv[0], result_resource_type, (void **)&res)) {
+		return enif_make_badarg(env);
 	}
 
-	ERL_NIF_TERM result = enif_make_list_from_array(env, rows, row_count);
-	enif_free(rows);
-	return result;
+	enif_rwlock_rwlock(res->lock);
+	result_resource_free_data(res);
+	enif_rwlock_rwunlock(res->lock);
+
+	return atom_ok;
 }
 
 // Transaction Management Functions
@@ -1951,8 +4756,13 @@ static ERL_NIF_TERM connection_begin_transaction_nif(ErlNifEnv *env, int argc, c
 	}
 
 	// Execute BEGIN TRANSACTION
+	if (!connection_acquire(conn_res)) {
+		return make_error(env, connection_closed_error);
+	}
+
 	duckdb_result result;
 	duckdb_state state = duckdb_query(conn_res->conn, "BEGIN TRANSACTION", &result);
+	connection_release(conn_res);
 
 	if (state == DuckDBError) {
 		const char *error_msg = duckdb_result_error(&result);
@@ -1977,8 +4787,13 @@ static ERL_NIF_TERM connection_commit_nif(ErlNifEnv *env, int argc, const ERL_NI
 	}
 
 	// Execute COMMIT
+	if (!connection_acquire(conn_res)) {
+		return make_error(env, connection_closed_error);
+	}
+
 	duckdb_result result;
 	duckdb_state state = duckdb_query(conn_res->conn, "COMMIT", &result);
+	connection_release(conn_res);
 
 	if (state == DuckDBError) {
 		const char *error_msg = duckdb_result_error(&result);
@@ -2003,8 +4818,13 @@ static ERL_NIF_TERM connection_rollback_nif(ErlNifEnv *env, int argc, const ERL_
 	}
 
 	// Execute ROLLBACK
+	if (!connection_acquire(conn_res)) {
+		return make_error(env, connection_closed_error);
+	}
+
 	duckdb_result result;
 	duckdb_state state = duckdb_query(conn_res->conn, "ROLLBACK", &result);
+	connection_release(conn_res);
 
 	if (state == DuckDBError) {
 		const char *error_msg = duckdb_result_error(&result);
@@ -2017,6 +4837,33 @@ static ERL_NIF_TERM connection_rollback_nif(ErlNifEnv *env, int argc, const ERL_
 	return atom_ok;
 }
 
+// Progress of the query running on the connection as {percentage, rows_processed,
+// total_rows}; the percentage is -1 when none is running or progress is not tracked.
+// Not a dirty NIF, so it can be polled while a dirty NIF runs a query on the connection.
+static ERL_NIF_TERM connection_query_progress_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	ConnectionResource *conn_res;
+
+	if (argc != 1) {
+		return enif_make_badarg(env);
+	}
+
+	if (!enif_get_resource(env, argv[0], connection_resource_type, (void **)&conn_res)) {
+		return enif_make_badarg(env);
+	}
+
+	// Never blocks: a close in progress reads as no query running
+	duckdb_query_progress_type progress = {-1, 0, 0};
+	if (enif_rwlock_tryrlock(conn_res->lock) == 0) {
+		if (conn_res->conn) {
+			progress = duckdb_query_progress(conn_res->conn);
+		}
+		enif_rwlock_runlock(conn_res->lock);
+	}
+	return make_ok(env, enif_make_tuple3(env, enif_make_double(env, progress.percentage),
+	                                     enif_make_uint64(env, progress.rows_processed),
+	                                     enif_make_uint64(env, progress.total_rows_to_process)));
+}
+
 //===--------------------------------------------------------------------===//
 // Appender Operations
 //===--------------------------------------------------------------------===//
@@ -2072,13 +4919,19 @@ static ERL_NIF_TERM appender_create_nif(ErlNifEnv *env, int argc, const ERL_NIF_
 		}
 	}
 
+	if (!connection_acquire(conn_res)) {
+		return make_error(env, connection_closed_error);
+	}
+
 	AppenderResource *appender_res =
 	    (AppenderResource *)enif_alloc_resource(appender_resource_type, sizeof(AppenderResource));
 	if (!appender_res) {
+		connection_release(conn_res);
 		return make_error(env, "Failed to allocate appender resource");
 	}
 
 	duckdb_state state = duckdb_appender_create(conn_res->conn, schema_ptr, table, &appender_res->appender);
+	connection_release(conn_res);
 
 	if (state == DuckDBError) {
 		const char *error_msg = duckdb_appender_error(appender_res->appender);
@@ -2167,14 +5020,20 @@ static ERL_NIF_TERM appender_create_ext_nif(ErlNifEnv *env, int argc, const ERL_
 		}
 	}
 
+	if (!connection_acquire(conn_res)) {
+		return make_error(env, connection_closed_error);
+	}
+
 	AppenderResource *appender_res =
 	    (AppenderResource *)enif_alloc_resource(appender_resource_type, sizeof(AppenderResource));
 	if (!appender_res) {
+		connection_release(conn_res);
 		return make_error(env, "Failed to allocate appender resource");
 	}
 
 	duckdb_state state =
 	    duckdb_appender_create_ext(conn_res->conn, catalog_ptr, schema_ptr, table, &appender_res->appender);
+	connection_release(conn_res);
 
 	if (state == DuckDBError) {
 		const char *error_msg = duckdb_appender_error(appender_res->appender);
@@ -2203,6 +5062,38 @@ static ERL_NIF_TERM appender_column_count_nif(ErlNifEnv *env, int argc, const ER
 	return enif_make_ulong(env, column_count);
 }
 
+// Restricts the appender to the named columns, in the order they are added, flushing what was
+// appended so far. Rows then hold one value per added column and the other columns receive
+// their defaults.
+static ERL_NIF_TERM appender_add_column_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	AppenderResource *appender_res;
+	ErlNifBinary name_bin;
+
+	if (argc != 2) {
+		return enif_make_badarg(env);
+	}
+
+	if (!enif_get_resource(env, argv[0], appender_resource_type, (void **)&appender_res) ||
+	    !enif_inspect_binary(env, argv[1], &name_bin)) {
+		return enif_make_badarg(env);
+	}
+
+	char *name = binary_to_cstring(&name_bin);
+	if (!name) {
+		return make_error(env, "Failed to allocate memory for column name");
+	}
+
+	duckdb_state state = duckdb_appender_add_column(appender_res->appender, name);
+	enif_free(name);
+
+	if (state == DuckDBError) {
+		const char *error_msg = duckdb_appender_error(appender_res->appender);
+		return make_error(env, error_msg ? error_msg : "Unknown appender column error");
+	}
+
+	return atom_ok;
+}
+
 static ERL_NIF_TERM appender_flush_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
 	AppenderResource *appender_res;
 
@@ -2214,7 +5105,9 @@ static ERL_NIF_TERM appender_flush_nif(ErlNifEnv *env, int argc, const ERL_NIF_T
 		return enif_make_badarg(env);
 	}
 
+	PROBE0(flush_start);
 	duckdb_state state = duckdb_appender_flush(appender_res->appender);
+	PROBE1(flush_done, state == DuckDBSuccess);
 
 	if (state == DuckDBError) {
 		const char *error_msg = duckdb_appender_error(appender_res->appender);
@@ -2235,7 +5128,9 @@ static ERL_NIF_TERM appender_close_nif(ErlNifEnv *env, int argc, const ERL_NIF_T
 		return enif_make_badarg(env);
 	}
 
+	PROBE0(flush_start);
 	duckdb_state state = duckdb_appender_close(appender_res->appender);
+	PROBE1(flush_done, state == DuckDBSuccess);
 
 	if (state == DuckDBError) {
 		const char *error_msg = duckdb_appender_error(appender_res->appender);
@@ -2280,6 +5175,7 @@ static ERL_NIF_TERM appender_end_row_nif(ErlNifEnv *env, int argc, const ERL_NIF
 	}
 
 	duckdb_state state = duckdb_appender_end_row(appender_res->appender);
+	PROBE1(append_row_done, state == DuckDBSuccess);
 
 	if (state == DuckDBError) {
 		const char *error_msg = duckdb_appender_error(appender_res->appender);
@@ -2616,23 +5512,17 @@ static ERL_NIF_TERM appender_append_varchar_nif(ErlNifEnv *env, int argc, const
 		return enif_make_badarg(env);
 	}
 
-	// Handle varchar (string or binary)
-	if (!enif_get_string(env, argv[1], value, sizeof(value), ERL_NIF_LATIN1)) {
-		// Try as binary
-		ErlNifBinary value_bin;
-		if (enif_inspect_binary(env, argv[1], &value_bin)) {
-			if (value_bin.size >= sizeof(value)) {
-				return enif_make_badarg(env);
-			}
-			memcpy(value, value_bin.data, value_bin.size);
-			value[value_bin.size] = '\0';
-		} else {
-			return enif_make_badarg(env);
-		}
+	// Binaries of any size are appended in place, charlists go through the local buffer
+	duckdb_state state;
+	ErlNifBinary value_bin;
+	if (enif_inspect_binary(env, argv[1], &value_bin)) {
+		state = duckdb_append_varchar_length(appender_res->appender, (const char *)value_bin.data, value_bin.size);
+	} else if (enif_get_string(env, argv[1], value, sizeof(value), ERL_NIF_LATIN1)) {
+		state = duckdb_append_varchar(appender_res->appender, value);
+	} else {
+		return enif_make_badarg(env);
 	}
 
-	duckdb_state state = duckdb_append_varchar(appender_res->appender, value);
-
 	if (state == DuckDBError) {
 		const char *error_msg = duckdb_appender_error(appender_res->appender);
 		return make_error(env, error_msg ? error_msg : "Unknown appender append error");
@@ -2667,6 +5557,367 @@ static ERL_NIF_TERM appender_append_blob_nif(ErlNifEnv *env, int argc, const ERL
 	return atom_ok;
 }
 
+// Growable text buffer for the JSON encoder
+typedef struct {
+	char *data;
+	size_t len;
+	size_t cap;
+} JsonBuffer;
+
+static bool json_buffer_reserve(JsonBuffer *buf, size_t extra) {
+	if (buf->len + extra <= buf->cap) {
+		return true;
+	}
+	size_t cap = buf->cap ? buf->cap : 256;
+	while (cap < buf->len + extra) {
+		cap *= 2;
+	}
+	char *data = enif_realloc(buf->data, cap);
+	if (!data) {
+		return false;
+	}
+	buf->data = data;
+	buf->cap = cap;
+	return true;
+}
+
+static bool json_buffer_append(JsonBuffer *buf, const char *text, size_t len) {
+	if (!json_buffer_reserve(buf, len)) {
+		return false;
+	}
+	memcpy(buf->data + buf->len, text, len);
+	buf->len += len;
+	return true;
+}
+
+static bool json_encode_string(JsonBuffer *buf, const unsigned char *text, size_t len) {
+	// Worst case every byte becomes a \u00XX escape
+	if (!json_buffer_reserve(buf, len * 6 + 2)) {
+		return false;
+	}
+	char *out = buf->data + buf->len;
+	*out++ = '"';
+	for (size_t i = 0; i < len; i++) {
+		unsigned char c = text[i];
+		switch (c) {
+		case '"':
+			*out++ = '\\';
+			*out++ = '"';
+			break;
+		case '\\':
+			*out++ = '\\';
+			*out++ = '\\';
+			break;
+		case '\n':
+			*out++ = '\\';
+			*out++ = 'n';
+			break;
+		case '\r':
+			*out++ = '\\';
+			*out++ = 'r';
+			break;
+		case '\t':
+			*out++ = '\\';
+			*out++ = 't';
+			break;
+		default:
+			if (c < 0x20) {
+				out += snprintf(out, 7, "\\u%04x", c);
+			} else {
+				*out++ = (char)c;
+			}
+		}
+	}
+	*out++ = '"';
+	buf->len = (size_t)(out - buf->data);
+	return true;
+}
+
+// Writes an atom as a JSON string, or as a literal for nil, null, true and false outside of
+// object keys. Names are at most 255 characters, so 4 bytes each in UTF-8.
+static const char *json_encode_atom(ErlNifEnv *env, ERL_NIF_TERM atom, JsonBuffer *buf, bool is_key) {
+	char text[4 * 255 + 1];
+	unsigned len;
+
+	if (!enif_get_atom_length(env, atom, &len, ERL_NIF_UTF8) || len >= sizeof(text) ||
+	    enif_get_atom(env, atom, text, sizeof(text), ERL_NIF_UTF8) != (int)len + 1) {
+		return "atom name cannot be encoded as JSON";
+	}
+	if (!is_key && (strcmp(text, "nil") == 0 || strcmp(text, "null") == 0)) {
+		return json_buffer_append(buf, "null", 4) ? NULL : "out of memory";
+	}
+	if (!is_key && (strcmp(text, "true") == 0 || strcmp(text, "false") == 0)) {
+		return json_buffer_append(buf, text, len) ? NULL : "out of memory";
+	}
+	return json_encode_string(buf, (const unsigned char *)text, len) ? NULL : "out of memory";
+}
+
+// Encodes maps, lists, binaries, numbers, booleans and nil. Returns the reason on failure.
+static const char *json_encode_term(ErlNifEnv *env, ERL_NIF_TERM term, JsonBuffer *buf, int depth) {
+	ErlNifBinary bin;
+	ErlNifSInt64 i64;
+	ErlNifUInt64 u64;
+	double dbl;
+	char scratch[256];
+
+	if (depth > JSON_MAX_DEPTH) {
+		return "JSON value is nested too deeply";
+	}
+
+	if (enif_is_binary(env, term)) {
+		enif_inspect_binary(env, term, &bin);
+		return json_encode_string(buf, bin.data, bin.size) ? NULL : "out of memory";
+	}
+
+	if (enif_get_int64(env, term, &i64)) {
+		int n = snprintf(scratch, sizeof(scratch), "%lld", (long long)i64);
+		return json_buffer_append(buf, scratch, (size_t)n) ? NULL : "out of memory";
+	}
+
+	if (enif_get_uint64(env, term, &u64)) {
+		int n = snprintf(scratch, sizeof(scratch), "%llu", (unsigned long long)u64);
+		return json_buffer_append(buf, scratch, (size_t)n) ? NULL : "out of memory";
+	}
+
+	if (enif_get_double(env, term, &dbl)) {
+		// Shortest precision that reads back as the same double
+		int n = 0;
+		for (int precision = 15; precision <= 17; precision++) {
+			n = snprintf(scratch, sizeof(scratch), "%.*g", precision, dbl);
+			if (strtod(scratch, NULL) == dbl) {
+				break;
+			}
+		}
+		return json_buffer_append(buf, scratch, (size_t)n) ? NULL : "out of memory";
+	}
+
+	if (enif_is_number(env, term)) {
+		return "integer does not fit in 64 bits";
+	}
+
+	if (enif_is_atom(env, term)) {
+		return json_encode_atom(env, term, buf, false);
+	}
+
+	if (enif_is_list(env, term)) {
+		ERL_NIF_TERM head;
+		bool first = true;
+		if (!json_buffer_append(buf, "[", 1)) {
+			return "out of memory";
+		}
+		while (enif_get_list_cell(env, term, &head, &term)) {
+			if (!first && !json_buffer_append(buf, ",", 1)) {
+				return "out of memory";
+			}
+			const char *error = json_encode_term(env, head, buf, depth + 1);
+			if (error) {
+				return error;
+			}
+			first = false;
+		}
+		if (!enif_is_empty_list(env, term)) {
+			return "improper lists cannot be encoded as JSON";
+		}
+		return json_buffer_append(buf, "]", 1) ? NULL : "out of memory";
+	}
+
+	if (enif_is_map(env, term)) {
+		ErlNifMapIterator iter;
+		ERL_NIF_TERM key;
+		ERL_NIF_TERM value;
+		bool first = true;
+		const char *error = NULL;
+
+		if (enif_get_map_value(env, term, atom_struct_key, &value)) {
+			return "structs cannot be encoded as JSON";
+		}
+		if (!json_buffer_append(buf, "{", 1)) {
+			return "out of memory";
+		}
+		enif_map_iterator_create(env, term, &iter, ERL_NIF_MAP_ITERATOR_FIRST);
+		while (!error && enif_map_iterator_get_pair(env, &iter, &key, &value)) {
+			if (!first && !json_buffer_append(buf, ",", 1)) {
+				error = "out of memory";
+				break;
+			}
+			// Object keys are always strings; atom and integer keys are written as their text
+			if (enif_is_atom(env, key)) {
+				error = json_encode_atom(env, key, buf, true);
+			} else if (enif_is_binary(env, key)) {
+				enif_inspect_binary(env, key, &bin);
+				if (!json_encode_string(buf, bin.data, bin.size)) {
+					error = "out of memory";
+				}
+			} else if (enif_get_int64(env, key, &i64)) {
+				int n = snprintf(scratch, sizeof(scratch), "\"%lld\"", (long long)i64);
+				if (!json_buffer_append(buf, scratch, (size_t)n)) {
+					error = "out of memory";
+				}
+			} else {
+				error = "map keys must be strings, atoms or integers to encode as JSON";
+			}
+			if (!error && !json_buffer_append(buf, ":", 1)) {
+				error = "out of memory";
+			}
+			if (!error) {
+				error = json_encode_term(env, value, buf, depth + 1);
+			}
+			first = false;
+			enif_map_iterator_next(env, &iter);
+		}
+		enif_map_iterator_destroy(env, &iter);
+		if (error) {
+			return error;
+		}
+		return json_buffer_append(buf, "}", 1) ? NULL : "out of memory";
+	}
+
+	return "value cannot be encoded as JSON";
+}
+
+static ERL_NIF_TERM appender_append_json_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	AppenderResource *appender_res;
+	JsonBuffer buf = {NULL, 0, 0};
+
+	if (argc != 2) {
+		return enif_make_badarg(env);
+	}
+
+	if (!enif_get_resource(env, argv[0], appender_resource_type, (void **)&appender_res)) {
+		return enif_make_badarg(env);
+	}
+
+	const char *error = json_encode_term(env, argv[1], &buf, 0);
+	if (error) {
+		enif_free(buf.data);
+		return make_error(env, error);
+	}
+
+	duckdb_state state = duckdb_append_varchar_length(appender_res->appender, buf.data, buf.len);
+	enif_free(buf.data);
+
+	if (state == DuckDBError) {
+		const char *error_msg = duckdb_appender_error(appender_res->appender);
+		return make_error(env, error_msg ? error_msg : "Unknown appender append error");
+	}
+
+	return atom_ok;
+}
+
+// Appends whole columns given as packed native-endian binaries, one per appender column.
+// Numeric columns hold one value per row, numeric ARRAY columns (e.g. FLOAT[384]
+// embeddings) their fixed number of elements per row. Rows are copied into data chunks
+// and appended a vector at a time instead of value by value.
+static ERL_NIF_TERM appender_append_columns_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	AppenderResource *appender_res;
+	unsigned int list_length;
+
+	if (argc != 2) {
+		return enif_make_badarg(env);
+	}
+
+	if (!enif_get_resource(env, argv[0], appender_resource_type, (void **)&appender_res) ||
+	    !enif_get_list_length(env, argv[1], &list_length)) {
+		return enif_make_badarg(env);
+	}
+
+	idx_t column_count = duckdb_appender_column_count(appender_res->appender);
+	if (list_length != column_count || column_count == 0) {
+		return make_error(env, "Expected one binary per appender column");
+	}
+
+	duckdb_logical_type *types = enif_alloc(column_count * sizeof(duckdb_logical_type));
+	ErlNifBinary *columns = enif_alloc(column_count * sizeof(ErlNifBinary));
+	size_t *row_widths = enif_alloc(column_count * sizeof(size_t));
+	bool *is_array = enif_alloc(column_count * sizeof(bool));
+	if (!types || !columns || !row_widths || !is_array) {
+		enif_free(types);
+		enif_free(columns);
+		enif_free(row_widths);
+		enif_free(is_array);
+		return make_error(env, "Failed to allocate memory for columns");
+	}
+
+	const char *error = NULL;
+	idx_t typed = 0;
+	size_t rows = 0;
+	ERL_NIF_TERM list = argv[1], head;
+	for (idx_t c = 0; c < column_count && !error; c++) {
+		enif_get_list_cell(env, list, &head, &list);
+		types[c] = duckdb_appender_column_type(appender_res->appender, c);
+		typed++;
+
+		duckdb_type type_id = duckdb_get_type_id(types[c]);
+		is_array[c] = type_id == DUCKDB_TYPE_ARRAY;
+		if (is_array[c]) {
+			duckdb_logical_type child = duckdb_array_type_child_type(types[c]);
+			row_widths[c] =
+			    packed_numeric_width(duckdb_get_type_id(child)) * duckdb_array_type_array_size(types[c]);
+			duckdb_destroy_logical_type(&child);
+		} else {
+			row_widths[c] = packed_numeric_width(type_id);
+		}
+
+		if (row_widths[c] == 0) {
+			error = "Only numeric and numeric ARRAY columns can be appended as packed binaries";
+		} else if (!enif_inspect_binary(env, head, &columns[c]) || columns[c].size % row_widths[c] != 0) {
+			error = "Column binary size is not a multiple of the column's row width";
+		} else if (c > 0 && columns[c].size / row_widths[c] != rows) {
+			error = "All column binaries must hold the same number of rows";
+		} else {
+			rows = columns[c].size / row_widths[c];
+		}
+	}
+
+	duckdb_data_chunk chunk = error ? NULL : duckdb_create_data_chunk(types, column_count);
+	if (!error && !chunk) {
+		error = "Failed to allocate data chunk";
+	}
+
+	if (!error) {
+		PROBE2(append_batch_start, rows, column_count);
+	}
+
+	idx_t capacity = duckdb_vector_size();
+	for (size_t offset = 0; !error && offset < rows; offset += capacity) {
+		idx_t count = rows - offset < capacity ? rows - offset : capacity;
+		duckdb_data_chunk_reset(chunk);
+		for (idx_t c = 0; c < column_count; c++) {
+			duckdb_vector vector = duckdb_data_chunk_get_vector(chunk, c);
+			if (is_array[c]) {
+				vector = duckdb_array_vector_get_child(vector);
+			}
+			memcpy(duckdb_vector_get_data(vector), columns[c].data + offset * row_widths[c], count * row_widths[c]);
+		}
+		duckdb_data_chunk_set_size(chunk, count);
+
+		if (duckdb_append_data_chunk(appender_res->appender, chunk) == DuckDBError) {
+			const char *error_msg = duckdb_appender_error(appender_res->appender);
+			error = error_msg ? error_msg : "Unknown appender append error";
+		}
+	}
+
+	if (chunk) {
+		PROBE1(append_batch_done, error == NULL);
+	}
+
+	// The appender error message stays valid until the next append, so the error term is
+	// built before anything else touches the appender
+	ERL_NIF_TERM reply = error ? make_error(env, error) : atom_ok;
+
+	if (chunk) {
+		duckdb_destroy_data_chunk(&chunk);
+	}
+	for (idx_t c = 0; c < typed; c++) {
+		duckdb_destroy_logical_type(&types[c]);
+	}
+	enif_free(types);
+	enif_free(columns);
+	enif_free(row_widths);
+	enif_free(is_array);
+	return reply;
+}
+
 static ERL_NIF_TERM appender_append_null_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
 	AppenderResource *appender_res;
 
@@ -2688,6 +5939,175 @@ static ERL_NIF_TERM appender_append_null_nif(ErlNifEnv *env, int argc, const ERL
 	return atom_ok;
 }
 
+// Copies a k-NN result (BIGINT ids, FLOAT or DOUBLE distances) into packed native-endian
+// binaries. Returns an error message or NULL.
+static const char *vss_pack_result(duckdb_result *result, ErlNifBinary *ids, ErlNifBinary *distances) {
+	if (duckdb_column_count(result) != 2 || duckdb_column_type(result, 0) != DUCKDB_TYPE_BIGINT) {
+		return "search query must return a BIGINT id and a distance";
+	}
+	duckdb_type distance_type = duckdb_column_type(result, 1);
+	if (distance_type != DUCKDB_TYPE_FLOAT && distance_type != DUCKDB_TYPE_DOUBLE) {
+		return "search distances must be FLOAT or DOUBLE";
+	}
+
+	size_t rows = 0;
+	duckdb_data_chunk chunk;
+	while ((chunk = duckdb_fetch_chunk(*result)) != NULL) {
+		idx_t size = duckdb_data_chunk_get_size(chunk);
+		if (size == 0) {
+			duckdb_destroy_data_chunk(&chunk);
+			break;
+		}
+		if (!enif_realloc_binary(ids, (rows + size) * sizeof(int64_t)) ||
+		    !enif_realloc_binary(distances, (rows + size) * sizeof(float))) {
+			duckdb_destroy_data_chunk(&chunk);
+			return "out of memory";
+		}
+
+		duckdb_vector id_vector = duckdb_data_chunk_get_vector(chunk, 0);
+		duckdb_vector distance_vector = duckdb_data_chunk_get_vector(chunk, 1);
+		int64_t *id_data = (int64_t *)duckdb_vector_get_data(id_vector);
+		void *distance_data = duckdb_vector_get_data(distance_vector);
+		uint64_t *id_validity = duckdb_vector_get_validity(id_vector);
+		uint64_t *distance_validity = duckdb_vector_get_validity(distance_vector);
+		int64_t *id_out = (int64_t *)(ids->data + rows * sizeof(int64_t));
+		float *out = (float *)(distances->data + rows * sizeof(float));
+
+		if (!id_validity && !distance_validity) {
+			memcpy(id_out, id_data, size * sizeof(int64_t));
+			if (distance_type == DUCKDB_TYPE_FLOAT) {
+				memcpy(out, distance_data, size * sizeof(float));
+			} else {
+				for (idx_t i = 0; i < size; i++) {
+					out[i] = (float)((double *)distance_data)[i];
+				}
+			}
+			rows += size;
+		} else {
+			// Rows with a NULL id or distance (e.g. a NULL embedding) are left out
+			idx_t kept = 0;
+			for (idx_t i = 0; i < size; i++) {
+				if ((id_validity && !duckdb_validity_row_is_valid(id_validity, i)) ||
+				    (distance_validity && !duckdb_validity_row_is_valid(distance_validity, i))) {
+					continue;
+				}
+				id_out[kept] = id_data[i];
+				out[kept] = distance_type == DUCKDB_TYPE_FLOAT ? ((float *)distance_data)[i]
+				                                               : (float)((double *)distance_data)[i];
+				kept++;
+			}
+			rows += kept;
+		}
+		duckdb_destroy_data_chunk(&chunk);
+	}
+
+	if (ids->size != rows * sizeof(int64_t) &&
+	    (!enif_realloc_binary(ids, rows * sizeof(int64_t)) ||
+	     !enif_realloc_binary(distances, rows * sizeof(float)))) {
+		return "out of memory";
+	}
+	return NULL;
+}
+
+// Runs `prefix <vector> suffix` once per query vector of `dim` packed floats and returns a
+// list of {ids, distances} binaries. Each vector is rendered as a FLOAT[dim] literal rather
+// than bound as a parameter, because the HNSW index is only used for constant query vectors.
+static ERL_NIF_TERM connection_vss_search_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+	ConnectionResource *conn_res;
+	ErlNifBinary prefix, suffix, vectors;
+	unsigned int dim;
+
+	if (argc != 5) {
+		return enif_make_badarg(env);
+	}
+
+	if (!enif_get_resource(env, argv[0], connection_resource_type, (void **)&conn_res) ||
+	    !enif_inspect_binary(env, argv[1], &prefix) || !enif_inspect_binary(env, argv[2], &suffix) ||
+	    !enif_inspect_binary(env, argv[3], &vectors) || !enif_get_uint(env, argv[4], &dim) || dim == 0 ||
+	    vectors.size % (dim * sizeof(float)) != 0) {
+		return enif_make_badarg(env);
+	}
+
+	size_t count = vectors.size / (dim * sizeof(float));
+	// "%.9g" round-trips a float in at most 15 characters, plus the separator
+	size_t capacity = prefix.size + suffix.size + (size_t)dim * 17 + 32;
+	char *sql = enif_alloc(capacity);
+	ERL_NIF_TERM *entries = enif_alloc((count > 0 ? count : 1) * sizeof(ERL_NIF_TERM));
+	if (!sql || !entries) {
+		enif_free(sql);
+		enif_free(entries);
+		return make_error(env, "Failed to allocate memory for search");
+	}
+
+	const char *error = NULL;
+	ERL_NIF_TERM error_term = 0;
+	for (size_t q = 0; q < count && !error && !error_term; q++) {
+		float value;
+		size_t len = prefix.size;
+		memcpy(sql, prefix.data, prefix.size);
+		sql[len++] = '[';
+		for (unsigned int i = 0; i < dim; i++) {
+			memcpy(&value, vectors.data + (q * dim + i) * sizeof(float), sizeof(float));
+			if (!isfinite(value)) {
+				error = "query vectors must be finite";
+				break;
+			}
+			len += (size_t)snprintf(sql + len, capacity - len, i ? ",%.9g" : "%.9g", (double)value);
+		}
+		if (error) {
+			break;
+		}
+		len += (size_t)snprintf(sql + len, capacity - len, "]::FLOAT[%u]", dim);
+		memcpy(sql + len, suffix.data, suffix.size);
+		sql[len + suffix.size] = '\0';
+
+		if (!connection_acquire(conn_res)) {
+			error = connection_closed_error;
+			break;
+		}
+		duckdb_result result;
+		duckdb_state state = duckdb_query(conn_res->conn, sql, &result);
+		connection_release(conn_res);
+		if (state == DuckDBError) {
+			const char *error_msg = duckdb_result_error(&result);
+			error_term = make_error(env, error_msg ? error_msg : "Search query failed");
+			duckdb_destroy_result(&result);
+			break;
+		}
+
+		ErlNifBinary ids, distances;
+		if (!enif_alloc_binary(0, &ids)) {
+			duckdb_destroy_result(&result);
+			error = "out of memory";
+			break;
+		}
+		if (!enif_alloc_binary(0, &distances)) {
+			enif_release_binary(&ids);
+			duckdb_destroy_result(&result);
+			error = "out of memory";
+			break;
+		}
+		error = vss_pack_result(&result, &ids, &distances);
+		duckdb_destroy_result(&result);
+		if (error) {
+			enif_release_binary(&ids);
+			enif_release_binary(&distances);
+			break;
+		}
+		entries[q] = enif_make_tuple2(env, enif_make_binary(env, &ids), enif_make_binary(env, &distances));
+	}
+	enif_free(sql);
+
+	if (error || error_term) {
+		enif_free(entries);
+		return error_term ? error_term : make_error(env, error);
+	}
+
+	ERL_NIF_TERM list = enif_make_list_from_array(env, entries, (unsigned)count);
+	enif_free(entries);
+	return make_ok(env, list);
+}
+
 // NIF function array
 static ErlNifFunc nif_funcs[] = {
     {"database_open", 1, database_open_nif, ERL_NIF_DIRTY_JOB_IO_BOUND},
@@ -2695,22 +6115,34 @@ static ErlNifFunc nif_funcs[] = {
     {"config_create", 0, config_create_nif, 0},
     {"config_set", 3, config_set_nif, 0},
     {"connection_open", 1, connection_open_nif, ERL_NIF_DIRTY_JOB_IO_BOUND},
+    {"database_close", 1, database_close_nif, ERL_NIF_DIRTY_JOB_IO_BOUND},
+    {"connection_close", 1, connection_close_nif, ERL_NIF_DIRTY_JOB_IO_BOUND},
     {"connection_query", 2, connection_query_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+    {"connection_query_bounded", 6, connection_query_bounded_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
     {"prepared_statement_prepare", 2, prepared_statement_prepare_nif, ERL_NIF_DIRTY_JOB_IO_BOUND},
     {"prepared_statement_execute", 2, prepared_statement_execute_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+    {"prepared_statement_execute_stream", 3, prepared_statement_execute_stream_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+    {"prepared_statement_describe", 1, prepared_statement_describe_nif, 0},
     {"result_columns", 1, result_columns_nif, 0},
+    {"result_columns_full", 1, result_columns_full_nif, 0},
     {"result_rows", 1, result_rows_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
     {"result_row_count", 1, result_row_count_nif, 0},
     {"result_column_count", 1, result_column_count_nif, 0},
     {"result_chunk_count", 1, result_chunk_count_nif, 0},
     {"result_get_chunk", 2, result_get_chunk_nif, 0},
     {"data_chunk_get_data", 1, data_chunk_get_data_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+    {"result_rows_chunked", 2, result_rows_chunked_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+    {"result_fetch_chunk", 2, result_fetch_chunk_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+    {"result_destroy", 1, result_destroy_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
     {"connection_begin_transaction", 1, connection_begin_transaction_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
     {"connection_commit", 1, connection_commit_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
     {"connection_rollback", 1, connection_rollback_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+    {"connection_vss_search", 5, connection_vss_search_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+    {"connection_query_progress", 1, connection_query_progress_nif, 0},
     {"appender_create", 3, appender_create_nif, ERL_NIF_DIRTY_JOB_IO_BOUND},
     {"appender_create_ext", 4, appender_create_ext_nif, ERL_NIF_DIRTY_JOB_IO_BOUND},
     {"appender_column_count", 1, appender_column_count_nif, 0},
+    {"appender_add_column", 2, appender_add_column_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
     {"appender_flush", 1, appender_flush_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
     {"appender_close", 1, appender_close_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
     {"appender_destroy", 1, appender_destroy_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
@@ -2728,10 +6160,14 @@ static ErlNifFunc nif_funcs[] = {
     {"appender_append_double", 2, appender_append_double_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
     {"appender_append_varchar", 2, appender_append_varchar_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
     {"appender_append_blob", 2, appender_append_blob_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+    {"appender_append_json", 2, appender_append_json_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+    {"appender_append_columns", 2, appender_append_columns_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
     {"appender_append_null", 1, appender_append_null_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND}};
 
 // Module initialization
 static int load(ErlNifEnv *env, void **priv_data, ERL_NIF_TERM load_info) {
+	decode_kernels_init();
+
 	// Create resource types
 	database_resource_type = enif_open_resource_type(env, NULL, "database_resource", database_resource_destructor,
 	                                                 ERL_NIF_RT_CREATE | ERL_NIF_RT_TAKEOVER, NULL);
@@ -2761,11 +6197,67 @@ static int load(ErlNifEnv *env, void **priv_data, ERL_NIF_TERM load_info) {
 		return -1;
 	}
 
+	decode_state_resource_type = enif_open_resource_type(
+	    env, NULL, "decode_state_resource", decode_state_resource_destructor, ERL_NIF_RT_CREATE | ERL_NIF_RT_TAKEOVER, NULL);
+	if (!decode_state_resource_type) {
+		return -1;
+	}
+
 	// Initialize atoms
 	atom_ok = enif_make_atom(env, "ok");
 	atom_error = enif_make_atom(env, "error");
 	atom_nil = enif_make_atom(env, "nil");
 	atom_memory = enif_make_atom(env, "memory");
+	atom_done = enif_make_atom(env, "done");
+	atom_stream = enif_make_atom(env, "stream");
+	atom_limit_exceeded = enif_make_atom(env, "limit_exceeded");
+	atom_spill = enif_make_atom(env, "spill");
+	atom_dedup_strings = enif_make_atom(env, "dedup_strings");
+	atom_raw = enif_make_atom(env, "raw");
+	atom_string = enif_make_atom(env, "string");
+	atom_temporal = enif_make_atom(env, "temporal");
+	atom_native = enif_make_atom(env, "native");
+	atom_numeric_lists = enif_make_atom(env, "numeric_lists");
+	atom_nan = enif_make_atom(env, "nan");
+	atom_infinity = enif_make_atom(env, "infinity");
+	atom_negative_infinity = enif_make_atom(env, "negative_infinity");
+	atom_atom = enif_make_atom(env, "atom");
+	atom_packed = enif_make_atom(env, "packed");
+	atom_json = enif_make_atom(env, "json");
+	atom_json_keys = enif_make_atom(env, "json_keys");
+	atom_decode = enif_make_atom(env, "decode");
+	atom_struct_key = enif_make_atom(env, "__struct__");
+	atom_date_module = enif_make_atom(env, "Elixir.Date");
+	atom_time_module = enif_make_atom(env, "Elixir.Time");
+	atom_datetime_module = enif_make_atom(env, "Elixir.DateTime");
+	atom_calendar = enif_make_atom(env, "calendar");
+	atom_calendar_iso = enif_make_atom(env, "Elixir.Calendar.ISO");
+	atom_year = enif_make_atom(env, "year");
+	atom_month = enif_make_atom(env, "month");
+	atom_day = enif_make_atom(env, "day");
+	atom_hour = enif_make_atom(env, "hour");
+	atom_minute = enif_make_atom(env, "minute");
+	atom_second = enif_make_atom(env, "second");
+	atom_microsecond = enif_make_atom(env, "microsecond");
+	atom_time_zone = enif_make_atom(env, "time_zone");
+	atom_zone_abbr = enif_make_atom(env, "zone_abbr");
+	atom_utc_offset = enif_make_atom(env, "utc_offset");
+	atom_std_offset = enif_make_atom(env, "std_offset");
+	atom_name = enif_make_atom(env, "name");
+	atom_type = enif_make_atom(env, "type");
+	atom_logical_type = enif_make_atom(env, "logical_type");
+	atom_params = enif_make_atom(env, "params");
+	atom_columns = enif_make_atom(env, "columns");
+	atom_width = enif_make_atom(env, "width");
+	atom_scale = enif_make_atom(env, "scale");
+	atom_child = enif_make_atom(env, "child");
+	atom_size = enif_make_atom(env, "size");
+	atom_fields = enif_make_atom(env, "fields");
+	atom_key = enif_make_atom(env, "key");
+	atom_value = enif_make_atom(env, "value");
+	atom_values = enif_make_atom(env, "values");
+	atom_members = enif_make_atom(env, "members");
+	atom_alias = enif_make_atom(env, "alias");
 
 	// Type atoms
 	atom_boolean = enif_make_atom(env, "boolean");
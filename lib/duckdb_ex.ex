@@ -227,14 +227,24 @@ defmodule DuckdbEx do
   ## Parameters
   - `connection` - The database connection
   - `sql` - The SQL query string
+  - `opts` - Materialization limits and streaming, see `DuckdbEx.Connection.query/3`
 
   ## Examples
 
       {:ok, result} = DuckdbEx.query(conn, "SELECT 1 as num, 'hello' as text")
+
+      # Fail instead of materializing more than 100_000 rows
+      {:error, _} = DuckdbEx.query(conn, "SELECT * FROM range(1000000)", max_rows: 100_000)
+
+      # Keep memory bounded and read the rest chunk by chunk
+      {:ok, result} =
+        DuckdbEx.query(conn, "SELECT * FROM big_table", max_result_bytes: 64_000_000, on_limit: :stream)
+
+      DuckdbEx.Result.stream(result) |> Enum.each(&IO.inspect/1)
   """
-  @spec query(connection, String.t()) :: {:ok, result} | {:error, String.t()}
-  def query(connection, sql) do
-    Connection.query(connection, sql)
+  @spec query(connection, String.t(), keyword()) :: {:ok, result} | {:error, String.t()}
+  def query(connection, sql, opts \\ []) do
+    Connection.query(connection, sql, opts)
   end
 
   ## Transaction Operations
@@ -361,6 +371,8 @@ defmodule DuckdbEx do
 
   ## Parameters
   - `result` - The query result
+  - `opts` - `types: :full` adds nested `:logical_type` descriptors, see
+    `DuckdbEx.Result.columns/2`
 
   ## Returns
   List of column maps with `:name` and `:type` keys
@@ -370,10 +382,14 @@ defmodule DuckdbEx do
       {:ok, result} = DuckdbEx.query(conn, "SELECT 1 as num, 'hello' as text")
       columns = DuckdbEx.columns(result)
       # [%{name: "num", type: :integer}, %{name: "text", type: :varchar}]
+
+      {:ok, result} = DuckdbEx.query(conn, "SELECT 1.5::DECIMAL(4,1) AS d")
+      [%{logical_type: %{type: :decimal, width: 4, scale: 1}}] =
+        DuckdbEx.columns(result, types: :full)
   """
-  @spec columns(result) :: [%{name: String.t(), type: atom()}]
-  def columns(result) do
-    Result.columns(result)
+  @spec columns(result, keyword()) :: [Result.column()]
+  def columns(result, opts \\ []) do
+    Result.columns(result, opts)
   end
 
   @doc """
@@ -392,22 +408,7 @@ defmodule DuckdbEx do
   def rows({:ok, result}) do
     # Handle pattern where query result tuple is passed directly
     # Return {columns, rows} for backward compatibility with some tests
-    columns = Result.columns(result)
-    raw_rows = Result.rows(result)
-
-    # Convert each row by applying type conversion to each column
-    processed_rows =
-      Enum.map(raw_rows, fn row ->
-        row
-        |> Tuple.to_list()
-        |> Enum.zip(columns)
-        |> Enum.map(fn {value, column} ->
-          DuckdbEx.TypeConverter.convert_value(value, column.type)
-        end)
-        |> List.to_tuple()
-      end)
-
-    {columns, processed_rows}
+    {Result.columns(result), Result.rows(result)}
   end
 
   def rows({:error, reason}) do
@@ -415,20 +416,7 @@ defmodule DuckdbEx do
   end
 
   def rows(result) do
-    # Handle direct result reference - return just rows
-    columns = Result.columns(result)
-    raw_rows = Result.rows(result)
-
-    # Convert each row by applying type conversion to each column
-    Enum.map(raw_rows, fn row ->
-      row
-      |> Tuple.to_list()
-      |> Enum.zip(columns)
-      |> Enum.map(fn {value, column} ->
-        DuckdbEx.TypeConverter.convert_value(value, column.type)
-      end)
-      |> List.to_tuple()
-    end)
+    Result.rows(result)
   end
 
   @doc """
@@ -439,55 +427,39 @@ defmodule DuckdbEx do
 
   ## Parameters
   - `result` - The query result
+  - `opts` - Decode options, see `t:DuckdbEx.Result.decode_opts/0`
 
   ## Examples
 
       {:ok, result} = DuckdbEx.query(conn, "SELECT [1.0, 2.0, 3.0] as vector")
       rows = DuckdbEx.rows_chunked(result)
       # [{[1.0, 2.0, 3.0]}] - Arrays are properly parsed as Elixir lists
+
+      # Share one binary per distinct country instead of one per row
+      {:ok, result} = DuckdbEx.query(conn, "SELECT country FROM visits")
+      rows = DuckdbEx.rows_chunked(result, dedup_strings: true)
+
+      # Embeddings as packed native-endian f32 binaries
+      {:ok, result} = DuckdbEx.query(conn, "SELECT embedding FROM docs")
+      [{<<first::float-32-native, _::binary>>} | _] =
+        DuckdbEx.rows_chunked(result, numeric_lists: :packed)
   """
-  @spec rows_chunked(result | {:ok, result} | {:error, String.t()}) ::
+  @spec rows_chunked(result | {:ok, result} | {:error, String.t()}, Result.decode_opts()) ::
           [tuple()] | {[map()], [tuple()]}
-  def rows_chunked({:ok, result}) do
+  def rows_chunked(result, opts \\ [])
+
+  def rows_chunked({:ok, result}, opts) do
     # Handle pattern where query result tuple is passed directly
     # Return {columns, rows} for backward compatibility with some tests
-    columns = Result.columns(result)
-    raw_rows = Result.rows_chunked(result)
-
-    # Convert each row by applying type conversion to each column
-    processed_rows =
-      Enum.map(raw_rows, fn row ->
-        row
-        |> Tuple.to_list()
-        |> Enum.zip(columns)
-        |> Enum.map(fn {value, column} ->
-          DuckdbEx.TypeConverter.convert_value(value, column.type)
-        end)
-        |> List.to_tuple()
-      end)
-
-    {columns, processed_rows}
+    {Result.columns(result), Result.rows_chunked(result, opts)}
   end
 
-  def rows_chunked({:error, reason}) do
+  def rows_chunked({:error, reason}, _opts) do
     raise ArgumentError, "Query failed: #{reason}"
   end
 
-  def rows_chunked(result) do
-    # Handle direct result reference - return just rows
-    columns = Result.columns(result)
-    raw_rows = Result.rows_chunked(result)
-
-    # Convert each row by applying type conversion to each column
-    Enum.map(raw_rows, fn row ->
-      row
-      |> Tuple.to_list()
-      |> Enum.zip(columns)
-      |> Enum.map(fn {value, column} ->
-        DuckdbEx.TypeConverter.convert_value(value, column.type)
-      end)
-      |> List.to_tuple()
-    end)
+  def rows_chunked(result, opts) do
+    Result.rows_chunked(result, opts)
   end
 
   @doc """
@@ -513,7 +485,9 @@ defmodule DuckdbEx do
   end
 
   @doc """
-  Destroys a result and frees its resources.
+  Destroys a result and frees its resources immediately.
+
+  Later calls on the result return `{:error, "Result has been destroyed"}`.
 
   ## Parameters
   - `result` - The result to destroy
@@ -127,6 +127,27 @@ defmodule DuckdbEx.Appender do
     Nif.appender_column_count(appender)
   end
 
+  @doc """
+  Restricts the appender to the given columns, in that order.
+
+  Rows appended afterwards hold one value per listed column, and the table's other columns
+  get their default values. Anything appended before is flushed first.
+
+  ## Examples
+
+      :ok = DuckdbEx.Appender.set_columns(appender, ["name", "age"])
+      :ok = DuckdbEx.Appender.append_row(appender, ["Alice", 30])
+  """
+  @spec set_columns(t(), [String.t()]) :: :ok | {:error, String.t()}
+  def set_columns(appender, columns) when is_list(columns) do
+    Enum.reduce_while(columns, :ok, fn column, :ok ->
+      case Nif.appender_add_column(appender, to_string(column)) do
+        :ok -> {:cont, :ok}
+        error -> {:halt, error}
+      end
+    end)
+  end
+
   @doc """
   Flushes the appender to the table, forcing the cache to be cleared.
 
@@ -417,6 +438,50 @@ defmodule DuckdbEx.Appender do
     Nif.appender_append_blob(appender, value)
   end
 
+  @doc """
+  Appends a value to a JSON column, encoding it in the NIF.
+
+  Maps become objects, lists arrays, binaries strings, `nil` null. Map keys
+  may be binaries, atoms or integers. Structs, tuples, NaN and integers
+  outside 64 bits are rejected.
+
+  ## Parameters
+  - `appender` - The appender object
+  - `value` - The map, list or scalar to encode
+
+  ## Returns
+  - `:ok` on success
+  - `{:error, reason}` on failure
+
+  ## Examples
+
+      :ok = DuckdbEx.Appender.append_json(appender, %{"tags" => ["a", "b"], "score" => 0.5})
+  """
+  @spec append_json(t(), map() | list() | String.t() | number() | boolean() | nil) ::
+          :ok | {:error, String.t()}
+  def append_json(appender, value) do
+    Nif.appender_append_json(appender, value)
+  end
+
+  @doc """
+  Appends whole columns given as packed native-endian binaries, one per table column.
+
+  Numeric columns take one value per row, e.g. `<<id::signed-native-64>>` for BIGINT.
+  Numeric ARRAY columns take all elements of each row back to back, so a `FLOAT[384]`
+  column takes 384 `float-native-32` values per row. Every binary must hold the same number
+  of rows. The rows are appended a vector at a time, which is much faster than appending
+  embeddings value by value.
+
+  ## Examples
+
+      ids = for id <- 1..2, into: <<>>, do: <<id::signed-native-64>>
+      :ok = DuckdbEx.Appender.append_columns(appender, [ids, DuckdbEx.VSS.pack(embeddings)])
+  """
+  @spec append_columns(t(), [binary()]) :: :ok | {:error, String.t()}
+  def append_columns(appender, columns) when is_list(columns) do
+    Nif.appender_append_columns(appender, columns)
+  end
+
   @doc """
   Appends a NULL value to the appender.
 
@@ -471,7 +536,9 @@ defmodule DuckdbEx.Appender do
   Appends a single row of data to the appender.
 
   This is a convenience function that automatically appends all values in the row
-  and calls `end_row/1` for you.
+  and calls `end_row/1` for you. Maps, and lists without integers at any level of
+  list nesting, are appended to JSON columns with `append_json/2`; lists of integers
+  could be charlists and have to be passed to `append_json/2` explicitly.
 
   ## Parameters
   - `appender` - The appender object
@@ -510,10 +577,45 @@ defmodule DuckdbEx.Appender do
   defp append_value(appender, value) when is_float(value), do: append_double(appender, value)
   defp append_value(appender, value) when is_binary(value), do: append_varchar(appender, value)
 
+  # DuckDB casts ISO 8601 text to the DATE, TIME or TIMESTAMP column it is appended to
+  defp append_value(appender, %Date{} = value),
+    do: append_varchar(appender, Date.to_iso8601(value))
+
+  defp append_value(appender, %Time{} = value),
+    do: append_varchar(appender, Time.to_iso8601(value))
+
+  defp append_value(appender, %NaiveDateTime{} = value),
+    do: append_varchar(appender, NaiveDateTime.to_iso8601(value))
+
+  defp append_value(appender, %DateTime{} = value) do
+    utc = value |> DateTime.to_unix(:microsecond) |> DateTime.from_unix!(:microsecond)
+    append_varchar(appender, utc |> DateTime.to_naive() |> NaiveDateTime.to_iso8601())
+  end
+
+  defp append_value(appender, value) when is_map(value) and not is_struct(value),
+    do: append_json(appender, value)
+
+  # Lists holding integers could be charlists, so only append_json/2 encodes those
+  defp append_value(appender, value) when is_list(value) do
+    if json_list?(value) do
+      append_json(appender, value)
+    else
+      {:error, "Lists of integers are not encoded as JSON implicitly, use append_json/2"}
+    end
+  end
+
   defp append_value(_appender, value) do
     {:error, "Unsupported value type: #{inspect(value)}"}
   end
 
+  defp json_list?(list) do
+    Enum.all?(list, fn
+      value when is_list(value) -> json_list?(value)
+      value when is_integer(value) -> false
+      _value -> true
+    end)
+  end
+
   @doc """
   Creates an appender, appends rows, and automatically closes and destroys it.
 
@@ -524,6 +626,9 @@ defmodule DuckdbEx.Appender do
   - `schema` - The schema name (use `nil` for default schema)
   - `table` - The table name
   - `rows` - A list of rows to append
+  - `opts` - Options:
+    - `:replicate` - A `DuckdbEx.Replication.Leader` that mirrors the batch to its followers
+      once it has been flushed
 
   ## Returns
   - `:ok` on success
@@ -537,9 +642,9 @@ defmodule DuckdbEx.Appender do
       ]
       :ok = DuckdbEx.Appender.insert_rows(conn, nil, "users", rows)
   """
-  @spec insert_rows(connection, String.t() | nil, String.t(), [[any()]]) ::
+  @spec insert_rows(connection, String.t() | nil, String.t(), [[any()]], keyword()) ::
           :ok | {:error, String.t()}
-  def insert_rows(connection, schema, table, rows) do
+  def insert_rows(connection, schema, table, rows, opts \\ []) do
     case create(connection, schema, table) do
       {:ok, appender} ->
         case append_rows(appender, rows) do
@@ -547,6 +652,7 @@ defmodule DuckdbEx.Appender do
             case close(appender) do
               :ok ->
                 destroy(appender)
+                replicate(opts[:replicate], schema, table, rows)
 
               {:error, _} = error ->
                 destroy(appender)
@@ -562,4 +668,11 @@ defmodule DuckdbEx.Appender do
         error
     end
   end
+
+  defp replicate(nil, _schema, _table, _rows), do: :ok
+
+  defp replicate(leader, schema, table, rows) do
+    {:ok, _seq} = DuckdbEx.Replication.Leader.replicate(leader, schema, table, rows)
+    :ok
+  end
 end
@@ -0,0 +1,12 @@
+defmodule DuckdbEx.Application do
+  @moduledoc false
+
+  use Application
+
+  @impl true
+  def start(_type, _args) do
+    # Tables created here are owned by the application master and live with the application
+    DuckdbEx.Query.create_cache()
+    Supervisor.start_link([], strategy: :one_for_one, name: DuckdbEx.Supervisor)
+  end
+end
@@ -20,21 +20,92 @@ defmodule DuckdbEx.Connection do
 
   @doc """
   Closes a database connection.
+
+  Waits for a query running on the connection to finish. Later calls with the connection
+  return `{:error, "Connection has been closed"}`; results, prepared statements and appenders
+  created from it remain usable. Statements cached for it by `DuckdbEx.Query` are released.
   """
   @spec close(t()) :: :ok
-  def close(_connection) do
-    # Connection cleanup is handled by the NIF resource destructor
-    :ok
+  def close(connection) do
+    DuckdbEx.Query.release_connection(connection)
+    DuckdbEx.Nif.connection_close(connection)
   end
 
   @doc """
   Executes a SQL query on the connection.
+
+  Without options the result is fully materialized by DuckDB. The options below
+  switch to streaming execution, where chunks are only pulled as needed:
+
+  - `:max_rows` - Maximum number of rows to materialize
+  - `:max_result_bytes` - Maximum estimated size of the materialized chunks
+  - `:on_limit` - `:error` (default) drops the query when a limit is exceeded,
+    `:stream` returns a streaming result instead, `:spill` has DuckDB write the
+    result to a temporary Parquet file and reads it back from there
+  - `:spill_dir` - Directory for spill files, defaults to `System.tmp_dir!/0`
+  - `:stream` - When `true`, returns a streaming result right away and ignores
+    the limits
+  - `:prefetch` - Number of chunks a streaming result fetches ahead on a
+    background thread while the previous ones are decoded (default `0`, off)
+
+  Streaming results are read forward with `DuckdbEx.Result.next_chunk/1`,
+  `DuckdbEx.Result.stream/1` or `DuckdbEx.Result.rows/1`, and must be consumed
+  before the connection runs another query.
+
+  With any of these options the SQL must be a single statement; scripts of
+  several statements are rejected with an error and go through `query/2`.
+
+  With `on_limit: :spill` the query runs once, inside `COPY (...) TO ...
+  (FORMAT parquet)`, and the limits apply while reading the file back: results
+  within them are materialized and the file deleted right away, larger ones
+  stream from the file, which is deleted when the result is destroyed or
+  garbage collected. The query must produce a result Parquet can represent.
   """
-  @spec query(t(), String.t()) :: {:ok, DuckdbEx.Result.t()} | {:error, String.t()}
-  def query(connection, sql) do
+  @spec query(t(), String.t(), keyword()) :: {:ok, DuckdbEx.Result.t()} | {:error, String.t()}
+  def query(connection, sql, opts \\ [])
+
+  def query(connection, sql, []) do
     case DuckdbEx.Nif.connection_query(connection, sql) do
       {:ok, result_ref} -> {:ok, result_ref}
       {:error, reason} -> {:error, reason}
     end
   end
+
+  def query(connection, sql, opts) do
+    {max_rows, max_result_bytes, on_limit} =
+      if Keyword.get(opts, :stream, false) do
+        {0, 0, :stream}
+      else
+        {Keyword.get(opts, :max_rows, 0), Keyword.get(opts, :max_result_bytes, 0),
+         on_limit(Keyword.get(opts, :on_limit, :error), opts)}
+      end
+
+    prefetch = Keyword.get(opts, :prefetch, 0)
+
+    case DuckdbEx.Nif.connection_query_bounded(
+           connection,
+           sql,
+           max_rows,
+           max_result_bytes,
+           on_limit,
+           prefetch
+         ) do
+      {:ok, result_ref} ->
+        {:ok, result_ref}
+
+      {:error, :limit_exceeded} ->
+        {:error, "Result exceeds the configured max_rows/max_result_bytes limit"}
+
+      {:error, reason} ->
+        {:error, reason}
+    end
+  end
+
+  defp on_limit(:spill, opts) do
+    dir = Keyword.get_lazy(opts, :spill_dir, &System.tmp_dir!/0)
+    file = "duckdb_ex_spill_#{System.pid()}_#{System.unique_integer([:positive])}.parquet"
+    {:spill, Path.join(dir, file)}
+  end
+
+  defp on_limit(on_limit, _opts), do: on_limit
 end
@@ -41,11 +41,14 @@ defmodule DuckdbEx.Database do
 
   @doc """
   Closes a DuckDB database.
+
+  New connections to it are refused from then on. The database file and memory are released
+  once every connection to it is closed as well; otherwise that happens when the remaining
+  connections are garbage collected.
   """
   @spec close(t()) :: :ok
-  def close(_database) do
-    # Database cleanup is handled by the NIF resource destructor
-    :ok
+  def close(database) do
+    DuckdbEx.Nif.database_close(database)
   end
 
   defp normalize_path(nil), do: nil
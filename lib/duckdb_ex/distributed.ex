@@ -0,0 +1,228 @@
+defmodule DuckdbEx.Distributed do
+  @moduledoc """
+  Fans a query out to DuckDB shards on BEAM nodes and merges their partial results.
+
+  Each node registers the connection of its local shard with `register_shard/2`. `query/3`
+  runs the shard query on every target through `:erpc`. Each shard writes its result as a
+  zstd-compressed Parquet file and ships the bytes back instead of decoded rows. A local
+  in-memory database then runs a merge query over the collected files. Inside that query the
+  files are visible as the `partials` view.
+
+  Decomposable aggregates are merged by aggregating their partials again:
+
+  - sums and counts are summed
+  - minimums and maximums are taken again
+  - averages are rebuilt from a sum column and a count column
+
+      DuckdbEx.Distributed.query(
+        [:"shard1@host", :"shard2@host"],
+        "SELECT region, sum(amount) AS total, count(*) AS n FROM sales GROUP BY region",
+        group_by: [:region],
+        aggregates: [total: :sum, n: :count, mean: {:avg, :total, :n}]
+      )
+
+  A target is a node, which uses the shard registered as `:default`, or a `{node, shard}`
+  tuple. Several shards may live on one node.
+  """
+
+  alias DuckdbEx.Result
+
+  @type target :: node() | {node(), term()}
+
+  @type aggregate :: :sum | :count | :min | :max | {:avg, atom(), atom()}
+
+  @default_timeout 60_000
+
+  @doc """
+  Registers `connection` as the local shard `name`, making it reachable from `query/3`.
+  """
+  @spec register_shard(term(), DuckdbEx.Connection.t()) :: :ok
+  def register_shard(name \\ :default, connection) do
+    :persistent_term.put({__MODULE__, name}, connection)
+  end
+
+  @doc """
+  Removes the local shard `name`.
+  """
+  @spec unregister_shard(term()) :: :ok
+  def unregister_shard(name \\ :default) do
+    :persistent_term.erase({__MODULE__, name})
+    :ok
+  end
+
+  @doc """
+  Runs `sql` on every target and merges the partial results.
+
+  Returns `{:ok, {columns, rows}}` with the columns and rows of the merge query, or
+  `{:error, {target, reason}}` for the first shard that failed.
+
+  ## Options
+
+  - `:merge` - SQL run over the `partials` view, e.g.
+    `"SELECT region, sum(total) AS total FROM partials GROUP BY region"`
+  - `:group_by` and `:aggregates` - build the merge query instead: the grouping columns,
+    and for each output column how its partials combine (`t:aggregate/0`). Rows are ordered
+    by the grouping columns.
+  - `:timeout` - Milliseconds to wait for all shards, default `60_000`
+  - `:decode` - Decode options for the merged rows, see `t:DuckdbEx.Result.decode_opts/0`
+
+  Without `:merge` or `:aggregates` the partial rows are concatenated.
+  """
+  @spec query([target()], String.t(), keyword()) ::
+          {:ok, {[Result.column()], [tuple()]}} | {:error, term()}
+  def query(targets, sql, opts \\ []) when is_list(targets) and targets != [] do
+    timeout = Keyword.get(opts, :timeout, @default_timeout)
+    merge_sql = merge_sql(opts)
+
+    with {:ok, partials} <- collect(targets, sql, timeout) do
+      merge(partials, merge_sql, Keyword.get(opts, :decode, []))
+    end
+  end
+
+  @doc """
+  Builds the SQL that merges partial aggregates, see `query/3`.
+  """
+  @spec merge_sql([atom() | String.t()], keyword(aggregate())) :: String.t()
+  def merge_sql(group_by, aggregates) do
+    groups = Enum.map(group_by, &quote_identifier/1)
+
+    selects =
+      groups ++
+        Enum.map(aggregates, fn {name, aggregate} ->
+          "#{merge_expression(aggregate, name)} AS #{quote_identifier(name)}"
+        end)
+
+    grouping =
+      if groups == [],
+        do: "",
+        else: " GROUP BY #{Enum.join(groups, ", ")} ORDER BY #{Enum.join(groups, ", ")}"
+
+    "SELECT #{Enum.join(selects, ", ")} FROM partials#{grouping}"
+  end
+
+  @doc false
+  # Runs on the shard's node
+  def run_shard(shard, sql) do
+    case :persistent_term.get({__MODULE__, shard}, nil) do
+      nil ->
+        {:error, "no shard #{inspect(shard)} registered on #{node()}"}
+
+      connection ->
+        path = temp_path()
+        sql = sql |> String.trim() |> String.trim_trailing(";")
+        # The closing parenthesis goes on its own line so a trailing -- comment can't swallow it
+        copy = "COPY (#{sql}\n) TO '#{quote_literal(path)}' (FORMAT parquet, COMPRESSION zstd)"
+
+        try do
+          with {:ok, result} <- DuckdbEx.query(connection, copy) do
+            Result.destroy(result)
+            File.read(path)
+          end
+        after
+          File.rm(path)
+        end
+    end
+  end
+
+  defp merge_sql(opts) do
+    cond do
+      merge = opts[:merge] -> merge
+      aggregates = opts[:aggregates] -> merge_sql(Keyword.get(opts, :group_by, []), aggregates)
+      true -> "SELECT * FROM partials"
+    end
+  end
+
+  defp merge_expression(:sum, name), do: "sum(#{quote_identifier(name)})"
+  defp merge_expression(:count, name), do: "sum(#{quote_identifier(name)})::BIGINT"
+  defp merge_expression(:min, name), do: "min(#{quote_identifier(name)})"
+  defp merge_expression(:max, name), do: "max(#{quote_identifier(name)})"
+
+  defp merge_expression({:avg, sum, count}, _name),
+    do: "sum(#{quote_identifier(sum)}) / sum(#{quote_identifier(count)})"
+
+  defp merge_expression(aggregate, name) do
+    raise ArgumentError, "unsupported aggregate #{inspect(aggregate)} for #{inspect(name)}"
+  end
+
+  # Requests go out to every shard before any reply is awaited
+  defp collect(targets, sql, timeout) do
+    deadline = System.monotonic_time(:millisecond) + timeout
+
+    targets
+    |> Enum.map(fn target ->
+      {node, shard} = normalize_target(target)
+      {target, :erpc.send_request(node, __MODULE__, :run_shard, [shard, sql])}
+    end)
+    |> await_partials(deadline, [])
+  end
+
+  defp await_partials([], _deadline, acc), do: {:ok, acc}
+
+  defp await_partials([{target, request} | pending], deadline, acc) do
+    remaining = max(deadline - System.monotonic_time(:millisecond), 0)
+
+    case receive_partial(request, remaining) do
+      {:ok, parquet} ->
+        await_partials(pending, deadline, [parquet | acc])
+
+      {:error, reason} ->
+        # A zero timeout takes a reply that already arrived or abandons the request, so no
+        # late reply lands in the caller's mailbox
+        Enum.each(pending, fn {_target, request} -> receive_partial(request, 0) end)
+        {:error, {target, reason}}
+    end
+  end
+
+  defp receive_partial(request, timeout) do
+    :erpc.receive_response(request, timeout)
+  catch
+    kind, reason -> {:error, {kind, reason}}
+  end
+
+  defp normalize_target({node, shard}) when is_atom(node), do: {node, shard}
+  defp normalize_target(node) when is_atom(node), do: {node, :default}
+
+  defp merge(partials, merge_sql, decode_opts) do
+    dir = temp_path()
+    File.mkdir_p!(dir)
+
+    try do
+      files =
+        partials
+        |> Enum.with_index()
+        |> Enum.map(fn {parquet, index} ->
+          path = Path.join(dir, "partial_#{index}.parquet")
+          File.write!(path, parquet)
+          "'#{quote_literal(path)}'"
+        end)
+
+      {:ok, db} = DuckdbEx.open()
+      {:ok, conn} = DuckdbEx.connect(db)
+
+      try do
+        view = "CREATE VIEW partials AS SELECT * FROM read_parquet([#{Enum.join(files, ", ")}])"
+
+        with {:ok, _} <- DuckdbEx.query(conn, view),
+             {:ok, result} <- DuckdbEx.query(conn, merge_sql) do
+          rows = Result.rows_chunked(result, decode_opts)
+          columns = Result.columns(result)
+          Result.destroy(result)
+          {:ok, {columns, rows}}
+        end
+      after
+        DuckdbEx.close_connection(conn)
+        DuckdbEx.close_database(db)
+      end
+    after
+      File.rm_rf(dir)
+    end
+  end
+
+  defp temp_path() do
+    file = "duckdb_ex_partial_#{System.pid()}_#{System.unique_integer([:positive])}"
+    Path.join(System.tmp_dir!(), file)
+  end
+
+  defp quote_identifier(name), do: ~s("#{String.replace(to_string(name), ~s("), ~s(""))}")
+  defp quote_literal(text), do: String.replace(text, "'", "''")
+end
@@ -11,7 +11,17 @@ defmodule DuckdbEx.Nif do
   def load_nifs do
     so_file = Application.app_dir(:duckdb_ex, "priv/duckdb_ex")
 
-    case :erlang.load_nif(so_file, 0) do
+    # A CPU-specific build is preferred when one is installed and the host supports it
+    result =
+      case best_variant(so_file) do
+        ^so_file ->
+          :erlang.load_nif(so_file, 0)
+
+        variant ->
+          with {:error, _} <- :erlang.load_nif(variant, 0), do: :erlang.load_nif(so_file, 0)
+      end
+
+    case result do
       :ok ->
         :ok
 
@@ -24,6 +34,15 @@ defmodule DuckdbEx.Nif do
     end
   end
 
+  defp best_variant(so_file) do
+    case Code.ensure_loaded(DuckdbEx.NifDownloader) do
+      {:module, _} -> DuckdbEx.NifDownloader.nif_path()
+      {:error, _} -> so_file
+    end
+  rescue
+    _ -> so_file
+  end
+
   defp try_download_nif_and_reload(so_file) do
     case Code.ensure_loaded(DuckdbEx.NifDownloader) do
       {:module, _} ->
@@ -82,6 +101,20 @@ defmodule DuckdbEx.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
+  @doc """
+  Closes a database handle (NIF implementation).
+  """
+  def database_close(_database) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  @doc """
+  Closes a connection (NIF implementation).
+  """
+  def connection_close(_connection) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
   @doc """
   Executes a SQL query (NIF implementation).
   """
@@ -89,6 +122,13 @@ defmodule DuckdbEx.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
+  @doc """
+  Executes a SQL query with streaming execution and materialization limits (NIF implementation).
+  """
+  def connection_query_bounded(_connection, _sql, _max_rows, _max_result_bytes, _on_limit, _prefetch) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
   ## Transaction Operations
 
   @doc """
@@ -112,6 +152,20 @@ defmodule DuckdbEx.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
+  @doc """
+  Runs a k-NN query once per packed query vector (NIF implementation).
+  """
+  def connection_vss_search(_connection, _sql_prefix, _sql_suffix, _vectors, _dim) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  @doc """
+  Returns the progress of the query running on a connection (NIF implementation).
+  """
+  def connection_query_progress(_connection) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
   ## Appender Operations
 
   @doc """
@@ -135,6 +189,13 @@ defmodule DuckdbEx.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
+  @doc """
+  Adds a column to an appender's column list (NIF implementation).
+  """
+  def appender_add_column(_appender, _name) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
   @doc """
   Flushes an appender (NIF implementation).
   """
@@ -254,6 +315,20 @@ defmodule DuckdbEx.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
+  @doc """
+  Encodes a term as JSON and appends it (NIF implementation).
+  """
+  def appender_append_json(_appender, _value) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  @doc """
+  Appends whole columns from packed binaries (NIF implementation).
+  """
+  def appender_append_columns(_appender, _columns) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
   @doc """
   Appends a NULL value (NIF implementation).
   """
@@ -277,6 +352,20 @@ defmodule DuckdbEx.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
+  @doc """
+  Executes a prepared statement into a streaming result (NIF implementation).
+  """
+  def prepared_statement_execute_stream(_prepared_statement, _params, _prefetch) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  @doc """
+  Describes the parameters and result columns of a prepared statement (NIF implementation).
+  """
+  def prepared_statement_describe(_prepared_statement) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
   ## Result Operations
 
   @doc """
@@ -286,6 +375,13 @@ defmodule DuckdbEx.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
+  @doc """
+  Gets column information with nested logical type descriptors (NIF implementation).
+  """
+  def result_columns_full(_result) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
   @doc """
   Gets all rows from a result (NIF implementation).
   """
@@ -329,4 +425,25 @@ defmodule DuckdbEx.Nif do
   def data_chunk_get_data(_data_chunk) do
     :erlang.nif_error(:nif_not_loaded)
   end
+
+  @doc """
+  Decodes all chunks of a result into a single list of rows (NIF implementation).
+  """
+  def result_rows_chunked(_result, _options) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  @doc """
+  Decodes the next chunk of a result, or returns `:done` (NIF implementation).
+  """
+  def result_fetch_chunk(_result, _options) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  @doc """
+  Frees the memory held by a result (NIF implementation).
+  """
+  def result_destroy(_result) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
 end
@@ -4,6 +4,13 @@ defmodule DuckdbEx.NifDownloader do
 
   This module handles downloading platform-specific precompiled NIFs from GitHub releases
   when the package is installed, unless the DUCKDB_EX_BUILD environment variable is set.
+
+  Besides the baseline build, releases carry CPU-specific variants: `x86-64-v3` (AVX2, BMI2,
+  FMA) for x86_64 and `armv8.2-a` for aarch64. The baseline is always installed; variants the
+  host CPU supports are installed next to it and `DuckdbEx.Nif` loads the best one present.
+
+  Downloaded archives are kept in a cache directory, `DUCKDB_EX_NIF_CACHE_DIR` or the user
+  cache directory by default. Archives placed there beforehand are used without downloading.
   """
 
   require Logger
@@ -11,6 +18,76 @@ defmodule DuckdbEx.NifDownloader do
   @github_repo "alexiob/duckdb_ex"
   @nif_versions ["2.15", "2.16"]
 
+  # Variants per architecture, best first, with the CPU flags each one requires as reported
+  # by /proc/cpuinfo on Linux or sysctl on macOS
+  @variants %{
+    x86_64: [{"x86-64-v3", ~w(avx avx2 bmi1 bmi2 fma f16c movbe)}],
+    aarch64: [{"armv8.2-a", ~w(atomics asimdrdm crc32 dcpop)}]
+  }
+
+  @doc """
+  Returns the NIF variants the host CPU can run, best first. The baseline build is not listed.
+  """
+  @spec supported_variants() :: [String.t()]
+  def supported_variants() do
+    arch = cpu_arch()
+
+    case {:os.type(), arch} do
+      # Every Apple Silicon core implements ARMv8.4 or later
+      {{:unix, :darwin}, :aarch64} ->
+        Enum.map(Map.get(@variants, :aarch64, []), &elem(&1, 0))
+
+      _ ->
+        flags = cpu_flags()
+
+        for {variant, required} <- Map.get(@variants, arch, []),
+            Enum.all?(required, &MapSet.member?(flags, &1)),
+            do: variant
+    end
+  end
+
+  @doc """
+  Returns the path, without extension, of the best installed NIF the host CPU can run.
+  Falls back to the baseline build when no variant is installed, or when the baseline
+  is newer than the variant (a local source or profiling build). Touches nothing on disk.
+  """
+  @spec nif_path() :: String.t()
+  def nif_path() do
+    baseline = Path.join(priv_dir(), nif_name(nil))
+    baseline_mtime = so_mtime(baseline)
+
+    supported_variants()
+    |> Enum.map(&Path.join(priv_dir(), nif_name(&1)))
+    |> Enum.find(baseline, fn variant ->
+      case so_mtime(variant) do
+        nil -> false
+        mtime -> baseline_mtime == nil or mtime >= baseline_mtime
+      end
+    end)
+  end
+
+  defp so_mtime(path) do
+    case File.stat(path <> so_ext(), time: :posix) do
+      {:ok, %File.Stat{mtime: mtime}} -> mtime
+      {:error, _} -> nil
+    end
+  end
+
+  defp so_ext() do
+    if match?({:win32, _}, :os.type()), do: ".dll", else: ".so"
+  end
+
+  @doc """
+  Returns the directory downloaded NIF archives are cached in.
+  """
+  @spec cache_dir() :: String.t()
+  def cache_dir() do
+    case System.get_env("DUCKDB_EX_NIF_CACHE_DIR") do
+      dir when dir in [nil, ""] -> :filename.basedir(:user_cache, "duckdb_ex")
+      dir -> dir
+    end
+  end
+
   def download_nif() do
     # First check if NIF already exists and is valid
     if nif_exists?() and not should_force_rebuild?() do
@@ -79,9 +156,10 @@ defmodule DuckdbEx.NifDownloader do
   defp download_precompiled_nif() do
     case get_target_info() do
       {:ok, target_info} ->
-        case download_for_target(target_info) do
+        case download_for_target(target_info, nil) do
           :ok ->
             Logger.info("Successfully downloaded precompiled NIF")
+            download_variants(target_info)
             :ok
 
           {:error, reason} ->
@@ -97,6 +175,65 @@ defmodule DuckdbEx.NifDownloader do
     end
   end
 
+  # Variants are optional: a failed download leaves the baseline in use
+  defp download_variants(target_info) do
+    Enum.each(supported_variants(), fn variant ->
+      case download_for_target(target_info, variant) do
+        :ok ->
+          Logger.info("Installed #{variant} NIF variant")
+
+        {:error, reason} ->
+          Logger.debug("No #{variant} NIF variant available: #{reason}")
+      end
+    end)
+  end
+
+  defp nif_name(nil), do: "duckdb_ex"
+  defp nif_name(variant), do: "duckdb_ex-#{variant}"
+
+  defp cpu_flags() do
+    case :os.type() do
+      {:unix, :linux} ->
+        case File.read("/proc/cpuinfo") do
+          {:ok, cpuinfo} ->
+            # x86 lists "flags", aarch64 "Features"; every core reports the same set
+            cpuinfo
+            |> String.split("\n")
+            |> Enum.find_value("", fn line ->
+              case String.split(line, ":", parts: 2) do
+                [key, value] -> if String.trim(key) in ["flags", "Features"], do: value
+                _ -> nil
+              end
+            end)
+            |> String.split()
+            |> MapSet.new()
+
+          {:error, _} ->
+            MapSet.new()
+        end
+
+      {:unix, :darwin} ->
+        case System.cmd("sysctl", ["-n", "machdep.cpu.features", "machdep.cpu.leaf7_features"],
+               stderr_to_stdout: true
+             ) do
+          {output, 0} ->
+            output
+            |> String.downcase()
+            |> String.replace("avx1.0", "avx")
+            |> String.split()
+            |> MapSet.new()
+
+          _ ->
+            MapSet.new()
+        end
+
+      _ ->
+        MapSet.new()
+    end
+  rescue
+    _ -> MapSet.new()
+  end
+
   defp get_target_info() do
     nif_version = get_nif_version()
     target = get_target_triple()
@@ -176,31 +313,37 @@ defmodule DuckdbEx.NifDownloader do
     end
   end
 
-  defp download_for_target(%{nif_version: nif_version, target: target}) do
+  defp download_for_target(%{nif_version: nif_version, target: target}, variant) do
     version = get_package_version()
-    package_name = "duckdb_ex-nif-#{nif_version}-#{target}"
+    suffix = if variant, do: "-#{variant}", else: ""
+    package_name = "duckdb_ex-nif-#{nif_version}-#{target}#{suffix}"
     filename = "#{package_name}.tar.gz"
     url = "https://github.com/#{@github_repo}/releases/download/v#{version}/#{filename}"
 
     priv_dir = ensure_priv_dir()
-    temp_path = Path.join(System.tmp_dir!(), filename)
-
-    Logger.info("Downloading #{filename} from #{url}")
+    cache_path = Path.join([cache_dir(), "v#{version}", filename])
 
-    case download_file(url, temp_path) do
-      :ok ->
-        case extract_package(temp_path, priv_dir, target) do
-          :ok ->
-            File.rm(temp_path)
-            :ok
+    with :ok <- fetch_cached(url, cache_path) do
+      case extract_package(cache_path, priv_dir, target, variant) do
+        :ok ->
+          :ok
 
-          {:error, reason} ->
-            File.rm(temp_path)
-            {:error, reason}
-        end
+        {:error, reason} ->
+          # A corrupt archive would otherwise be reused on every attempt
+          File.rm(cache_path)
+          {:error, reason}
+      end
+    end
+  end
 
-      {:error, reason} ->
-        {:error, reason}
+  defp fetch_cached(url, cache_path) do
+    if File.exists?(cache_path) and is_valid_nif?(cache_path) do
+      Logger.info("Using cached #{Path.basename(cache_path)}")
+      :ok
+    else
+      Logger.info("Downloading #{Path.basename(cache_path)} from #{url}")
+      File.mkdir_p!(Path.dirname(cache_path))
+      download_file(url, cache_path)
     end
   end
 
@@ -225,24 +368,20 @@ defmodule DuckdbEx.NifDownloader do
   end
 
   defp ensure_priv_dir() do
-    priv_dir = :code.priv_dir(:duckdb_ex)
+    priv_path = priv_dir()
+    File.mkdir_p!(priv_path)
+    priv_path
+  end
 
-    case priv_dir do
+  defp priv_dir() do
+    case :code.priv_dir(:duckdb_ex) do
       {:error, :bad_name} ->
         # During compilation, priv dir might not exist yet
         app_dir = Path.dirname(Path.dirname(__DIR__))
-        priv_path = Path.join(app_dir, "priv")
-        File.mkdir_p!(priv_path)
-        priv_path
-
-      priv_path when is_list(priv_path) ->
-        priv_str = to_string(priv_path)
-        File.mkdir_p!(priv_str)
-        priv_str
-
-      priv_path when is_binary(priv_path) ->
-        File.mkdir_p!(priv_path)
-        priv_path
+        Path.join(app_dir, "priv")
+
+      priv_path ->
+        to_string(priv_path)
     end
   end
 
@@ -259,7 +398,7 @@ defmodule DuckdbEx.NifDownloader do
     end
   end
 
-  defp extract_package(tarball_path, priv_dir, target) do
+  defp extract_package(tarball_path, priv_dir, target, variant) do
     temp_extract_dir = Path.join(System.tmp_dir!(), "duckdb_extract_#{:rand.uniform(1_000_000)}")
 
     try do
@@ -274,8 +413,8 @@ defmodule DuckdbEx.NifDownloader do
           extracted_dir = Path.join(System.tmp_dir!(), package_name)
 
           # Copy NIF to priv directory
-          nif_source = Path.join(extracted_dir, "duckdb_ex#{so_ext}")
-          nif_dest = Path.join(priv_dir, "duckdb_ex#{so_ext}")
+          nif_source = Path.join(extracted_dir, "#{nif_name(variant)}#{so_ext}")
+          nif_dest = Path.join(priv_dir, "#{nif_name(variant)}#{so_ext}")
 
           case File.cp(nif_source, nif_dest) do
             :ok ->
@@ -347,6 +486,7 @@ defmodule DuckdbEx.NifDownloader do
       {output, 0} ->
         Logger.info("Successfully built NIF from source")
         Logger.debug("Build output: #{output}")
+        remove_variants()
         :ok
 
       {output, exit_code} ->
@@ -355,4 +495,11 @@ defmodule DuckdbEx.NifDownloader do
         {:error, "Build failed with exit code #{exit_code}"}
     end
   end
+
+  # Downloaded CPU-specific builds would otherwise shadow the one just compiled
+  defp remove_variants() do
+    Enum.each(supported_variants(), fn variant ->
+      File.rm(Path.join(priv_dir(), nif_name(variant) <> so_ext()))
+    end)
+  end
 end
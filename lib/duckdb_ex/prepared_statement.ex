@@ -29,6 +29,37 @@ defmodule DuckdbEx.PreparedStatement do
     end
   end
 
+  @doc """
+  Executes a prepared statement with streaming execution.
+
+  The result is read forward with `DuckdbEx.Result.next_chunk/2` or
+  `DuckdbEx.Result.stream/2`, a chunk at a time, like a result of
+  `DuckdbEx.Connection.query/3` with `stream: true`. It must be consumed or destroyed
+  before the statement or its connection runs another query.
+
+  ## Options
+
+  - `:prefetch` - Number of chunks fetched ahead on a background thread (default `0`, off)
+  """
+  @spec execute_stream(t(), list(), keyword()) ::
+          {:ok, DuckdbEx.Result.t()} | {:error, String.t()}
+  def execute_stream(prepared_statement, params \\ [], opts \\ []) do
+    prefetch = Keyword.get(opts, :prefetch, 0)
+    DuckdbEx.Nif.prepared_statement_execute_stream(prepared_statement, params, prefetch)
+  end
+
+  @doc """
+  Describes a prepared statement without executing it.
+
+  Returns the types of its parameters, `:unknown` where DuckDB cannot infer one, and its
+  result columns in the format of `DuckdbEx.Result.columns(result, types: :full)`.
+  """
+  @spec describe(t()) ::
+          {:ok, %{params: [atom()], columns: [DuckdbEx.Result.column()]}} | {:error, String.t()}
+  def describe(prepared_statement) do
+    DuckdbEx.Nif.prepared_statement_describe(prepared_statement)
+  end
+
   @doc """
   Destroys a prepared statement and frees its resources.
   """
@@ -0,0 +1,180 @@
+if Code.ensure_loaded?(GenStage) do
+  defmodule DuckdbEx.Producer do
+    @moduledoc """
+    GenStage producer emitting a query result one chunk per event, as consumers ask for them.
+
+    Each event is one chunk of about 2048 rows. With `emit: :rows` (default) the event is the
+    list of decoded row tuples, fetched from a streaming result, so only the chunks consumers
+    asked for are ever in memory. With `emit: :chunks` the event is a raw chunk reference of
+    a materialized result. Consumers decode those themselves with
+    `DuckdbEx.data_chunk_get_data/1`, so decoding runs in parallel across consumers.
+
+        {:ok, producer} =
+          DuckdbEx.Producer.start_link(connection: conn, query: "SELECT * FROM events")
+
+        for _ <- 1..System.schedulers_online() do
+          {:ok, consumer} = MySink.start_link()
+          GenStage.sync_subscribe(consumer, to: producer, max_demand: 4)
+        end
+
+    Once every chunk has been emitted the producer stops with reason `:normal`, and
+    consumers subscribed with the default `cancel: :permanent` stop after handling their
+    last events.
+
+    Broadway pipelines use the producer with a transformer that wraps each event, and
+    `on_done: :idle`, because Broadway restarts producers that stop:
+
+        producer: [
+          module: {DuckdbEx.Producer, connection: conn, query: sql, on_done: :idle},
+          transformer: {MyPipeline, :to_message, []},
+          concurrency: 1
+        ]
+
+        def to_message(rows, _opts),
+          do: %Broadway.Message{data: rows, acknowledger: Broadway.NoopAcknowledger.init()}
+
+    A streaming result must be read to the end before its connection runs another query, so
+    the connection shouldn't be used for anything else while the producer runs.
+
+    ## Options
+
+    - `:connection` and `:query` - Query to run when the producer starts, with `:params`
+      for its `$n` parameters
+    - `:result` - A result to emit instead of running a query. The producer takes it over;
+      with `emit: :rows` it is destroyed once done. `emit: :chunks` needs a materialized
+      result.
+    - `:emit` - `:rows` (default) or `:chunks`
+    - `:decode` - Decode options for `emit: :rows`, see `t:DuckdbEx.Result.decode_opts/0`
+    - `:prefetch` - Chunks a query run by the producer fetches ahead, see
+      `DuckdbEx.Connection.query/3`. Default `0`.
+    - `:on_done` - `:stop` (default), `:idle` to stay up without emitting, or
+      `{:notify, pid}` to stay up and send `{:duckdb_ex_producer_done, producer}` to `pid`
+    - `:dispatcher` and `:buffer_size` - Passed on to GenStage
+    - `:name` - Name to register the producer under
+    """
+
+    use GenStage
+
+    alias DuckdbEx.{PreparedStatement, Result}
+
+    @doc """
+    Starts a producer, see the module documentation for the options.
+    """
+    @spec start_link(keyword()) :: GenServer.on_start()
+    def start_link(opts) do
+      {name, opts} = Keyword.pop(opts, :name)
+      GenStage.start_link(__MODULE__, opts, if(name, do: [name: name], else: []))
+    end
+
+    @impl true
+    def init(opts) do
+      emit = Keyword.get(opts, :emit, :rows)
+
+      unless emit in [:rows, :chunks] do
+        raise ArgumentError, "emit must be :rows or :chunks, got: #{inspect(emit)}"
+      end
+
+      case open_result(opts, emit) do
+        {:ok, result} ->
+          state = %{
+            result: result,
+            emit: emit,
+            decode: Keyword.get(opts, :decode, []),
+            on_done: Keyword.get(opts, :on_done, :stop),
+            next: 0,
+            chunk_count: if(emit == :chunks, do: Result.chunk_count(result)),
+            done: false
+          }
+
+          {:producer, state, Keyword.take(opts, [:dispatcher, :buffer_size])}
+
+        {:error, reason} ->
+          {:stop, reason}
+      end
+    end
+
+    @impl true
+    def handle_demand(_demand, %{done: true} = state), do: {:noreply, [], state}
+
+    def handle_demand(demand, state) do
+      {events, state} = take(demand, state, [])
+
+      # Runs after the events above have been dispatched
+      if state.done, do: GenStage.async_info(self(), :done)
+
+      {:noreply, events, state}
+    end
+
+    @impl true
+    def handle_info(:done, state) do
+      release(state)
+
+      case state.on_done do
+        :stop ->
+          {:stop, :normal, state}
+
+        :idle ->
+          {:noreply, [], state}
+
+        {:notify, pid} ->
+          send(pid, {:duckdb_ex_producer_done, self()})
+          {:noreply, [], state}
+      end
+    end
+
+    def handle_info(_message, state), do: {:noreply, [], state}
+
+    @impl true
+    def terminate(_reason, state), do: release(state)
+
+    defp open_result(opts, emit) do
+      case Keyword.fetch(opts, :result) do
+        {:ok, result} ->
+          {:ok, result}
+
+        :error ->
+          conn = Keyword.fetch!(opts, :connection)
+          sql = Keyword.fetch!(opts, :query)
+          params = Keyword.get(opts, :params, [])
+
+          with {:ok, statement} <- PreparedStatement.prepare(conn, sql) do
+            case emit do
+              :rows ->
+                prefetch = Keyword.get(opts, :prefetch, 0)
+                PreparedStatement.execute_stream(statement, params, prefetch: prefetch)
+
+              :chunks ->
+                PreparedStatement.execute(statement, params)
+            end
+          end
+      end
+    end
+
+    defp take(0, state, events), do: {Enum.reverse(events), state}
+    defp take(_demand, %{done: true} = state, events), do: {Enum.reverse(events), state}
+
+    defp take(demand, %{emit: :rows} = state, events) do
+      case Result.next_chunk(state.result, state.decode) do
+        {:ok, rows} -> take(demand - 1, state, [rows | events])
+        :done -> take(demand, %{state | done: true}, events)
+        {:error, reason} -> raise RuntimeError, "Failed to fetch chunk: #{reason}"
+      end
+    end
+
+    defp take(demand, %{emit: :chunks, next: next, chunk_count: count} = state, events)
+         when next < count do
+      case Result.get_chunk(state.result, next) do
+        {:ok, chunk} -> take(demand - 1, %{state | next: next + 1}, [chunk | events])
+        {:error, reason} -> raise RuntimeError, "Failed to get chunk #{next}: #{reason}"
+      end
+    end
+
+    defp take(demand, %{emit: :chunks} = state, events),
+      do: take(demand, %{state | done: true}, events)
+
+    # Raw chunks still being decoded by consumers keep their result alive, so only decoded
+    # results are destroyed right away
+    defp release(%{emit: :rows, result: result}), do: Result.destroy(result)
+    defp release(_state), do: :ok
+  end
+end
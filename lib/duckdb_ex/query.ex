@@ -0,0 +1,303 @@
+defmodule DuckdbEx.Query do
+  @moduledoc """
+  Queries declared at compile time and prepared once per connection.
+
+  `defquery/3` prepares its SQL at compile time against a development database. A syntax
+  error or an unknown table or column fails the build. The number of parameters becomes the
+  function's arity, and the result columns determine the shape of the returned rows:
+
+      defmodule MyApp.Queries do
+        use DuckdbEx.Query, schema: "priv/duckdb/schema.sql"
+
+        defquery :recent_events,
+                 "SELECT id, kind, ts FROM events WHERE user_id = $1 AND ts > $2",
+                 as: :maps
+      end
+
+      {:ok, [%{id: 1, kind: "click", ts: ~N[...]}]} =
+        MyApp.Queries.recent_events(conn, 42, ~N[2024-01-01 00:00:00])
+
+  `prepare_all/1`, called once per connection at startup, prepares every declared query on
+  that connection. Calls on that connection then execute the prepared statements, so SQL is
+  parsed and types are resolved only once per connection. On other connections each call
+  prepares its statement first. The statements are kept in an ETS table until `release/1`
+  is called or the connection is closed with `DuckdbEx.close_connection/1`; a connection
+  that is only dropped stays referenced by the table.
+
+  A statement prepared by `prepare_all/1` is shared by every process using the connection;
+  concurrent calls of the same query run one at a time. Calls return an error when the
+  `:duckdb_ex` application, which owns the table, is not started.
+
+  The generated decoder only shapes the row tuples. Values are decoded by the NIF from the
+  result's runtime column types, which `prepare_all/1` checks against the compile-time ones.
+
+  ## `use` options
+
+  - `:schema` - SQL file run on an empty in-memory database before the queries are
+    prepared, typically the `CREATE TABLE` statements of the application
+  - `:database` - Database file to prepare the queries against, opened read-only,
+    instead of `:schema`
+  - `:validate` - `false` to skip compile-time preparation, e.g. when cross-compiling.
+    Each `defquery` then needs a `:params` count, and rows are returned as tuples.
+
+  ## `defquery` options
+
+  - `:as` - `:tuples` (default), `:maps` with the column names as atom keys, or a struct
+    module with fields named after the columns
+  - `:decode` - Decode options for the rows, see `t:DuckdbEx.Result.decode_opts/0`
+  - `:params` - Parameter count, only used with `validate: false`
+  """
+
+  alias DuckdbEx.{PreparedStatement, Result}
+
+  @cache __MODULE__
+
+  @type query :: %{
+          name: atom(),
+          sql: String.t(),
+          arity: non_neg_integer(),
+          params: [atom()],
+          columns: [Result.column()],
+          as: :tuples | :maps | module(),
+          decode: keyword()
+        }
+
+  defmacro __using__(opts) do
+    external =
+      if schema = Keyword.get(opts, :schema), do: quote(do: @external_resource(unquote(schema)))
+
+    quote do
+      import DuckdbEx.Query, only: [defquery: 2, defquery: 3]
+
+      Module.register_attribute(__MODULE__, :duckdb_ex_queries, accumulate: true)
+      @duckdb_ex_query_opts unquote(opts)
+      @before_compile DuckdbEx.Query
+      unquote(external)
+    end
+  end
+
+  @doc """
+  Declares a query function `name(conn, param1, ..., paramN)`.
+
+  It returns `{:ok, rows}` or `{:error, reason}`.
+  """
+  defmacro defquery(name, sql, opts \\ []) do
+    quote bind_quoted: [name: name, sql: sql, opts: opts] do
+      query = DuckdbEx.Query.__compile__(__MODULE__, name, sql, opts, @duckdb_ex_query_opts)
+      @duckdb_ex_queries query
+
+      args = Macro.generate_arguments(query.arity, __MODULE__)
+      decoder = DuckdbEx.Query.__decoder__(query, __MODULE__)
+
+      def unquote(name)(conn, unquote_splicing(args)) do
+        with {:ok, rows} <- DuckdbEx.Query.run(__MODULE__, unquote(name), conn, unquote(args)) do
+          {:ok, unquote(decoder).(rows)}
+        end
+      end
+    end
+  end
+
+  defmacro __before_compile__(env) do
+    lookups =
+      for query <- Module.get_attribute(env.module, :duckdb_ex_queries) do
+        quote do
+          def __query__(unquote(query.name)), do: unquote(Macro.escape(query))
+        end
+      end
+
+    quote do
+      @doc false
+      def __queries__, do: @duckdb_ex_queries
+
+      @doc false
+      unquote_splicing(lookups)
+      def __query__(_name), do: nil
+
+      @doc """
+      Prepares every query of this module on `conn`, for use by all later calls on it.
+      """
+      @spec prepare_all(DuckdbEx.Connection.t()) :: :ok | {:error, {atom(), String.t()}}
+      def prepare_all(conn), do: DuckdbEx.Query.prepare_all(__MODULE__, conn)
+
+      @doc """
+      Forgets the statements prepared on `conn` by `prepare_all/1`.
+      """
+      @spec release(DuckdbEx.Connection.t()) :: :ok
+      def release(conn), do: DuckdbEx.Query.release(__MODULE__, conn)
+    end
+  end
+
+  @doc false
+  # Runs inside defquery at compile time
+  def __compile__(module, name, sql, opts, use_opts) do
+    as = Keyword.get(opts, :as, :tuples)
+
+    {params, columns} =
+      if Keyword.get(use_opts, :validate, true) do
+        conn = compile_connection(module, use_opts)
+
+        case describe(conn, sql) do
+          {:ok, %{params: params, columns: columns}} ->
+            {params, columns}
+
+          {:error, reason} ->
+            raise CompileError, description: "defquery #{inspect(name)} is invalid: #{reason}"
+        end
+      else
+        unless as == :tuples do
+          raise ArgumentError, "defquery #{inspect(name)}: as: #{inspect(as)} needs validation"
+        end
+
+        {List.duplicate(:unknown, Keyword.fetch!(opts, :params)), []}
+      end
+
+    %{
+      name: name,
+      sql: sql,
+      arity: length(params),
+      params: params,
+      columns: columns,
+      as: as,
+      decode: Keyword.get(opts, :decode, [])
+    }
+  end
+
+  @doc false
+  # Builds `fn rows -> ... end` that turns the row tuples into the `:as` shape. The tuple
+  # size and keys come from the compile-time columns, so no row is inspected at runtime.
+  def __decoder__(%{as: :tuples}, _context), do: quote(do: & &1)
+
+  def __decoder__(%{as: as, columns: columns}, context) do
+    vars = Macro.generate_unique_arguments(length(columns), context)
+    pairs = Enum.zip(Enum.map(columns, &String.to_atom(&1.name)), vars)
+
+    value =
+      case as do
+        :maps -> {:%{}, [], pairs}
+        struct -> {:%, [], [struct, {:%{}, [], pairs}]}
+      end
+
+    quote do
+      fn rows -> Enum.map(rows, fn {unquote_splicing(vars)} -> unquote(value) end) end
+    end
+  end
+
+  @doc false
+  def run(module, name, conn, params) do
+    query = module.__query__(name)
+
+    with {:ok, statement} <- statement(module, query, conn),
+         {:ok, result} <- PreparedStatement.execute(statement, params) do
+      rows = Result.rows_chunked(result, query.decode)
+      Result.destroy(result)
+      {:ok, rows}
+    end
+  end
+
+  @doc false
+  def prepare_all(module, conn) do
+    result =
+      Enum.reduce_while(module.__queries__(), {:ok, %{}}, fn query, {:ok, statements} ->
+        with {:ok, statement} <- PreparedStatement.prepare(conn, query.sql),
+             :ok <- check_columns(statement, query) do
+          {:cont, {:ok, Map.put(statements, query.name, statement)}}
+        else
+          {:error, reason} -> {:halt, {:error, {query.name, reason}}}
+        end
+      end)
+
+    with {:ok, statements} <- result,
+         :ok <- cache_started() do
+      entries = for {name, statement} <- statements, do: {{module, conn, name}, statement}
+      :ets.insert(@cache, entries)
+      :ok
+    end
+  end
+
+  @doc false
+  def release(module, conn) do
+    if cache_started() == :ok,
+      do: :ets.match_delete(@cache, {{module, conn, :_}, :_})
+
+    :ok
+  end
+
+  @doc false
+  # Called when the connection is closed, for the statements of every module
+  def release_connection(conn) do
+    if cache_started() == :ok,
+      do: :ets.match_delete(@cache, {{:_, conn, :_}, :_})
+
+    :ok
+  end
+
+  @doc false
+  def create_cache() do
+    :ets.new(@cache, [:set, :public, :named_table, read_concurrency: true])
+  end
+
+  defp statement(module, %{name: name} = query, conn) do
+    with :ok <- cache_started() do
+      case :ets.lookup(@cache, {module, conn, name}) do
+        [{_key, statement}] -> {:ok, statement}
+        [] -> PreparedStatement.prepare(conn, query.sql)
+      end
+    end
+  end
+
+  defp cache_started() do
+    if :ets.whereis(@cache) == :undefined,
+      do: {:error, "the :duckdb_ex application is not started"},
+      else: :ok
+  end
+
+  # The decoder was generated for the compile-time columns, so a runtime schema that no
+  # longer matches is reported at startup instead of failing on the first row
+  defp check_columns(_statement, %{columns: []}), do: :ok
+
+  defp check_columns(statement, query) do
+    with {:ok, %{columns: columns}} <- PreparedStatement.describe(statement) do
+      expected = Enum.map(query.columns, &{&1.name, &1.type})
+      actual = Enum.map(columns, &{&1.name, &1.type})
+
+      if actual == expected,
+        do: :ok,
+        else: {:error, "result columns #{inspect(actual)} differ from #{inspect(expected)}"}
+    end
+  end
+
+  defp describe(conn, sql) do
+    with {:ok, statement} <- PreparedStatement.prepare(conn, sql) do
+      PreparedStatement.describe(statement)
+    end
+  end
+
+  # One database per compiled module, kept in the compiling process
+  defp compile_connection(module, use_opts) do
+    key = {__MODULE__, :compile_connection, module}
+
+    case Process.get(key) do
+      {_db, conn} ->
+        conn
+
+      nil ->
+        {:ok, db} =
+          case Keyword.get(use_opts, :database) do
+            nil -> DuckdbEx.open()
+            path -> DuckdbEx.open(path, %{"access_mode" => "READ_ONLY"})
+          end
+
+        {:ok, conn} = DuckdbEx.connect(db)
+
+        if schema = Keyword.get(use_opts, :schema) do
+          case DuckdbEx.query(conn, File.read!(schema)) do
+            {:ok, _} -> :ok
+            {:error, reason} -> raise CompileError, description: "#{schema}: #{reason}"
+          end
+        end
+
+        Process.put(key, {db, conn})
+        conn
+    end
+  end
+end
@@ -0,0 +1,54 @@
+defmodule DuckdbEx.Replication do
+  @moduledoc """
+  Mirrors appended batches from a leader database to follower databases.
+
+  The leader is a `DuckdbEx.Replication.Leader` process. Ingestion passes it to
+  `DuckdbEx.Appender.insert_rows/5` with the `:replicate` option. Every batch that the leader
+  flushes successfully gets the next sequence number and is sent to each follower in a compact
+  columnar encoding.
+
+  Followers are `DuckdbEx.Replication.Follower` processes, usually on other nodes. Each one
+  applies batches in sequence order through its own appender. It serves reads while it is no
+  more than a configured time behind the leader.
+
+      {:ok, follower} = DuckdbEx.Replication.Follower.start_link(database: replica_db)
+      {:ok, leader} = DuckdbEx.Replication.Leader.start_link(followers: [follower])
+
+      :ok = DuckdbEx.Appender.insert_rows(conn, nil, "events", rows, replicate: leader)
+
+      {:ok, {_columns, [{count}]}} =
+        DuckdbEx.Replication.Follower.query(follower, "SELECT count(*) FROM events",
+          max_lag: 1_000
+        )
+
+  Followers must start from the same table contents as the leader. A follower added later
+  with `DuckdbEx.Replication.Leader.add_follower/3` passes the sequence number its database
+  already contains and receives the batches after it, as long as the leader still keeps them.
+  Batches lost on the way are sent again on the leader's heartbeat.
+  """
+
+  @doc """
+  Encodes a batch column by column, so that repeated values within a column compress well.
+  """
+  @spec encode_batch(String.t() | nil, String.t(), [[term()]]) :: binary()
+  def encode_batch(schema, table, rows) do
+    columns = Enum.zip_with(rows, & &1)
+    :erlang.term_to_binary({schema, table, length(rows), columns}, compressed: 6)
+  end
+
+  @doc """
+  Decodes a batch produced by `encode_batch/3` back into `{schema, table, rows}`.
+  """
+  @spec decode_batch(binary()) :: {String.t() | nil, String.t(), [[term()]]}
+  def decode_batch(payload) do
+    {schema, table, count, columns} = :erlang.binary_to_term(payload, [:safe])
+
+    rows =
+      case columns do
+        [] -> List.duplicate([], count)
+        columns -> Enum.zip_with(columns, & &1)
+      end
+
+    {schema, table, rows}
+  end
+end
@@ -0,0 +1,169 @@
+defmodule DuckdbEx.Replication.Follower do
+  @moduledoc """
+  Applies replicated batches to a local database and serves reads with bounded lag.
+
+  See `DuckdbEx.Replication`. Batches are applied in sequence order through an appender on the
+  follower's own connection; batches that arrive early are held until the gap is filled.
+
+  A follower is behind when it knows of a sequence number it has not applied, from a batch or
+  a heartbeat. Its lag is the time since it fell behind, zero when it is caught up, so it needs
+  no clock agreement with the leader.
+
+  ## Options
+
+  - `:database` - The follower's database (required)
+  - `:applied_seq` - Sequence number already contained in the database, default `0`
+  - `:name` - Name to register the follower under
+  """
+
+  use GenServer
+
+  require Logger
+
+  alias DuckdbEx.{Appender, Replication, Result}
+
+  @default_max_lag 5_000
+
+  def start_link(opts) do
+    {name, opts} = Keyword.pop(opts, :name)
+    GenServer.start_link(__MODULE__, opts, if(name, do: [name: name], else: []))
+  end
+
+  @doc """
+  Returns the applied and latest known sequence numbers and the lag in milliseconds.
+  """
+  @spec status(GenServer.server()) :: %{
+          applied_seq: non_neg_integer(),
+          leader_seq: non_neg_integer(),
+          lag_ms: non_neg_integer(),
+          failed: nil | {pos_integer(), term()}
+        }
+  def status(follower), do: GenServer.call(follower, :status)
+
+  @doc """
+  Runs a read query on the follower's database when its lag is within `:max_lag`
+  milliseconds (default `5_000`).
+
+  The query runs in the calling process on a connection of its own, so reads do not hold up
+  replication. Returns `{:ok, {columns, rows}}`, or `{:error, {:lagging, lag_ms}}` when the
+  follower is too far behind.
+  """
+  @spec query(GenServer.server(), String.t(), keyword()) ::
+          {:ok, {[Result.column()], [tuple()]}} | {:error, term()}
+  def query(follower, sql, opts \\ []) do
+    max_lag = Keyword.get(opts, :max_lag, @default_max_lag)
+
+    with {:ok, database} <- GenServer.call(follower, {:checkout, max_lag}),
+         {:ok, conn} <- DuckdbEx.connect(database) do
+      try do
+        with {:ok, result} <- DuckdbEx.query(conn, sql) do
+          rows = Result.rows_chunked(result, Keyword.get(opts, :decode, []))
+          columns = Result.columns(result)
+          Result.destroy(result)
+          {:ok, {columns, rows}}
+        end
+      after
+        DuckdbEx.close_connection(conn)
+      end
+    end
+  end
+
+  @impl true
+  def init(opts) do
+    database = Keyword.fetch!(opts, :database)
+    applied = Keyword.get(opts, :applied_seq, 0)
+
+    with {:ok, conn} <- DuckdbEx.connect(database) do
+      {:ok,
+       %{
+         database: database,
+         conn: conn,
+         applied: applied,
+         leader_seq: applied,
+         pending: %{},
+         behind_since: nil,
+         failed: nil
+       }}
+    end
+  end
+
+  @impl true
+  def handle_call(:status, _from, state) do
+    status = %{
+      applied_seq: state.applied,
+      leader_seq: state.leader_seq,
+      lag_ms: lag_ms(state),
+      failed: state.failed
+    }
+
+    {:reply, status, state}
+  end
+
+  def handle_call({:checkout, max_lag}, _from, state) do
+    lag = lag_ms(state)
+
+    cond do
+      state.failed -> {:reply, {:error, {:apply_failed, state.failed}}, state}
+      lag > max_lag -> {:reply, {:error, {:lagging, lag}}, state}
+      true -> {:reply, {:ok, state.database}, state}
+    end
+  end
+
+  @impl true
+  def handle_info({:duckdb_ex_batch, leader, as, seq, payload}, state) do
+    state =
+      if seq > state.applied and is_nil(state.failed),
+        do: %{state | pending: Map.put(state.pending, seq, payload)},
+        else: state
+
+    state = state |> observe(seq) |> apply_pending()
+    send(leader, {:duckdb_ex_ack, as, state.applied})
+    {:noreply, state}
+  end
+
+  def handle_info({:duckdb_ex_heartbeat, leader, as, seq}, state) do
+    state = observe(state, seq)
+    send(leader, {:duckdb_ex_ack, as, state.applied})
+    {:noreply, state}
+  end
+
+  defp observe(state, seq) do
+    state = %{state | leader_seq: max(state.leader_seq, seq)}
+    track_lag(state)
+  end
+
+  # Applies consecutive batches starting right after the applied sequence number
+  defp apply_pending(%{failed: nil} = state) do
+    next = state.applied + 1
+
+    case Map.pop(state.pending, next) do
+      {nil, _} ->
+        track_lag(state)
+
+      {payload, pending} ->
+        {schema, table, rows} = Replication.decode_batch(payload)
+
+        case Appender.insert_rows(state.conn, schema, table, rows) do
+          :ok ->
+            apply_pending(%{state | applied: next, pending: pending})
+
+          {:error, reason} ->
+            Logger.error("Replicated batch #{next} could not be applied: #{inspect(reason)}")
+            %{state | pending: %{}, failed: {next, reason}}
+        end
+    end
+  end
+
+  defp apply_pending(state), do: state
+
+  defp track_lag(%{applied: applied, leader_seq: leader_seq} = state) when applied >= leader_seq,
+    do: %{state | behind_since: nil}
+
+  defp track_lag(%{behind_since: nil} = state),
+    do: %{state | behind_since: System.monotonic_time(:millisecond)}
+
+  defp track_lag(state), do: state
+
+  defp lag_ms(%{behind_since: nil}), do: 0
+  defp lag_ms(%{behind_since: since}), do: System.monotonic_time(:millisecond) - since
+end
@@ -0,0 +1,183 @@
+defmodule DuckdbEx.Replication.Leader do
+  @moduledoc """
+  Sequences flushed append batches and sends them to followers.
+
+  See `DuckdbEx.Replication`. Batches are sent asynchronously and followers acknowledge the
+  last sequence number they applied, which `lag/1` reports. A heartbeat carries the current
+  sequence number, so idle followers can tell whether they have missed a batch.
+
+  The leader keeps every batch some follower has not acknowledged, plus the most recent
+  `:retain` batches for followers added later. On each heartbeat, batches are sent again to
+  followers whose acknowledgement has not moved since the previous heartbeat, so batches
+  lost on the way, for example while a node was disconnected, are recovered. A follower that
+  is never removed keeps its unacknowledged batches in the leader's memory.
+
+  ## Options
+
+  - `:followers` - Follower processes: pids, registered names or `{name, node}` tuples, all
+    starting from sequence number `0`
+  - `:heartbeat` - Milliseconds between heartbeats, default `1_000`
+  - `:retain` - Acknowledged batches kept for followers added later, default `1_000`
+  - `:name` - Name to register the leader under
+  """
+
+  use GenServer
+
+  alias DuckdbEx.Replication
+
+  @default_heartbeat 1_000
+  @default_retain 1_000
+
+  @type follower :: pid() | atom() | {atom(), node()}
+
+  def start_link(opts \\ []) do
+    {name, opts} = Keyword.pop(opts, :name)
+    GenServer.start_link(__MODULE__, opts, if(name, do: [name: name], else: []))
+  end
+
+  @doc """
+  Assigns the next sequence number to a flushed batch and sends it to every follower.
+  """
+  @spec replicate(GenServer.server(), String.t() | nil, String.t(), [[term()]]) ::
+          {:ok, pos_integer()}
+  def replicate(leader, schema, table, rows) do
+    # Encoding runs in the caller so the leader only sequences and sends
+    payload = Replication.encode_batch(schema, table, rows)
+    GenServer.call(leader, {:replicate, payload})
+  end
+
+  @doc """
+  Adds a follower whose database already contains the batches up to `applied_seq`, the
+  follower's `:applied_seq`. The batches after it are sent right away.
+
+  Returns `{:error, :snapshot_required}` when the leader no longer keeps all of those
+  batches; the follower's database must then be seeded from a copy of the leader's first.
+  Returns `{:error, :ahead_of_leader}` when `applied_seq` is past the leader's sequence
+  number.
+  """
+  @spec add_follower(GenServer.server(), follower(), non_neg_integer()) ::
+          :ok | {:error, :snapshot_required | :ahead_of_leader}
+  def add_follower(leader, follower, applied_seq \\ 0)
+      when is_integer(applied_seq) and applied_seq >= 0 do
+    GenServer.call(leader, {:add_follower, follower, applied_seq})
+  end
+
+  @doc """
+  Removes a follower.
+  """
+  @spec remove_follower(GenServer.server(), follower()) :: :ok
+  def remove_follower(leader, follower), do: GenServer.call(leader, {:remove_follower, follower})
+
+  @doc """
+  Returns the leader's sequence number and, per follower, how many batches it has not
+  acknowledged yet.
+  """
+  @spec lag(GenServer.server()) ::
+          %{seq: non_neg_integer(), followers: %{follower() => non_neg_integer()}}
+  def lag(leader), do: GenServer.call(leader, :lag)
+
+  @impl true
+  def init(opts) do
+    heartbeat = Keyword.get(opts, :heartbeat, @default_heartbeat)
+    followers = Map.new(Keyword.get(opts, :followers, []), &{&1, 0})
+    schedule_heartbeat(heartbeat)
+
+    {:ok,
+     %{
+       seq: 0,
+       followers: followers,
+       # Acknowledged sequence numbers as of the previous heartbeat
+       stalled: followers,
+       log: %{},
+       log_start: 1,
+       retain: Keyword.get(opts, :retain, @default_retain),
+       heartbeat: heartbeat
+     }}
+  end
+
+  @impl true
+  def handle_call({:replicate, payload}, _from, state) do
+    seq = state.seq + 1
+
+    Enum.each(Map.keys(state.followers), fn follower ->
+      send(follower, {:duckdb_ex_batch, self(), follower, seq, payload})
+    end)
+
+    state = trim_log(%{state | seq: seq, log: Map.put(state.log, seq, payload)})
+    {:reply, {:ok, seq}, state}
+  end
+
+  def handle_call({:add_follower, follower, applied}, _from, state) do
+    cond do
+      Map.has_key?(state.followers, follower) ->
+        {:reply, :ok, state}
+
+      applied > state.seq ->
+        {:reply, {:error, :ahead_of_leader}, state}
+
+      applied + 1 < state.log_start ->
+        {:reply, {:error, :snapshot_required}, state}
+
+      true ->
+        send_batches(state, follower, applied)
+        followers = Map.put(state.followers, follower, applied)
+        {:reply, :ok, %{state | followers: followers}}
+    end
+  end
+
+  def handle_call({:remove_follower, follower}, _from, state) do
+    {:reply, :ok, trim_log(%{state | followers: Map.delete(state.followers, follower)})}
+  end
+
+  def handle_call(:lag, _from, state) do
+    followers =
+      Map.new(state.followers, fn {follower, acked} -> {follower, state.seq - acked} end)
+
+    {:reply, %{seq: state.seq, followers: followers}, state}
+  end
+
+  @impl true
+  def handle_info({:duckdb_ex_ack, follower, seq}, state) do
+    followers =
+      case state.followers do
+        %{^follower => acked} -> Map.put(state.followers, follower, max(acked, seq))
+        followers -> followers
+      end
+
+    {:noreply, trim_log(%{state | followers: followers})}
+  end
+
+  def handle_info(:heartbeat, state) do
+    Enum.each(state.followers, fn {follower, acked} ->
+      # No progress for a whole heartbeat interval means the batches after it were lost
+      if acked < state.seq and Map.get(state.stalled, follower) == acked,
+        do: send_batches(state, follower, acked)
+
+      send(follower, {:duckdb_ex_heartbeat, self(), follower, state.seq})
+    end)
+
+    schedule_heartbeat(state.heartbeat)
+    {:noreply, %{state | stalled: state.followers}}
+  end
+
+  defp send_batches(state, follower, after_seq) do
+    Enum.each((after_seq + 1)..state.seq//1, fn seq ->
+      send(follower, {:duckdb_ex_batch, self(), follower, seq, Map.fetch!(state.log, seq)})
+    end)
+  end
+
+  # Drops the batches every follower acknowledged, except for the most recent `:retain`
+  defp trim_log(state) do
+    min_acked = state.followers |> Map.values() |> Enum.min(fn -> state.seq end)
+    log_start = max(min(min_acked + 1, state.seq + 1 - state.retain), state.log_start)
+
+    if log_start == state.log_start do
+      state
+    else
+      log = Map.drop(state.log, Enum.to_list(state.log_start..(log_start - 1)//1))
+      %{state | log: log, log_start: log_start}
+    end
+  end
+
+  defp schedule_heartbeat(interval), do: Process.send_after(self(), :heartbeat, interval)
+end
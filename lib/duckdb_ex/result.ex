@@ -5,26 +5,114 @@ defmodule DuckdbEx.Result do
 
   @type t :: reference()
 
+  @typedoc """
+  Options controlling how chunks are decoded into Elixir terms.
+
+  - `:dedup_strings` - Reuse one binary for repeated VARCHAR values of a
+    top-level column. `true` remembers up to 1024 distinct values per
+    column, an integer sets that cutoff (at most 1_048_576). Columns that
+    exceed it fall back to plain copies. The dictionaries span the whole
+    result, also across `next_chunk/2` calls; values of up to 64 bytes,
+    which the VM copies between calls, are shared within each chunk.
+    Defaults to `false`.
+  - `:uuid` - `:string` (default) for the canonical 36 character form, `:raw`
+    for the 16-byte binary, as produced by `Ecto.UUID.dump/1`
+  - `:temporal` - `:native` (default) for `Date`, `Time` and UTC `DateTime`
+    values, `:raw` for plain integers in the column's storage unit: days
+    since 1970-01-01 for DATE, microseconds since midnight for TIME,
+    seconds, milliseconds, microseconds or nanoseconds since the epoch for
+    the TIMESTAMP variants. INTERVAL is always `{months, days, micros}`.
+  - `:numeric_lists` - `:list` (default) or `:packed` to return LIST and
+    ARRAY cells of integers, FLOAT or DOUBLE as one binary of native-endian
+    elements, e.g. `for <<x::float-32-native <- bin>>, do: x` for
+    `FLOAT[384]`. Cells containing a NULL element are returned as lists.
+    Packed cells keep NaN and infinities as their raw IEEE 754 bits.
+  - `:nan` - `:atom` (default) returns NaN and infinite FLOAT and DOUBLE
+    values as `:nan`, `:infinity` and `:negative_infinity`, as `Result.rows/1`
+    does; `nil` returns them as `nil`.
+  - `:json` - `:string` (default) for the text of JSON columns, `:decode` to
+    parse it into maps, lists, strings, numbers, booleans and `nil`. Text
+    that does not parse is returned unchanged. Integers of any size become
+    integers; numbers outside the float range, and integers of more than
+    1024 digits, are kept as their text.
+  - `:json_keys` - atoms (at most 64) whose names are returned as atom
+    keys when decoding JSON objects; all other keys stay binaries. No new
+    atoms are ever created.
+  """
+  @type decode_opts :: [
+          dedup_strings: boolean() | pos_integer(),
+          uuid: :string | :raw,
+          temporal: :native | :raw,
+          numeric_lists: :list | :packed,
+          nan: :atom | nil,
+          json: :string | :decode,
+          json_keys: [atom()]
+        ]
+
+  @default_dedup_cardinality 1024
+  @max_dedup_cardinality 1_048_576
+  @max_json_keys 64
+
+  @typedoc """
+  Nested description of a column's logical type.
+
+  Every descriptor has a `:type` atom. Parameterized types add:
+
+  - `:decimal` - `:width` and `:scale`
+  - `:list` - `:child`, the element descriptor
+  - `:array` - `:child` and the fixed `:size`
+  - `:struct` - `:fields`, an ordered list of `{name, descriptor}`
+  - `:map` - `:key` and `:value` descriptors
+  - `:enum` - `:values`, the dictionary in order
+  - `:union` - `:members`, an ordered list of `{tag, descriptor}`
+
+  Aliased types, such as `JSON`, also carry their `:alias`.
+  """
+  @type logical_type :: %{required(:type) => atom(), optional(atom()) => term()}
+
+  @type column :: %{
+          required(:name) => String.t(),
+          required(:type) => atom(),
+          optional(:logical_type) => logical_type()
+        }
+
   @doc """
   Gets column information from a result.
+
+  ## Options
+
+  - `:types` - `:simple` (default) for the top-level type atom only, `:full`
+    to add a `:logical_type` descriptor to each column, see
+    `t:logical_type/0`. The full descriptors are built once and cached on
+    the result.
   """
-  @spec columns(t()) :: [%{name: String.t(), type: atom()}]
-  def columns(result) do
-    DuckdbEx.Nif.result_columns(result)
+  @spec columns(t(), types: :simple | :full) :: [column()] | {:error, String.t()}
+  def columns(result, opts \\ []) do
+    case Keyword.get(opts, :types, :simple) do
+      :simple -> DuckdbEx.Nif.result_columns(result)
+      :full -> DuckdbEx.Nif.result_columns_full(result)
+    end
   end
 
   @doc """
   Gets all rows from a result.
+
+  Values are decoded to their final Elixir terms by the NIF: `Date`, `Time`
+  and UTC `DateTime` structs, integers of any size for HUGEINT and UHUGEINT.
+  Streaming results are consumed: only the rows not yet fetched are returned.
   """
-  @spec rows(t()) :: [tuple()]
+  @spec rows(t()) :: [tuple()] | {:error, String.t()}
   def rows(result) do
     DuckdbEx.Nif.result_rows(result)
   end
 
   @doc """
   Gets the number of rows in a result.
+
+  For streaming results this is the number of rows buffered while the query
+  was checked against its limits, as the total is not known upfront.
   """
-  @spec row_count(t()) :: non_neg_integer()
+  @spec row_count(t()) :: non_neg_integer() | {:error, String.t()}
   def row_count(result) do
     DuckdbEx.Nif.result_row_count(result)
   end
@@ -32,50 +120,75 @@ defmodule DuckdbEx.Result do
   @doc """
   Gets the number of columns in a result.
   """
-  @spec column_count(t()) :: non_neg_integer()
+  @spec column_count(t()) :: non_neg_integer() | {:error, String.t()}
   def column_count(result) do
     DuckdbEx.Nif.result_column_count(result)
   end
 
   @doc """
   Destroys a result and frees its resources.
+
+  The memory is released immediately instead of when the result reference is
+  garbage collected. Any later call on the result, or on chunks taken from it,
+  returns `{:error, "Result has been destroyed"}`. Destroying a result twice is
+  a no-op.
   """
   @spec destroy(t()) :: :ok
-  def destroy(_result) do
-    # Result cleanup is handled by the NIF resource destructor
-    :ok
+  def destroy(result) do
+    DuckdbEx.Nif.result_destroy(result)
   end
 
   @doc """
-  Gets all rows from a result using the chunked API.
-  This provides better support for complex types like arrays and lists.
+  Fetches the rows of the next chunk of a result.
+
+  Works on every result; streaming results are consumed as they are read.
+  Returns `:done` once all chunks have been fetched. See `t:decode_opts/0`.
   """
-  @spec rows_chunked(t()) :: [tuple()]
-  def rows_chunked(result) do
-    chunk_count = DuckdbEx.Nif.result_chunk_count(result)
-
-    # Handle case where there are no chunks
-    if chunk_count == 0 do
-      []
-    else
-      # Collect rows from all chunks
-      all_rows =
-        for chunk_idx <- 0..(chunk_count - 1) do
-          case DuckdbEx.Nif.result_get_chunk(result, chunk_idx) do
-            {:ok, chunk} -> DuckdbEx.Nif.data_chunk_get_data(chunk)
-            {:error, _reason} -> []
-          end
+  @spec next_chunk(t(), decode_opts()) :: {:ok, [tuple()]} | :done | {:error, String.t()}
+  def next_chunk(result, opts \\ []) do
+    DuckdbEx.Nif.result_fetch_chunk(result, decode_options(opts))
+  end
+
+  @doc """
+  Returns a lazy stream of the rows of a result, fetched one chunk at a time.
+
+  Raises if the result is destroyed or the query fails while streaming.
+  """
+  @spec stream(t(), decode_opts()) :: Enumerable.t()
+  def stream(result, opts \\ []) do
+    Stream.resource(
+      fn -> result end,
+      fn result ->
+        case next_chunk(result, opts) do
+          {:ok, rows} -> {rows, result}
+          :done -> {:halt, result}
+          {:error, reason} -> raise RuntimeError, "Failed to fetch chunk: #{reason}"
         end
+      end,
+      fn _result -> :ok end
+    )
+  end
 
-      # Flatten the list of chunks into a single list of rows
-      List.flatten(all_rows)
-    end
+  @doc """
+  Gets all rows from a result using the chunked API.
+  This provides better support for complex types like arrays and lists.
+
+  All chunks are decoded by a single NIF call that builds the final row list
+  directly, rescheduling itself between chunks. With `dedup_strings: true`
+  repeated strings share one binary across the whole result, see
+  `t:decode_opts/0`.
+  """
+  @spec rows_chunked(t(), decode_opts()) :: [tuple()] | {:error, String.t()}
+  def rows_chunked(result, opts \\ []) do
+    DuckdbEx.Nif.result_rows_chunked(result, decode_options(opts))
   end
 
   @doc """
   Gets the number of chunks in a result.
+
+  Streaming results report `0`; use `next_chunk/1` to read them.
   """
-  @spec chunk_count(t()) :: non_neg_integer()
+  @spec chunk_count(t()) :: non_neg_integer() | {:error, String.t()}
   def chunk_count(result) do
     DuckdbEx.Nif.result_chunk_count(result)
   end
@@ -87,4 +200,43 @@ defmodule DuckdbEx.Result do
   def get_chunk(result, chunk_index) do
     DuckdbEx.Nif.result_get_chunk(result, chunk_index)
   end
+
+  defp decode_options(opts) do
+    Enum.reduce(opts, %{}, fn
+      {:dedup_strings, true}, acc ->
+        Map.put(acc, :dedup_strings, @default_dedup_cardinality)
+
+      {:dedup_strings, false}, acc ->
+        acc
+
+      {:dedup_strings, limit}, acc
+      when is_integer(limit) and limit > 0 and limit <= @max_dedup_cardinality ->
+        Map.put(acc, :dedup_strings, limit)
+
+      {:uuid, mode}, acc when mode in [:string, :raw] ->
+        Map.put(acc, :uuid, mode)
+
+      {:temporal, mode}, acc when mode in [:native, :raw] ->
+        Map.put(acc, :temporal, mode)
+
+      {:numeric_lists, mode}, acc when mode in [:list, :packed] ->
+        Map.put(acc, :numeric_lists, mode)
+
+      {:nan, mode}, acc when mode in [:atom, nil] ->
+        Map.put(acc, :nan, mode)
+
+      {:json, mode}, acc when mode in [:string, :decode] ->
+        Map.put(acc, :json, mode)
+
+      {:json_keys, keys}, acc when is_list(keys) and length(keys) <= @max_json_keys ->
+        unless Enum.all?(keys, &is_atom/1) do
+          raise ArgumentError, "invalid decode option :json_keys: #{inspect(keys)}"
+        end
+
+        Map.put(acc, :json_keys, keys)
+
+      {key, value}, _acc ->
+        raise ArgumentError, "invalid decode option #{inspect(key)}: #{inspect(value)}"
+    end)
+  end
 end
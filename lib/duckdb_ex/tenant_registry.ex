@@ -0,0 +1,378 @@
+defmodule DuckdbEx.TenantRegistry do
+  @moduledoc """
+  Maps tenant IDs to file-backed databases, opened on first use and closed when idle.
+
+  `checkout/2` opens the tenant's database if needed and returns a new connection to it.
+  The database counts as in use until the caller calls `checkin/2` or exits, which closes
+  the connection. When more than `:max_open` databases are open, or their memory exceeds
+  `:memory_budget`, idle databases are closed in least recently used order. Each one is
+  checkpointed first, so its WAL is folded into the database file, and then closed right
+  away, so its file and memory are released before the tenant can be opened again.
+  Databases are opened and closed in tasks, so a slow file never holds up checkouts of
+  other tenants; a database being closed still counts as open in `stats/1` and `open?/2`.
+
+      children = [
+        {DuckdbEx.TenantRegistry,
+         name: MyApp.Tenants, dir: "/var/lib/tenants", max_open: 256,
+         memory_budget: 2_000_000_000}
+      ]
+
+      DuckdbEx.TenantRegistry.with_tenant(MyApp.Tenants, "acme", fn conn ->
+        DuckdbEx.query(conn, "SELECT count(*) FROM orders")
+      end)
+
+  Connections must not be used after they are checked in. Results read through them may
+  still be in use when the database is evicted; such a result keeps the database's memory
+  until it is destroyed.
+
+  ## Options
+
+  - `:dir` - Directory holding one `<tenant>.duckdb` file per tenant
+  - `:path` - Function from tenant ID to database path, instead of `:dir`
+  - `:max_open` - Maximum number of open databases, default `128`
+  - `:memory_budget` - Maximum bytes used by all open databases, measured with
+    `duckdb_memory()` when a tenant is checked in. Default `nil`, no limit.
+  - `:config` - Configuration map passed to `DuckdbEx.open/2`, e.g. `%{"memory_limit" => "64MB"}`
+  - `:name` - Name to register the registry under
+  """
+
+  use GenServer
+
+  require Logger
+
+  @default_max_open 128
+
+  @memory_sql "SELECT coalesce(sum(memory_usage_bytes), 0)::BIGINT FROM duckdb_memory()"
+
+  def start_link(opts) do
+    {name, opts} = Keyword.pop(opts, :name)
+    GenServer.start_link(__MODULE__, opts, if(name, do: [name: name], else: []))
+  end
+
+  @doc """
+  Returns a connection to the tenant's database, opening the database if it is not open.
+  """
+  @spec checkout(GenServer.server(), term()) :: {:ok, DuckdbEx.Connection.t()} | {:error, term()}
+  def checkout(registry, tenant), do: GenServer.call(registry, {:checkout, tenant}, :infinity)
+
+  @doc """
+  Releases and closes the connection the calling process most recently obtained for the
+  tenant with `checkout/2`.
+  """
+  @spec checkin(GenServer.server(), term()) :: :ok
+  def checkin(registry, tenant), do: GenServer.call(registry, {:checkin, tenant})
+
+  @doc """
+  Runs `fun` with a connection to the tenant's database and checks it back in afterwards.
+  """
+  @spec with_tenant(GenServer.server(), term(), (DuckdbEx.Connection.t() -> result)) ::
+          result | {:error, term()}
+        when result: term()
+  def with_tenant(registry, tenant, fun) do
+    with {:ok, conn} <- checkout(registry, tenant) do
+      try do
+        fun.(conn)
+      after
+        checkin(registry, tenant)
+      end
+    end
+  end
+
+  @doc """
+  Returns the number of open and in-use databases and their last measured memory.
+  """
+  @spec stats(GenServer.server()) :: %{
+          open: non_neg_integer(),
+          in_use: non_neg_integer(),
+          memory: non_neg_integer()
+        }
+  def stats(registry), do: GenServer.call(registry, :stats)
+
+  @doc """
+  Returns whether the tenant's database is currently open.
+  """
+  @spec open?(GenServer.server(), term()) :: boolean()
+  def open?(registry, tenant), do: GenServer.call(registry, {:open?, tenant})
+
+  @impl true
+  def init(opts) do
+    Process.flag(:trap_exit, true)
+
+    path =
+      case Keyword.fetch(opts, :path) do
+        {:ok, fun} when is_function(fun, 1) ->
+          fun
+
+        :error ->
+          dir = Keyword.fetch!(opts, :dir)
+          File.mkdir_p!(dir)
+          &Path.join(dir, "#{&1}.duckdb")
+      end
+
+    {:ok,
+     %{
+       path: path,
+       config: Keyword.get(opts, :config),
+       max_open: Keyword.get(opts, :max_open, @default_max_open),
+       memory_budget: Keyword.get(opts, :memory_budget),
+       tenants: %{},
+       holders: %{},
+       # Tenants being opened or closed by a task, with the checkouts waiting for them
+       pending: %{},
+       tick: 0
+     }}
+  end
+
+  @impl true
+  def handle_call({:checkout, tenant}, from, state) do
+    case state do
+      %{tenants: %{^tenant => _}} ->
+        {reply, state} = check_out(tenant, from, state)
+        {:reply, reply, evict(state)}
+
+      %{pending: %{^tenant => pending}} ->
+        pending = %{pending | waiters: [from | pending.waiters]}
+        {:noreply, %{state | pending: Map.put(state.pending, tenant, pending)}}
+
+      _ ->
+        {:noreply, start_open(tenant, [from], state)}
+    end
+  end
+
+  def handle_call({:checkin, tenant}, {pid, _}, state) do
+    # The latest checkout goes first, so nested checkouts of one tenant unwind in order
+    held = for {ref, {^pid, ^tenant, _conn, tick}} <- state.holders, do: {ref, tick}
+
+    case held do
+      [] ->
+        {:reply, :ok, state}
+
+      held ->
+        {ref, _tick} = Enum.max_by(held, fn {_ref, tick} -> tick end)
+        Process.demonitor(ref, [:flush])
+        {:reply, :ok, release(ref, state)}
+    end
+  end
+
+  def handle_call(:stats, _from, state) do
+    entries = Map.values(state.tenants)
+
+    stats = %{
+      open: length(entries) + closing_count(state),
+      in_use: Enum.count(entries, &(&1.in_use > 0)),
+      memory: total_memory(state)
+    }
+
+    {:reply, stats, state}
+  end
+
+  def handle_call({:open?, tenant}, _from, state) do
+    open =
+      Map.has_key?(state.tenants, tenant) or
+        match?(%{^tenant => %{action: :close}}, state.pending)
+
+    {:reply, open, state}
+  end
+
+  @impl true
+  def handle_info({ref, result}, state) when is_reference(ref) do
+    case pending_tenant(ref, state) do
+      nil ->
+        {:noreply, state}
+
+      tenant ->
+        Process.demonitor(ref, [:flush])
+        {:noreply, finish(tenant, result, state)}
+    end
+  end
+
+  def handle_info({:DOWN, ref, :process, _pid, reason}, state) do
+    case pending_tenant(ref, state) do
+      nil -> {:noreply, release(ref, state)}
+      tenant -> {:noreply, finish(tenant, {:error, {:task_failed, reason}}, state)}
+    end
+  end
+
+  def handle_info(_message, state), do: {:noreply, state}
+
+  @impl true
+  def terminate(_reason, state) do
+    Enum.each(state.tenants, fn {tenant, entry} -> checkpoint(tenant, entry) end)
+
+    for {_tenant, %{action: :close, task: task}} <- state.pending do
+      Task.yield(task, :infinity)
+    end
+  end
+
+  # Opening a file and checkpointing it on eviction can take long, so both run in a task
+  # while the registry keeps serving other tenants. Checkouts of the tenant wait for the
+  # task; one arriving while the tenant is closed reopens it afterwards.
+  defp start_open(tenant, waiters, state) do
+    %{path: path, config: config} = state
+
+    task =
+      Task.async(fn ->
+        path = path.(tenant)
+        open = if config, do: DuckdbEx.open(path, config), else: DuckdbEx.open(path)
+
+        with {:ok, db} <- open do
+          case DuckdbEx.connect(db) do
+            {:ok, conn} ->
+              {:ok, db, conn}
+
+            {:error, reason} ->
+              DuckdbEx.close_database(db)
+              {:error, reason}
+          end
+        end
+      end)
+
+    pending = %{action: :open, task: task, waiters: waiters}
+    %{state | pending: Map.put(state.pending, tenant, pending)}
+  end
+
+  defp start_close(tenant, entry, state) do
+    task =
+      Task.async(fn ->
+        checkpoint(tenant, entry)
+        # Every checked out connection was closed on checkin, so this releases the database
+        DuckdbEx.close_connection(entry.conn)
+        DuckdbEx.close_database(entry.db)
+      end)
+
+    pending = %{action: :close, task: task, waiters: []}
+    %{state | pending: Map.put(state.pending, tenant, pending)}
+  end
+
+  defp pending_tenant(ref, state) do
+    Enum.find_value(state.pending, fn {tenant, pending} ->
+      if pending.task.ref == ref, do: tenant
+    end)
+  end
+
+  defp finish(tenant, result, state) do
+    {pending, state} = pop_in(state.pending[tenant])
+    # Waiters arrived last first
+    waiters = Enum.reverse(pending.waiters)
+
+    case {pending.action, result} do
+      {:open, {:ok, db, conn}} ->
+        entry = %{db: db, conn: conn, in_use: 0, last_used: state.tick, memory: 0}
+        state = %{state | tenants: Map.put(state.tenants, tenant, entry)}
+
+        state =
+          Enum.reduce(waiters, state, fn from, state ->
+            {reply, state} = check_out(tenant, from, state)
+            GenServer.reply(from, reply)
+            state
+          end)
+
+        evict(state)
+
+      {:open, {:error, reason}} ->
+        Enum.each(waiters, &GenServer.reply(&1, {:error, reason}))
+        state
+
+      {:close, _result} when waiters != [] ->
+        start_open(tenant, waiters, state)
+
+      {:close, _result} ->
+        state
+    end
+  end
+
+  defp check_out(tenant, {pid, _tag}, state) do
+    entry = Map.fetch!(state.tenants, tenant)
+
+    case DuckdbEx.connect(entry.db) do
+      {:ok, conn} ->
+        ref = Process.monitor(pid)
+        entry = %{entry | in_use: entry.in_use + 1, last_used: state.tick}
+
+        state = %{
+          state
+          | tenants: Map.put(state.tenants, tenant, entry),
+            holders: Map.put(state.holders, ref, {pid, tenant, conn, state.tick}),
+            tick: state.tick + 1
+        }
+
+        {{:ok, conn}, state}
+
+      {:error, reason} ->
+        {{:error, reason}, state}
+    end
+  end
+
+  defp release(ref, state) do
+    case Map.pop(state.holders, ref) do
+      {nil, _} ->
+        state
+
+      {{_pid, tenant, conn, _tick}, holders} ->
+        DuckdbEx.close_connection(conn)
+        entry = Map.fetch!(state.tenants, tenant)
+        entry = %{entry | in_use: entry.in_use - 1, memory: memory(entry, state)}
+        evict(%{state | holders: holders, tenants: Map.put(state.tenants, tenant, entry)})
+    end
+  end
+
+  defp memory(_entry, %{memory_budget: nil}), do: 0
+
+  defp memory(entry, _state) do
+    with {:ok, result} <- DuckdbEx.query(entry.conn, @memory_sql) do
+      rows = DuckdbEx.Result.rows_chunked(result)
+      DuckdbEx.Result.destroy(result)
+
+      case rows do
+        [{bytes}] -> bytes
+        _ -> entry.memory
+      end
+    else
+      _ -> entry.memory
+    end
+  end
+
+  # Hands idle databases to closing tasks, least recently used first, until both limits hold
+  # or only databases in use remain
+  defp evict(state) do
+    if over_limits?(state) do
+      idle = for {tenant, %{in_use: 0} = entry} <- state.tenants, do: {tenant, entry}
+
+      case idle do
+        [] ->
+          state
+
+        idle ->
+          {tenant, entry} = Enum.min_by(idle, fn {_tenant, entry} -> entry.last_used end)
+          state = %{state | tenants: Map.delete(state.tenants, tenant)}
+          evict(start_close(tenant, entry, state))
+      end
+    else
+      state
+    end
+  end
+
+  defp over_limits?(state) do
+    map_size(state.tenants) > state.max_open or
+      (state.memory_budget != nil and total_memory(state) > state.memory_budget)
+  end
+
+  defp total_memory(state) do
+    state.tenants |> Map.values() |> Enum.map(& &1.memory) |> Enum.sum()
+  end
+
+  defp closing_count(state) do
+    Enum.count(state.pending, fn {_tenant, pending} -> pending.action == :close end)
+  end
+
+  defp checkpoint(tenant, entry) do
+    case DuckdbEx.query(entry.conn, "CHECKPOINT") do
+      {:ok, result} ->
+        DuckdbEx.Result.destroy(result)
+        :ok
+
+      {:error, reason} ->
+        Logger.warning("Checkpoint of tenant #{inspect(tenant)} failed: #{reason}")
+    end
+  end
+end
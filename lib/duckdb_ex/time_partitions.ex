@@ -0,0 +1,404 @@
+defmodule DuckdbEx.TimePartitions do
+  @moduledoc """
+  Appends rows into hourly or daily tables and moves old partitions to Parquet files.
+
+  Rows go into one table per partition of the time column, e.g. `events_p20240131` for daily
+  partitions. Once a partition has ended more than `:hot_for` seconds ago, `rotate/2` copies
+  it to a zstd Parquet file in `:cold_dir`, drops the table and checkpoints. Recent data stays
+  in the database while the file and checkpoint times stay small. Rotation runs every
+  `:rotate_interval` milliseconds.
+
+  A view named after the table unions the hot tables with `read_parquet` over the cold files,
+  so queries don't need to know where a row lives:
+
+      {:ok, events} =
+        DuckdbEx.TimePartitions.start_link(
+          connection: conn,
+          table: "events",
+          columns: "ts TIMESTAMP, user_id BIGINT, kind VARCHAR",
+          time_column: "ts",
+          granularity: :hour,
+          cold_dir: "/var/lib/events"
+        )
+
+      :ok = DuckdbEx.TimePartitions.insert_rows(events, [[~U[2024-01-31 10:15:00Z], 1, "click"]])
+      DuckdbEx.query(conn, "SELECT count(*) FROM events WHERE ts > now() - INTERVAL 1 DAY")
+
+  The time column takes `DateTime` (converted to UTC), `NaiveDateTime` or `Date` values. A
+  row that arrives after its partition was rotated creates the partition table again. The
+  next rotation writes it to a second file.
+
+  ## Options
+
+  - `:connection` - Connection used for all statements (required)
+  - `:table` - Name of the view; partitions are named `<table>_p<partition>` (required)
+  - `:columns` - Column definitions of the partitions (required)
+  - `:time_column` - Column the rows are partitioned by (required)
+  - `:cold_dir` - Directory for the Parquet files (required)
+  - `:granularity` - `:hour` or `:day`, default `:day`
+  - `:hot_for` - Seconds a partition stays in the database after it ends, default `86_400`
+  - `:rotate_interval` - Milliseconds between rotations, default `60_000`, or `nil`
+  - `:name` - Name to register the process under
+  """
+
+  use GenServer
+
+  require Logger
+
+  alias DuckdbEx.{Appender, Result}
+
+  @default_hot_for 86_400
+  @default_rotate_interval 60_000
+
+  def start_link(opts) do
+    {name, opts} = Keyword.pop(opts, :name)
+    GenServer.start_link(__MODULE__, opts, if(name, do: [name: name], else: []))
+  end
+
+  @doc """
+  Appends rows to the partitions of their time column values.
+  """
+  @spec insert_rows(GenServer.server(), [[term()]]) :: :ok | {:error, String.t()}
+  def insert_rows(server, rows), do: GenServer.call(server, {:insert_rows, rows}, :infinity)
+
+  @doc """
+  Moves the partitions that ended more than `:hot_for` seconds before `now` to Parquet.
+
+  Returns the names of the partition tables that were moved.
+  """
+  @spec rotate(GenServer.server(), DateTime.t()) :: {:ok, [String.t()]} | {:error, String.t()}
+  def rotate(server, now \\ DateTime.utc_now()),
+    do: GenServer.call(server, {:rotate, now}, :infinity)
+
+  @doc """
+  Returns the hot partition tables and the cold Parquet files.
+  """
+  @spec partitions(GenServer.server()) :: %{hot: [String.t()], cold: [Path.t()]}
+  def partitions(server), do: GenServer.call(server, :partitions)
+
+  @impl true
+  def init(opts) do
+    state = %{
+      conn: Keyword.fetch!(opts, :connection),
+      table: Keyword.fetch!(opts, :table),
+      columns: Keyword.fetch!(opts, :columns),
+      time_column: Keyword.fetch!(opts, :time_column),
+      cold_dir: Keyword.fetch!(opts, :cold_dir),
+      granularity: Keyword.get(opts, :granularity, :day),
+      hot_for: Keyword.get(opts, :hot_for, @default_hot_for),
+      rotate_interval: Keyword.get(opts, :rotate_interval, @default_rotate_interval),
+      time_index: nil,
+      hot: MapSet.new()
+    }
+
+    unless state.granularity in [:hour, :day] do
+      raise ArgumentError, "granularity must be :hour or :day, got: #{inspect(state.granularity)}"
+    end
+
+    File.mkdir_p!(state.cold_dir)
+
+    create = "CREATE TABLE IF NOT EXISTS #{template(state)} (#{state.columns})"
+
+    with :ok <- execute(state, create),
+         {:ok, time_index} <- time_index(state),
+         {:ok, hot} <- existing_partitions(state),
+         state = %{state | time_index: time_index, hot: hot},
+         :ok <- refresh_view(state) do
+      schedule_rotation(state)
+      {:ok, state}
+    else
+      {:error, reason} -> {:stop, reason}
+    end
+  end
+
+  @impl true
+  def handle_call({:insert_rows, rows}, _from, state) do
+    groups = Enum.group_by(rows, &partition_key(Enum.at(&1, state.time_index), state))
+
+    case insert_groups(groups, state) do
+      {:ok, state} -> {:reply, :ok, state}
+      {:error, reason, state} -> {:reply, {:error, reason}, state}
+    end
+  rescue
+    error in ArgumentError -> {:reply, {:error, Exception.message(error)}, state}
+  end
+
+  def handle_call({:rotate, now}, _from, state) do
+    case rotate_partitions(now, state) do
+      {:ok, rotated, state} -> {:reply, {:ok, rotated}, state}
+      {:error, reason, state} -> {:reply, {:error, reason}, state}
+    end
+  end
+
+  def handle_call(:partitions, _from, state) do
+    hot = state.hot |> Enum.sort() |> Enum.map(&partition_table(&1, state))
+    {:reply, %{hot: hot, cold: cold_files(state)}, state}
+  end
+
+  @impl true
+  def handle_info(:rotate, state) do
+    state =
+      case rotate_partitions(DateTime.utc_now(), state) do
+        {:ok, _rotated, state} ->
+          state
+
+        {:error, reason, state} ->
+          Logger.warning("Rotating partitions of #{state.table} failed: #{reason}")
+          state
+      end
+
+    schedule_rotation(state)
+    {:noreply, state}
+  end
+
+  def handle_info(_message, state), do: {:noreply, state}
+
+  defp schedule_rotation(%{rotate_interval: nil}), do: :ok
+  defp schedule_rotation(state), do: Process.send_after(self(), :rotate, state.rotate_interval)
+
+  defp insert_groups(groups, state) do
+    Enum.reduce_while(groups, {:ok, state}, fn {key, rows}, {:ok, state} ->
+      with {:ok, state} <- ensure_partition(key, state),
+           :ok <- Appender.insert_rows(state.conn, nil, partition_table(key, state), rows) do
+        {:cont, {:ok, state}}
+      else
+        {:error, reason} -> {:halt, {:error, reason, state}}
+        {:error, _reason, _state} = error -> {:halt, error}
+      end
+    end)
+  end
+
+  defp ensure_partition(key, state) do
+    if MapSet.member?(state.hot, key) do
+      {:ok, state}
+    else
+      sql =
+        "CREATE TABLE IF NOT EXISTS #{quote_identifier(partition_table(key, state))} " <>
+          "(#{state.columns})"
+
+      state = %{state | hot: MapSet.put(state.hot, key)}
+
+      with :ok <- execute(state, sql),
+           :ok <- refresh_view(state) do
+        {:ok, state}
+      else
+        {:error, reason} -> {:error, reason, %{state | hot: MapSet.delete(state.hot, key)}}
+      end
+    end
+  end
+
+  defp rotate_partitions(now, state) do
+    cutoff = DateTime.add(now, -state.hot_for, :second) |> DateTime.to_naive()
+
+    expired =
+      state.hot
+      |> Enum.filter(&(NaiveDateTime.compare(partition_end(&1, state), cutoff) != :gt))
+      |> Enum.sort()
+
+    result =
+      Enum.reduce_while(expired, {:ok, [], state}, fn key, {:ok, rotated, state} ->
+        case export_partition(key, state) do
+          :ok ->
+            state = %{state | hot: MapSet.delete(state.hot, key)}
+            {:cont, {:ok, [partition_table(key, state) | rotated], state}}
+
+          {:error, reason} ->
+            {:halt, {:error, reason, state}}
+        end
+      end)
+
+    case result do
+      {:ok, [], state} ->
+        {:ok, [], state}
+
+      {:ok, rotated, state} ->
+        with :ok <- refresh_view(state), :ok <- execute(state, "CHECKPOINT") do
+          {:ok, Enum.reverse(rotated), state}
+        else
+          {:error, reason} -> {:error, reason, state}
+        end
+
+      {:error, reason, state} ->
+        # Partitions rotated before the failure are already gone from the database
+        refresh_view(state)
+        {:error, reason, state}
+    end
+  end
+
+  # The file is written under a temporary name and renamed, so a failed COPY never leaves a
+  # partial file that the view would read
+  defp export_partition(key, state) do
+    table = partition_table(key, state)
+    path = cold_path(table, state)
+    tmp = path <> ".tmp"
+
+    copy =
+      "COPY #{quote_identifier(table)} TO '#{quote_literal(tmp)}' " <>
+        "(FORMAT parquet, COMPRESSION zstd)"
+
+    with :ok <- execute(state, copy),
+         :ok <- publish(tmp, path),
+         :ok <- drop_exported(table, path, state) do
+      :ok
+    else
+      {:error, reason} ->
+        File.rm(tmp)
+        {:error, reason}
+    end
+  end
+
+  defp publish(tmp, path) do
+    case File.rename(tmp, path) do
+      :ok -> :ok
+      {:error, reason} -> {:error, "Cannot move #{tmp} to #{path}: #{:file.format_error(reason)}"}
+    end
+  end
+
+  # While both exist the view would read the partition's rows twice, and the next rotation
+  # would export it again, so the file is withdrawn when the table stays
+  defp drop_exported(table, path, state) do
+    with {:error, _reason} = error <- execute(state, "DROP TABLE #{quote_identifier(table)}") do
+      File.rm(path)
+      error
+    end
+  end
+
+  # Late rows for an already rotated partition go to a numbered second file
+  defp cold_path(table, state) do
+    Stream.iterate(0, &(&1 + 1))
+    |> Stream.map(fn
+      0 -> Path.join(state.cold_dir, "#{table}.parquet")
+      n -> Path.join(state.cold_dir, "#{table}_#{n}.parquet")
+    end)
+    |> Enum.find(&(not File.exists?(&1)))
+  end
+
+  defp cold_files(state) do
+    # Anchored on the partition key, so other tables' exports such as `<table>_pageviews_p...`
+    # in the same directory are left out
+    name = ~r/^#{Regex.escape(state.table)}_p\d{8}(\d{2})?(_\d+)?\.parquet$/
+
+    case File.ls(state.cold_dir) do
+      {:ok, files} ->
+        files
+        |> Enum.filter(&Regex.match?(name, &1))
+        |> Enum.sort()
+        |> Enum.map(&Path.join(state.cold_dir, &1))
+
+      {:error, _} ->
+        []
+    end
+  end
+
+  defp refresh_view(state) do
+    hot =
+      state.hot
+      |> Enum.sort()
+      |> Enum.map(&"SELECT * FROM #{quote_identifier(partition_table(&1, state))}")
+
+    cold =
+      case cold_files(state) do
+        [] ->
+          []
+
+        files ->
+          list = Enum.map_join(files, ", ", &"'#{quote_literal(&1)}'")
+          ["SELECT * FROM read_parquet([#{list}], union_by_name = true)"]
+      end
+
+    # The empty template keeps the view's columns when there are no partitions yet
+    selects = ["SELECT * FROM #{template(state)}" | hot ++ cold]
+
+    execute(
+      state,
+      "CREATE OR REPLACE VIEW #{quote_identifier(state.table)} AS " <>
+        Enum.join(selects, " UNION ALL BY NAME ")
+    )
+  end
+
+  defp existing_partitions(state) do
+    prefix = "#{state.table}_p"
+
+    sql =
+      "SELECT table_name FROM duckdb_tables() WHERE schema_name = 'main' " <>
+        "AND starts_with(table_name, '#{quote_literal(prefix)}')"
+
+    with {:ok, rows} <- select(state, sql) do
+      keys =
+        for {name} <- rows,
+            key = String.replace_prefix(name, prefix, ""),
+            String.match?(key, ~r/^\d{8}(\d{2})?$/),
+            do: key
+
+      {:ok, MapSet.new(keys)}
+    end
+  end
+
+  defp time_index(state) do
+    sql =
+      "SELECT column_name FROM duckdb_columns() WHERE schema_name = 'main' " <>
+        "AND table_name = '#{quote_literal(state.table <> "_template")}' ORDER BY column_index"
+
+    with {:ok, rows} <- select(state, sql) do
+      case Enum.find_index(rows, &(&1 == {to_string(state.time_column)})) do
+        nil -> {:error, "time column #{inspect(state.time_column)} not in columns"}
+        index -> {:ok, index}
+      end
+    end
+  end
+
+  defp partition_key(%DateTime{} = value, state) do
+    value
+    |> DateTime.to_unix(:microsecond)
+    |> DateTime.from_unix!(:microsecond)
+    |> DateTime.to_naive()
+    |> partition_key(state)
+  end
+
+  defp partition_key(%NaiveDateTime{} = value, %{granularity: :hour}),
+    do: Calendar.strftime(value, "%Y%m%d%H")
+
+  defp partition_key(%NaiveDateTime{} = value, %{granularity: :day}),
+    do: Calendar.strftime(value, "%Y%m%d")
+
+  defp partition_key(%Date{} = value, state),
+    do: partition_key(NaiveDateTime.new!(value, ~T[00:00:00]), state)
+
+  defp partition_key(value, state) do
+    raise ArgumentError,
+          "#{state.time_column} must be a DateTime, NaiveDateTime or Date, got: #{inspect(value)}"
+  end
+
+  defp partition_end(<<y::binary-4, m::binary-2, d::binary-2>>, _state) do
+    date = Date.new!(String.to_integer(y), String.to_integer(m), String.to_integer(d))
+    NaiveDateTime.new!(Date.add(date, 1), ~T[00:00:00])
+  end
+
+  defp partition_end(<<day::binary-8, h::binary-2>>, state) do
+    day
+    |> partition_end(state)
+    |> NaiveDateTime.add(String.to_integer(h) * 3600 - 86_400 + 3600, :second)
+  end
+
+  defp partition_table(key, state), do: "#{state.table}_p#{key}"
+
+  defp template(state), do: quote_identifier(state.table <> "_template")
+
+  defp execute(state, sql) do
+    with {:ok, result} <- DuckdbEx.query(state.conn, sql) do
+      Result.destroy(result)
+      :ok
+    end
+  end
+
+  defp select(state, sql) do
+    with {:ok, result} <- DuckdbEx.query(state.conn, sql) do
+      rows = Result.rows_chunked(result)
+      Result.destroy(result)
+      {:ok, rows}
+    end
+  end
+
+  defp quote_identifier(name), do: ~s("#{String.replace(to_string(name), ~s("), ~s(""))}")
+  defp quote_literal(text), do: String.replace(text, "'", "''")
+end
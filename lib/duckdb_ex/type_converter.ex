@@ -2,8 +2,9 @@ defmodule DuckdbEx.TypeConverter do
   @moduledoc """
   Converts DuckDB string representations to idiomatic Elixir data types.
 
-  DuckDB complex types like ARRAY, LIST, MAP, STRUCT are converted from their
-  string representations to proper Elixir data structures.
+  Query results are already decoded into final Elixir values by the NIF, using
+  the column's full logical type. These helpers are for DuckDB's text form,
+  such as values cast to VARCHAR in SQL.
   """
 
   @doc """
@@ -185,6 +186,9 @@ defmodule DuckdbEx.TypeConverter do
   @doc """
   Parses a DuckDB INTERVAL value into a tuple {months, days, microseconds}.
 
+  The NIF already returns intervals as tuples, which are passed through; the
+  string form is accepted for values cast to VARCHAR in SQL.
+
   DuckDB interval format examples:
   - "3 days 7200000000 microseconds" -> {0, 3, 7200000000}
   - "1 month" -> {1, 0, 0}
@@ -0,0 +1,111 @@
+defmodule DuckdbEx.VSS do
+  @moduledoc """
+  Batched k-nearest-neighbour search over `FLOAT[n]` columns.
+
+  `search/7` takes many query vectors as one binary of packed native-endian 32-bit floats
+  and runs all of them in a single NIF call. Each one is run as
+
+      SELECT id, array_distance(column, <vector>) AS distance
+      FROM table ORDER BY distance LIMIT k
+
+  With the `vss` extension loaded and an HNSW index with the matching metric on the column,
+  DuckDB answers these from the index. Without one the table is scanned.
+
+      {:ok, [{ids, distances} | _]} =
+        DuckdbEx.VSS.search(conn, "items", "embedding", DuckdbEx.VSS.pack(queries), 10, :cosine)
+
+      for <<id::signed-native-64 <- ids>>, do: id
+      for <<d::float-native-32 <- distances>>, do: d
+  """
+
+  alias DuckdbEx.Result
+
+  @type metric :: :l2 | :cosine | :inner_product
+
+  @distance_functions %{
+    l2: "array_distance",
+    cosine: "array_cosine_distance",
+    inner_product: "array_negative_inner_product"
+  }
+
+  @doc """
+  Returns the `k` rows of `table` closest to each query vector.
+
+  `query_vectors` holds the vectors back to back, each one as many 32-bit native-endian
+  floats as the column's array size, see `pack/1`. The metric matches the HNSW index metrics:
+  `:l2` (`l2sq`), `:cosine` and `:inner_product` (`ip`).
+
+  Returns one `{ids, distances}` tuple per query vector, closest first. `ids` is a binary of
+  64-bit signed native-endian integers. `distances` is a binary of 32-bit native-endian floats.
+  Rows whose id or distance is NULL, such as rows without an embedding, are left out, so a
+  result can hold fewer than `k` rows.
+
+  ## Options
+
+  - `:id` - Column returned as the id, default `rowid`
+  - `:where` - SQL condition rows must satisfy
+  """
+  @spec search(
+          DuckdbEx.Connection.t(),
+          String.t(),
+          String.t(),
+          binary(),
+          pos_integer(),
+          metric(),
+          keyword()
+        ) :: {:ok, [{binary(), binary()}]} | {:error, String.t()}
+  def search(conn, table, column, query_vectors, k, metric \\ :l2, opts \\ [])
+      when is_binary(query_vectors) and is_integer(k) and k > 0 do
+    function =
+      Map.get(@distance_functions, metric) ||
+        raise ArgumentError,
+              "metric must be :l2, :cosine or :inner_product, got: #{inspect(metric)}"
+
+    with {:ok, dim} <- dimension(conn, table, column),
+         :ok <- check_size(query_vectors, dim) do
+      id = Keyword.get(opts, :id, "rowid")
+      where = if condition = opts[:where], do: " WHERE #{condition}", else: ""
+
+      prefix = "SELECT #{quote_identifier(id)}::BIGINT, #{function}(#{quote_identifier(column)}, "
+
+      suffix =
+        ") AS distance FROM #{quote_identifier(table)}#{where} ORDER BY distance LIMIT #{k}"
+
+      DuckdbEx.Nif.connection_vss_search(conn, prefix, suffix, query_vectors, dim)
+    end
+  end
+
+  @doc """
+  Packs a list of vectors into the binary taken by `search/7`.
+  """
+  @spec pack([[number()]]) :: binary()
+  def pack(vectors) do
+    for vector <- vectors, x <- vector, into: <<>>, do: <<x::float-native-32>>
+  end
+
+  defp dimension(conn, table, column) do
+    sql = "SELECT #{quote_identifier(column)} FROM #{quote_identifier(table)} LIMIT 0"
+
+    with {:ok, result} <- DuckdbEx.query(conn, sql) do
+      columns = Result.columns(result, types: :full)
+      Result.destroy(result)
+
+      case columns do
+        [%{logical_type: %{type: :array, child: %{type: :float}, size: size}}] ->
+          {:ok, size}
+
+        [%{logical_type: type}] ->
+          {:error, "#{column} must be a FLOAT[n] column, got: #{inspect(type)}"}
+      end
+    end
+  end
+
+  defp check_size(query_vectors, dim) when rem(byte_size(query_vectors), dim * 4) == 0, do: :ok
+
+  defp check_size(query_vectors, dim) do
+    size = byte_size(query_vectors)
+    {:error, "query vectors are #{size} bytes, not a multiple of #{dim} floats"}
+  end
+
+  defp quote_identifier(name), do: ~s("#{String.replace(to_string(name), ~s("), ~s(""))}")
+end
@@ -0,0 +1,321 @@
+defmodule DuckdbEx.VSS.BulkLoad do
+  @moduledoc """
+  Loads vectors into a fresh copy of a table and swaps it in once it is indexed.
+
+  Appending into a table that already has an HNSW index updates the index row by row. A
+  bulk load avoids that:
+
+  1. `new/3` creates a new generation table, e.g. `items_g2`, without an index.
+  2. `append/2` appends packed columns to it with `DuckdbEx.Appender.append_columns/2`.
+  3. `finish/2` closes the appender and builds the HNSW index in a background process.
+     That process sends progress messages, then replaces the view named after the table
+     with one over the new generation and drops the older ones, in one transaction.
+
+  Readers keep querying the view and see either the old or the new data. The HNSW index is
+  used through the view like on the table itself.
+
+      {:ok, load} = BulkLoad.new(conn, "items", columns: "id BIGINT, embedding FLOAT[384]")
+
+      for {ids, vectors} <- batches do
+        :ok = BulkLoad.append(load, [ids, vectors])
+      end
+
+      {:ok, ref} = BulkLoad.finish(load, metric: :cosine)
+
+      receive do
+        {:duckdb_ex_index_progress, ^ref, percentage} -> ...
+        {:duckdb_ex_bulk_load, ^ref, result} -> ...
+      end
+
+  The `vss` extension must be loaded on the connection. The index build and swap run on the
+  connection given to `new/3`, which shouldn't be used for anything else until the load is
+  done. A table that exists as a plain table is replaced by the view on the first load.
+  """
+
+  alias DuckdbEx.{Appender, Result}
+
+  defstruct [:conn, :table, :generation, :appender, :vector_column]
+
+  @type t :: %__MODULE__{}
+
+  @metrics %{l2: "l2sq", cosine: "cosine", inner_product: "ip"}
+
+  @default_progress_interval 500
+
+  @doc """
+  Creates the next generation table of `table` and an appender for it.
+
+  ## Options
+
+  - `:columns` - Column definitions of the table (required)
+  - `:vector_column` - The `FLOAT[n]` column to index, default `"embedding"`
+  """
+  @spec new(DuckdbEx.Connection.t(), String.t(), keyword()) :: {:ok, t()} | {:error, String.t()}
+  def new(conn, table, opts) do
+    columns = Keyword.fetch!(opts, :columns)
+
+    with {:ok, generation} <- next_generation(conn, table),
+         :ok <- execute(conn, "CREATE TABLE #{quote_identifier(generation)} (#{columns})"),
+         {:ok, appender} <- Appender.create(conn, nil, generation) do
+      {:ok,
+       %__MODULE__{
+         conn: conn,
+         table: table,
+         generation: generation,
+         appender: appender,
+         vector_column: Keyword.get(opts, :vector_column, "embedding")
+       }}
+    end
+  end
+
+  @doc """
+  Appends one packed binary per column, see `DuckdbEx.Appender.append_columns/2`.
+  """
+  @spec append(t(), [binary()]) :: :ok | {:error, String.t()}
+  def append(%__MODULE__{appender: appender}, columns) do
+    Appender.append_columns(appender, columns)
+  end
+
+  @doc """
+  Closes the appender and builds the index and swaps the table in the background.
+
+  Returns a reference. The process given as `:notify` receives
+  `{:duckdb_ex_index_progress, ref, percentage}` while the index is built, followed by
+  `{:duckdb_ex_bulk_load, ref, :ok | {:error, reason}}` once the new generation is in
+  place or the load failed, including when the build process crashed. On failure the new
+  generation is dropped and the view is left unchanged. When the appender cannot be closed
+  its error is returned right away and the new generation is dropped as well.
+
+  ## Options
+
+  - `:metric` - `:l2` (default), `:cosine` or `:inner_product`
+  - `:index_options` - Further HNSW options, e.g. `[m: 32, ef_construction: 256]`
+  - `:persistent` - Enable `hnsw_enable_experimental_persistence`, needed for indexes in
+    file-backed databases. Default `false`.
+  - `:notify` - Process receiving the messages, default `self()`
+  - `:progress_interval` - Milliseconds between progress messages, default `500`
+  """
+  @spec finish(t(), keyword()) :: {:ok, reference()} | {:error, String.t()}
+  def finish(%__MODULE__{} = load, opts \\ []) do
+    metric = Keyword.get(opts, :metric, :l2)
+
+    unless Map.has_key?(@metrics, metric) do
+      raise ArgumentError,
+            "metric must be :l2, :cosine or :inner_product, got: #{inspect(metric)}"
+    end
+
+    closed = Appender.close(load.appender)
+    Appender.destroy(load.appender)
+
+    if closed != :ok, do: drop_generation(load)
+
+    with :ok <- closed do
+      ref = make_ref()
+      notify = Keyword.get(opts, :notify, self())
+      progress = &send(notify, {:duckdb_ex_index_progress, ref, &1})
+
+      {:ok, _pid} =
+        Task.start(fn ->
+          # The build runs in a monitored process of its own, so that a crash still ends
+          # in a result message instead of leaving `await/2` waiting
+          {pid, monitor} =
+            spawn_monitor(fn ->
+              result = build_and_swap(load, metric, opts, progress)
+              send(notify, {:duckdb_ex_bulk_load, ref, result})
+            end)
+
+          receive do
+            {:DOWN, ^monitor, :process, ^pid, :normal} ->
+              :ok
+
+            {:DOWN, ^monitor, :process, ^pid, reason} ->
+              drop_generation(load)
+              send(notify, {:duckdb_ex_bulk_load, ref, {:error, reason}})
+          end
+        end)
+
+      {:ok, ref}
+    end
+  end
+
+  @doc """
+  Waits for the load started by `finish/2`, discarding progress messages.
+  """
+  @spec await(reference(), timeout()) :: :ok | {:error, term()}
+  def await(ref, timeout \\ :infinity) do
+    receive do
+      {:duckdb_ex_index_progress, ^ref, _percentage} -> await(ref, timeout)
+      {:duckdb_ex_bulk_load, ^ref, result} -> result
+    after
+      timeout -> {:error, :timeout}
+    end
+  end
+
+  defp build_and_swap(load, metric, opts, progress) do
+    %{conn: conn, generation: generation} = load
+
+    options =
+      [{:metric, "'#{@metrics[metric]}'"} | Keyword.get(opts, :index_options, [])]
+      |> Enum.map_join(", ", fn {key, value} -> "#{key} = #{value}" end)
+
+    index = quote_identifier(generation <> "_hnsw")
+
+    create_index =
+      "CREATE INDEX #{index} ON #{quote_identifier(generation)} " <>
+        "USING HNSW (#{quote_identifier(load.vector_column)}) WITH (#{options})"
+
+    persistence =
+      if Keyword.get(opts, :persistent, false),
+        do: ["SET hnsw_enable_experimental_persistence = true"],
+        else: []
+
+    # Progress is only tracked with the progress bar enabled
+    settings =
+      ["SET enable_progress_bar = true", "SET enable_progress_bar_print = false" | persistence]
+
+    result =
+      with :ok <- execute_all(conn, settings),
+           :ok <- run_with_progress(conn, create_index, opts, progress) do
+        progress.(100.0)
+        swap(load)
+      end
+
+    with {:error, _} <- result do
+      drop_generation(load)
+      result
+    end
+  end
+
+  defp drop_generation(%{conn: conn, generation: generation}) do
+    execute(conn, "DROP TABLE IF EXISTS #{quote_identifier(generation)}")
+  end
+
+  # The statement runs in a task while this process polls the connection's progress
+  defp run_with_progress(conn, sql, opts, progress) do
+    interval = Keyword.get(opts, :progress_interval, @default_progress_interval)
+    task = Task.async(fn -> execute(conn, sql) end)
+    poll(conn, task, interval, progress, nil)
+  end
+
+  defp poll(conn, task, interval, progress, last) do
+    case Task.yield(task, interval) do
+      {:ok, result} ->
+        result
+
+      {:exit, reason} ->
+        {:error, reason}
+
+      nil ->
+        last =
+          case DuckdbEx.Nif.connection_query_progress(conn) do
+            {:ok, {percentage, _rows, _total}} when percentage >= 0 and percentage != last ->
+              progress.(percentage)
+              percentage
+
+            _ ->
+              last
+          end
+
+        poll(conn, task, interval, progress, last)
+    end
+  end
+
+  defp swap(%{conn: conn, table: table, generation: generation}) do
+    with {:ok, current} <- table_type(conn, table),
+         {:ok, old} <- generations(conn, table) do
+      drop_current =
+        case current do
+          "VIEW" -> ["DROP VIEW #{quote_identifier(table)}"]
+          "BASE TABLE" -> ["DROP TABLE #{quote_identifier(table)}"]
+          nil -> []
+        end
+
+      drop_old =
+        for name <- old, name != generation, do: "DROP TABLE #{quote_identifier(name)}"
+
+      create_view =
+        "CREATE VIEW #{quote_identifier(table)} AS SELECT * FROM #{quote_identifier(generation)}"
+
+      statements = drop_current ++ [create_view | drop_old]
+
+      with :ok <- execute(conn, "BEGIN TRANSACTION") do
+        case execute_all(conn, statements) do
+          :ok ->
+            execute(conn, "COMMIT")
+
+          {:error, _} = error ->
+            execute(conn, "ROLLBACK")
+            error
+        end
+      end
+    end
+  end
+
+  defp next_generation(conn, table) do
+    with {:ok, names} <- generations(conn, table) do
+      prefix = "#{table}_g"
+
+      next =
+        names
+        |> Enum.map(&String.to_integer(String.replace_prefix(&1, prefix, "")))
+        |> Enum.max(fn -> 0 end)
+
+      {:ok, "#{prefix}#{next + 1}"}
+    end
+  end
+
+  defp generations(conn, table) do
+    prefix = "#{table}_g"
+
+    sql =
+      "SELECT table_name FROM duckdb_tables() WHERE schema_name = 'main' " <>
+        "AND starts_with(table_name, '#{quote_literal(prefix)}')"
+
+    with {:ok, rows} <- select(conn, sql) do
+      {:ok,
+       for {name} <- rows,
+           String.match?(String.replace_prefix(name, prefix, ""), ~r/^\d+$/),
+           do: name}
+    end
+  end
+
+  defp table_type(conn, table) do
+    sql =
+      "SELECT table_type FROM information_schema.tables WHERE table_schema = 'main' " <>
+        "AND table_name = '#{quote_literal(table)}'"
+
+    with {:ok, rows} <- select(conn, sql) do
+      case rows do
+        [{type}] -> {:ok, type}
+        [] -> {:ok, nil}
+      end
+    end
+  end
+
+  defp execute_all(conn, statements) do
+    Enum.reduce_while(statements, :ok, fn sql, :ok ->
+      case execute(conn, sql) do
+        :ok -> {:cont, :ok}
+        error -> {:halt, error}
+      end
+    end)
+  end
+
+  defp execute(conn, sql) do
+    with {:ok, result} <- DuckdbEx.query(conn, sql) do
+      Result.destroy(result)
+      :ok
+    end
+  end
+
+  defp select(conn, sql) do
+    with {:ok, result} <- DuckdbEx.query(conn, sql) do
+      rows = Result.rows_chunked(result)
+      Result.destroy(result)
+      {:ok, rows}
+    end
+  end
+
+  defp quote_identifier(name), do: ~s("#{String.replace(to_string(name), ~s("), ~s(""))}")
+  defp quote_literal(text), do: String.replace(text, "'", "''")
+end
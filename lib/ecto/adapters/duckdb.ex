@@ -0,0 +1,565 @@
+if Code.ensure_loaded?(Ecto) do
+  defmodule Ecto.Adapters.DuckDB do
+    @moduledoc """
+    Ecto adapter for DuckDB.
+
+        defmodule MyApp.Repo do
+          use Ecto.Repo, otp_app: :my_app, adapter: Ecto.Adapters.DuckDB
+        end
+
+        config :my_app, MyApp.Repo, database: "priv/analytics.duckdb"
+
+    The repo opens the database once. Every process using the repo gets its own DuckDB
+    connection the first time it runs a query, so transactions are per process as with
+    other adapters. The connection is kept in the process dictionary and never closed
+    explicitly; it is closed when it is garbage collected after the process exits. Each
+    short-lived process, such as one per web request, therefore opens a connection of its
+    own, so run repo calls from long-lived processes where connection setup matters.
+
+    - Queries are compiled to SQL once by Ecto's query cache. Each connection keeps the
+      statements it prepared, keyed by SQL, so a repeated query is only bound and executed.
+      Beyond `:statement_cache_size` the least recently used statement is dropped.
+    - `Repo.stream/2` executes with streaming execution and decodes one chunk, about 2048
+      rows, at a time. The stream must be consumed before the process runs another query.
+    - `Repo.insert_all/3` loads the rows with `DuckdbEx.Appender`, one column per field in
+      the entries. Entries that don't all set the same fields, `:on_conflict`, `:returning`,
+      `:placeholders` and query values fall back to an `INSERT` statement.
+    - `DECIMAL` columns of `:decimal` fields are read as text and loaded with
+      `Decimal.new/1`. `UUID` columns load into `Ecto.UUID` and `:binary_id` fields, JSON
+      columns into `:map` fields and `TIMESTAMP` columns into every datetime type.
+
+    Migrations, subqueries, CTEs, unions and locks are not supported. Schema changes are
+    done with SQL, e.g. through `query/4`. Constraint violations raise
+    `Ecto.Adapters.DuckDB.Error` instead of becoming changeset errors. Parameters are bound
+    as text when they aren't integers, floats or booleans, so `:binary` fields must hold
+    valid UTF-8.
+
+    ## Options
+
+    - `:database` - Path of the database file, `nil` (default) for an in-memory database
+    - `:config` - Map of DuckDB settings, see `DuckdbEx.open/2`
+    - `:statement_cache_size` - Prepared statements kept per connection, default `256`
+    """
+
+    @behaviour Ecto.Adapter
+    @behaviour Ecto.Adapter.Queryable
+    @behaviour Ecto.Adapter.Schema
+    @behaviour Ecto.Adapter.Transaction
+
+    alias DuckdbEx.{Appender, Connection, PreparedStatement, Result}
+    alias Ecto.Adapters.DuckDB.{Error, SQL}
+
+    @decode [uuid: :raw, json: :decode]
+
+    @default_statement_cache_size 256
+
+    @temporal_types [
+      :date,
+      :time,
+      :time_usec,
+      :naive_datetime,
+      :naive_datetime_usec,
+      :utc_datetime,
+      :utc_datetime_usec
+    ]
+
+    @doc """
+    Runs `sql` on the calling process's connection of `repo`.
+
+    Returns the rows as tuples, decoded like `DuckdbEx.Result.rows_chunked/2`.
+    """
+    @spec query(Ecto.Repo.t(), String.t(), list(), keyword()) ::
+            {:ok, [tuple()]} | {:error, String.t()}
+    def query(repo, sql, params \\ [], opts \\ []) do
+      meta = Ecto.Adapter.lookup_meta(repo.get_dynamic_repo())
+      run(meta, sql, params, opts)
+    end
+
+    ## Ecto.Adapter
+
+    @impl Ecto.Adapter
+    defmacro __before_compile__(_env), do: :ok
+
+    @impl Ecto.Adapter
+    def ensure_all_started(_config, type), do: Application.ensure_all_started(:duckdb_ex, type)
+
+    @impl Ecto.Adapter
+    def init(config) do
+      path = Keyword.get(config, :database)
+
+      db =
+        case open(path, Keyword.get(config, :config, %{})) do
+          {:ok, db} -> db
+          {:error, reason} -> raise Error, message: "could not open #{inspect(path)}: #{reason}"
+        end
+
+      # The database is closed once neither the repo nor any connection refers to it
+      child_spec = Supervisor.child_spec({Agent, fn -> db end}, id: __MODULE__)
+
+      meta = %{
+        db: db,
+        repo: Keyword.get(config, :repo),
+        statement_cache_size:
+          Keyword.get(config, :statement_cache_size, @default_statement_cache_size),
+        telemetry_event:
+          if(prefix = Keyword.get(config, :telemetry_prefix), do: prefix ++ [:query])
+      }
+
+      {:ok, child_spec, meta}
+    end
+
+    @impl Ecto.Adapter
+    def checkout(meta, _opts, fun) do
+      connection(meta)
+      fun.()
+    end
+
+    @impl Ecto.Adapter
+    def checked_out?(meta), do: Process.get(connection_key(meta)) != nil
+
+    @impl Ecto.Adapter
+    def loaders(:binary_id, type), do: [&load_uuid_string/1, type]
+    def loaders(:uuid, type), do: [&load_uuid_binary/1, type]
+    def loaders(:decimal, type), do: [&load_decimal/1, type]
+    def loaders(:map, type), do: [&load_json/1, type]
+    def loaders({:map, _}, type), do: [&load_json/1, type]
+
+    def loaders(naive, type) when naive in [:naive_datetime, :naive_datetime_usec],
+      do: [&load_naive_datetime/1, type]
+
+    def loaders(utc, type) when utc in [:utc_datetime, :utc_datetime_usec],
+      do: [&load_utc_datetime/1, type]
+
+    def loaders(_primitive, type), do: [type]
+
+    @impl Ecto.Adapter
+    def dumpers(:binary_id, type), do: [type, &dump_uuid/1]
+    def dumpers(:uuid, type), do: [type, &dump_uuid/1]
+    def dumpers(:decimal, type), do: [type, &dump_decimal/1]
+    def dumpers(:map, type), do: [&Ecto.Type.embedded_dump(type, &1, :json), &dump_json/1]
+    def dumpers({:map, _}, type), do: [&Ecto.Type.embedded_dump(type, &1, :json), &dump_json/1]
+    def dumpers({:array, _}, type), do: [type, &dump_json/1]
+    def dumpers({:in, sub}, {:in, sub}), do: [&dump_in(sub, &1)]
+    def dumpers(temporal, type) when temporal in @temporal_types, do: [type, &dump_temporal/1]
+    def dumpers(_primitive, type), do: [type]
+
+    ## Ecto.Adapter.Queryable
+
+    @impl Ecto.Adapter.Queryable
+    def prepare(operation, query) do
+      sql = IO.iodata_to_binary(apply(SQL, operation, [query]))
+      {:cache, {System.unique_integer([:positive]), sql}}
+    end
+
+    @impl Ecto.Adapter.Queryable
+    def execute(meta, query_meta, query_cache, params, opts) do
+      rows = run!(meta, cached_sql(query_cache), params, opts)
+
+      case query_meta do
+        %{select: nil} -> {affected(rows), nil}
+        %{} -> {length(rows), Enum.map(rows, &Tuple.to_list/1)}
+      end
+    end
+
+    @impl Ecto.Adapter.Queryable
+    def stream(meta, _query_meta, query_cache, params, opts) do
+      sql = cached_sql(query_cache)
+
+      Stream.resource(
+        fn -> start_stream(meta, sql, params, opts) end,
+        fn result ->
+          case Result.next_chunk(result, @decode) do
+            {:ok, rows} -> {[{length(rows), Enum.map(rows, &Tuple.to_list/1)}], result}
+            :done -> {:halt, result}
+            {:error, reason} -> raise Error, message: reason, query: sql
+          end
+        end,
+        &Result.destroy/1
+      )
+    end
+
+    # A streamed statement stays busy until its result is consumed, so it gets its own
+    # statement instead of the cached one
+    defp start_stream(meta, sql, params, opts) do
+      conn = connection(meta)
+      prefetch = Keyword.get(opts, :prefetch, 0)
+
+      with {:ok, statement} <- PreparedStatement.prepare(conn, sql),
+           {:ok, result} <-
+             PreparedStatement.execute_stream(statement, expand(params), prefetch: prefetch) do
+        result
+      else
+        {:error, reason} -> raise Error, message: reason, query: sql
+      end
+    end
+
+    defp cached_sql({:nocache, {_id, sql}}), do: sql
+
+    defp cached_sql({:cache, update, {_id, sql} = prepared}) do
+      update.(prepared)
+      sql
+    end
+
+    defp cached_sql({:cached, _update, _reset, {_id, sql}}), do: sql
+
+    ## Ecto.Adapter.Schema
+
+    @impl Ecto.Adapter.Schema
+    def autogenerate(:id), do: nil
+    def autogenerate(:embed_id), do: Ecto.UUID.generate()
+    def autogenerate(:binary_id), do: Ecto.UUID.generate()
+
+    @impl Ecto.Adapter.Schema
+    def insert_all(meta, schema_meta, header, rows, on_conflict, returning, placeholders, opts) do
+      %{source: source, prefix: prefix} = schema_meta
+
+      if appendable?(header, rows, on_conflict, returning, placeholders) do
+        append_all(meta, prefix, source, header, rows)
+      else
+        {values, params} = insert_values(header, rows)
+        sql = SQL.insert(prefix, source, header, values, on_conflict, returning, placeholders)
+        rows = run!(meta, IO.iodata_to_binary(sql), placeholders ++ params, opts)
+
+        case returning do
+          [] -> {affected(rows), nil}
+          _ -> {length(rows), Enum.map(rows, &Tuple.to_list/1)}
+        end
+      end
+    end
+
+    @impl Ecto.Adapter.Schema
+    def insert(meta, %{source: source, prefix: prefix}, params, on_conflict, returning, opts) do
+      {fields, values} = :lists.unzip(params)
+      sql = SQL.insert(prefix, source, fields, [values], on_conflict, returning, [])
+
+      case run!(meta, IO.iodata_to_binary(sql), values, opts) do
+        [row] when returning != [] -> {:ok, Enum.zip(returning, Tuple.to_list(row))}
+        _rows -> {:ok, []}
+      end
+    end
+
+    @impl Ecto.Adapter.Schema
+    def update(meta, %{source: source, prefix: prefix}, fields, filters, returning, opts) do
+      {names, values} = :lists.unzip(fields)
+      sql = SQL.update(prefix, source, names, filters, returning)
+      params = values ++ for({_field, value} <- filters, value != nil, do: value)
+      single_result(run!(meta, IO.iodata_to_binary(sql), params, opts), returning)
+    end
+
+    @impl Ecto.Adapter.Schema
+    def delete(meta, %{source: source, prefix: prefix}, filters, returning, opts) do
+      sql = SQL.delete(prefix, source, filters, returning)
+      params = for {_field, value} <- filters, value != nil, do: value
+      single_result(run!(meta, IO.iodata_to_binary(sql), params, opts), returning)
+    end
+
+    defp single_result(rows, []) do
+      if affected(rows) == 0, do: {:error, :stale}, else: {:ok, []}
+    end
+
+    defp single_result([row | _], returning), do: {:ok, Enum.zip(returning, Tuple.to_list(row))}
+    defp single_result([], _returning), do: {:error, :stale}
+
+    # Statements without RETURNING produce a single row holding the affected row count
+    defp affected([{count}]), do: count
+    defp affected(_rows), do: 0
+
+    defp appendable?(header, rows, on_conflict, returning, placeholders) do
+      match?({:raise, _, []}, on_conflict) and returning == [] and placeholders == [] and
+        header != [] and
+        Enum.all?(rows, fn row ->
+          length(row) == length(header) and Enum.all?(row, fn {_f, v} -> not is_tuple(v) end)
+        end)
+    end
+
+    defp append_all(meta, prefix, source, header, rows) do
+      conn = connection(meta)
+      columns = Enum.map(header, &Atom.to_string/1)
+      values = Enum.map(rows, fn row -> Enum.map(header, &Keyword.fetch!(row, &1)) end)
+
+      result =
+        with {:ok, appender} <- Appender.create(conn, prefix, source) do
+          result =
+            with :ok <- Appender.set_columns(appender, columns),
+                 :ok <- Appender.append_rows(appender, values) do
+              Appender.close(appender)
+            end
+
+          Appender.destroy(appender)
+          result
+        end
+
+      case result do
+        :ok -> {length(rows), nil}
+        {:error, reason} -> raise Error, message: "appending to #{source} failed: #{reason}"
+      end
+    end
+
+    # Rows in header order, with `:default` where an entry leaves a field out
+    defp insert_values(header, rows) do
+      {values, params} =
+        Enum.map_reduce(rows, [], fn row, params ->
+          Enum.map_reduce(header, params, fn field, params ->
+            case Keyword.fetch(row, field) do
+              {:ok, {:placeholder, _} = placeholder} -> {placeholder, params}
+              {:ok, {%Ecto.Query{}, _}} -> raise ArgumentError, "queries can't be inserted"
+              {:ok, value} -> {:param, [value | params]}
+              :error -> {:default, params}
+            end
+          end)
+        end)
+
+      {values, Enum.reverse(params)}
+    end
+
+    ## Ecto.Adapter.Transaction
+
+    @impl Ecto.Adapter.Transaction
+    def transaction(meta, _opts, fun) do
+      key = transaction_key(meta)
+
+      case Process.get(key) do
+        nil -> outer_transaction(meta, key, fun)
+        _status -> nested_transaction(key, fun)
+      end
+    end
+
+    @impl Ecto.Adapter.Transaction
+    def in_transaction?(meta), do: Process.get(transaction_key(meta)) != nil
+
+    @impl Ecto.Adapter.Transaction
+    def rollback(meta, value) do
+      key = transaction_key(meta)
+
+      if Process.get(key) do
+        throw({__MODULE__, :rollback, key, value})
+      else
+        raise RuntimeError, "cannot call rollback outside of transaction"
+      end
+    end
+
+    defp outer_transaction(meta, key, fun) do
+      conn = connection(meta)
+      ok!(DuckdbEx.begin_transaction(conn))
+      Process.put(key, :active)
+
+      try do
+        result = fun.()
+
+        # A nested transaction that rolled back fails the whole transaction
+        case Process.get(key) do
+          :active ->
+            ok!(DuckdbEx.commit(conn))
+            {:ok, result}
+
+          :failed ->
+            ok!(DuckdbEx.rollback(conn))
+            {:error, :rollback}
+        end
+      catch
+        :throw, {__MODULE__, :rollback, ^key, value} ->
+          DuckdbEx.rollback(conn)
+          {:error, value}
+
+        kind, reason ->
+          DuckdbEx.rollback(conn)
+          :erlang.raise(kind, reason, __STACKTRACE__)
+      after
+        Process.delete(key)
+      end
+    end
+
+    defp nested_transaction(key, fun) do
+      {:ok, fun.()}
+    catch
+      :throw, {__MODULE__, :rollback, ^key, value} ->
+        Process.put(key, :failed)
+        {:error, value}
+    end
+
+    ## Connections and statements
+
+    defp open(nil, config) when config == %{}, do: DuckdbEx.open()
+    defp open(nil, config), do: DuckdbEx.open(nil, config)
+    defp open(path, config) when config == %{}, do: DuckdbEx.open(path)
+    defp open(path, config), do: DuckdbEx.open(path, config)
+
+    # Lives as long as the process; there is no hook to close it when the process exits, so
+    # it is freed by garbage collection
+    defp connection(meta) do
+      key = connection_key(meta)
+
+      case Process.get(key) do
+        nil ->
+          case Connection.open(meta.db) do
+            {:ok, conn} ->
+              Process.put(key, conn)
+              conn
+
+            {:error, reason} ->
+              raise Error, message: "could not connect: #{reason}"
+          end
+
+        conn ->
+          conn
+      end
+    end
+
+    defp connection_key(%{db: db}), do: {__MODULE__, :connection, db}
+    defp transaction_key(%{db: db}), do: {__MODULE__, :transaction, db}
+
+    # Prepared statements of this process's connection with the tick of their last use. When
+    # full, the least recently used one is destroyed and dropped.
+    defp statement(meta, conn, sql) do
+      key = {__MODULE__, :statements, meta.db}
+      {statements, tick} = Process.get(key, {%{}, 0})
+
+      case statements do
+        %{^sql => {statement, _used}} ->
+          Process.put(key, {Map.put(statements, sql, {statement, tick}), tick + 1})
+          {:ok, statement}
+
+        %{} ->
+          with {:ok, statement} <- PreparedStatement.prepare(conn, sql) do
+            statements =
+              if map_size(statements) >= meta.statement_cache_size,
+                do: evict_least_recently_used(statements),
+                else: statements
+
+            Process.put(key, {Map.put(statements, sql, {statement, tick}), tick + 1})
+            {:ok, statement}
+          end
+      end
+    end
+
+    defp evict_least_recently_used(statements) do
+      {sql, {statement, _used}} =
+        Enum.min_by(statements, fn {_sql, {_statement, used}} -> used end)
+
+      PreparedStatement.destroy(statement)
+      Map.delete(statements, sql)
+    end
+
+    defp run!(meta, sql, params, opts) do
+      case run(meta, sql, params, opts) do
+        {:ok, rows} -> rows
+        {:error, reason} -> raise Error, message: reason, query: sql
+      end
+    end
+
+    defp run(meta, sql, params, _opts) do
+      conn = connection(meta)
+      params = expand(params)
+      start = System.monotonic_time()
+
+      result =
+        with {:ok, statement} <- statement(meta, conn, sql),
+             {:ok, result} <- PreparedStatement.execute(statement, params) do
+          rows = Result.rows_chunked(result, @decode)
+          Result.destroy(result)
+
+          case rows do
+            {:error, _} = error -> error
+            rows -> {:ok, rows}
+          end
+        end
+
+      telemetry(meta, sql, params, System.monotonic_time() - start, result)
+      result
+    end
+
+    # `in ^list` parameters arrive as one list holding a parameter per element
+    defp expand(params) do
+      Enum.flat_map(params, fn
+        list when is_list(list) -> list
+        value -> [value]
+      end)
+    end
+
+    defp telemetry(%{telemetry_event: nil}, _sql, _params, _time, _result), do: :ok
+
+    defp telemetry(meta, sql, params, time, result) do
+      :telemetry.execute(
+        meta.telemetry_event,
+        %{query_time: time, total_time: time},
+        %{type: :ecto_duckdb_query, repo: meta.repo, query: sql, params: params, result: result}
+      )
+    end
+
+    defp ok!(:ok), do: :ok
+    defp ok!({:error, reason}), do: raise(Error, message: reason)
+
+    ## Loaders and dumpers
+
+    defp load_uuid_string(<<_::128>> = raw), do: Ecto.UUID.load(raw)
+    defp load_uuid_string(<<_::288>> = uuid), do: {:ok, uuid}
+    defp load_uuid_string(_value), do: :error
+
+    defp load_uuid_binary(<<_::128>> = raw), do: {:ok, raw}
+    defp load_uuid_binary(<<_::288>> = uuid), do: Ecto.UUID.dump(uuid)
+    defp load_uuid_binary(_value), do: :error
+
+    defp load_decimal(%Decimal{} = decimal), do: {:ok, decimal}
+    defp load_decimal(value) when is_binary(value) or is_integer(value),
+      do: {:ok, Decimal.new(value)}
+
+    defp load_decimal(value) when is_float(value), do: {:ok, Decimal.from_float(value)}
+    defp load_decimal(_value), do: :error
+
+    # JSON columns are decoded by the NIF, JSON kept in VARCHAR columns is decoded here
+    defp load_json(value) when is_binary(value) do
+      case Jason.decode(value) do
+        {:ok, decoded} -> {:ok, decoded}
+        {:error, _} -> :error
+      end
+    end
+
+    defp load_json(value), do: {:ok, value}
+
+    defp load_naive_datetime(%DateTime{} = datetime), do: {:ok, DateTime.to_naive(datetime)}
+    defp load_naive_datetime(value), do: {:ok, value}
+
+    defp load_utc_datetime(%NaiveDateTime{} = datetime),
+      do: DateTime.from_naive(datetime, "Etc/UTC")
+
+    defp load_utc_datetime(value), do: {:ok, value}
+
+    defp dump_uuid(<<_::128>> = raw), do: Ecto.UUID.load(raw)
+    defp dump_uuid(<<_::288>> = uuid), do: {:ok, uuid}
+    defp dump_uuid(_value), do: :error
+
+    defp dump_decimal(%Decimal{} = decimal), do: {:ok, Decimal.to_string(decimal, :normal)}
+    defp dump_decimal(_value), do: :error
+
+    defp dump_json(value) do
+      case Jason.encode(value) do
+        {:ok, json} -> {:ok, json}
+        {:error, _} -> :error
+      end
+    end
+
+    defp dump_in(type, values) when is_list(values) do
+      Enum.reduce_while(Enum.reverse(values), {:ok, []}, fn value, {:ok, acc} ->
+        case Ecto.Type.adapter_dump(__MODULE__, type, value) do
+          {:ok, dumped} -> {:cont, {:ok, [dumped | acc]}}
+          :error -> {:halt, :error}
+        end
+      end)
+    end
+
+    defp dump_in(_type, _values), do: :error
+
+    # DuckDB casts ISO 8601 text parameters to the DATE, TIME or TIMESTAMP they are bound to.
+    # Ecto's :utc_datetime types are always in UTC.
+    defp dump_temporal(%Date{} = date), do: {:ok, Date.to_iso8601(date)}
+    defp dump_temporal(%Time{} = time), do: {:ok, Time.to_iso8601(time)}
+
+    defp dump_temporal(%NaiveDateTime{} = datetime),
+      do: {:ok, NaiveDateTime.to_iso8601(datetime)}
+
+    defp dump_temporal(%DateTime{} = datetime),
+      do: {:ok, datetime |> DateTime.to_naive() |> NaiveDateTime.to_iso8601()}
+
+    defp dump_temporal(_value), do: :error
+  end
+end
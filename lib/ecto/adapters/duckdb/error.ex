@@ -0,0 +1,11 @@
+defmodule Ecto.Adapters.DuckDB.Error do
+  @moduledoc """
+  Raised by `Ecto.Adapters.DuckDB` when DuckDB rejects a statement.
+  """
+
+  defexception [:message, :query]
+
+  @impl true
+  def message(%{message: message, query: nil}), do: message
+  def message(%{message: message, query: query}), do: "#{message}\n\n    #{query}"
+end
@@ -0,0 +1,547 @@
+if Code.ensure_loaded?(Ecto) do
+  defmodule Ecto.Adapters.DuckDB.SQL do
+    @moduledoc false
+    # Renders Ecto queries as DuckDB SQL. Parameters become `$n` placeholders, sources are
+    # aliased `t0`, `t1`, ... in the order of `query.sources`.
+
+    alias Ecto.Query.{BooleanExpr, JoinExpr, QueryExpr, Tagged}
+
+    @binary_ops [
+      ==: " = ",
+      !=: " != ",
+      <=: " <= ",
+      >=: " >= ",
+      <: " < ",
+      >: " > ",
+      +: " + ",
+      -: " - ",
+      *: " * ",
+      /: " / ",
+      and: " AND ",
+      or: " OR ",
+      like: " LIKE ",
+      ilike: " ILIKE "
+    ]
+
+    @binary_op_names Keyword.keys(@binary_ops)
+
+    @interval_functions %{
+      "year" => "to_years",
+      "month" => "to_months",
+      "week" => "to_weeks",
+      "day" => "to_days",
+      "hour" => "to_hours",
+      "minute" => "to_minutes",
+      "second" => "to_seconds",
+      "millisecond" => "to_milliseconds",
+      "microsecond" => "to_microseconds"
+    }
+
+    ## Queries
+
+    def all(query) do
+      check_unsupported(query)
+      sources = create_names(query)
+
+      [
+        select(query, sources),
+        from(query, sources),
+        join(query, sources),
+        boolean(" WHERE ", query.wheres, sources, query),
+        group_by(query, sources),
+        boolean(" HAVING ", query.havings, sources, query),
+        order_by(query, sources),
+        limit(query, sources),
+        offset(query, sources)
+      ]
+    end
+
+    def update_all(query) do
+      check_unsupported(query)
+      check_no_joins(query)
+      sources = create_names(query)
+      {table, name, _schema} = elem(sources, 0)
+
+      [
+        "UPDATE ",
+        table,
+        " AS ",
+        name,
+        " SET ",
+        update_fields(query, sources),
+        boolean(" WHERE ", query.wheres, sources, query),
+        returning(query, sources)
+      ]
+    end
+
+    def delete_all(query) do
+      check_unsupported(query)
+      check_no_joins(query)
+      sources = create_names(query)
+      {table, name, _schema} = elem(sources, 0)
+
+      [
+        "DELETE FROM ",
+        table,
+        " AS ",
+        name,
+        boolean(" WHERE ", query.wheres, sources, query),
+        returning(query, sources)
+      ]
+    end
+
+    ## Schema operations
+
+    # `rows` hold one entry per header field: `:default` for fields the row doesn't set,
+    # `{:placeholder, ix}` for placeholders and anything else for a parameter
+    def insert(prefix, table, header, rows, on_conflict, returning, placeholders) do
+      values =
+        if header == [] do
+          " DEFAULT VALUES"
+        else
+          [
+            " (",
+            Enum.map_intersperse(header, ", ", &quote_name/1),
+            ") VALUES " | insert_rows(rows, length(placeholders) + 1)
+          ]
+        end
+
+      [
+        "INSERT INTO ",
+        quote_table(prefix, table),
+        values,
+        on_conflict(on_conflict, header) | returning(returning)
+      ]
+    end
+
+    def update(prefix, table, fields, filters, returning) do
+      {fields, count} =
+        Enum.map_reduce(fields, 1, fn field, ix ->
+          {[quote_name(field), " = $", Integer.to_string(ix)], ix + 1}
+        end)
+
+      [
+        "UPDATE ",
+        quote_table(prefix, table),
+        " SET ",
+        Enum.intersperse(fields, ", "),
+        " WHERE ",
+        filters(filters, count) | returning(returning)
+      ]
+    end
+
+    def delete(prefix, table, filters, returning) do
+      [
+        "DELETE FROM ",
+        quote_table(prefix, table),
+        " WHERE ",
+        filters(filters, 1) | returning(returning)
+      ]
+    end
+
+    # Filters on nil values become IS NULL and take no parameter
+    defp filters(filters, first) do
+      {filters, _ix} =
+        Enum.map_reduce(filters, first, fn
+          {field, nil}, ix -> {[quote_name(field), " IS NULL"], ix}
+          {field, _value}, ix -> {[quote_name(field), " = $", Integer.to_string(ix)], ix + 1}
+        end)
+
+      Enum.intersperse(filters, " AND ")
+    end
+
+    defp insert_rows(rows, first) do
+      {rows, _ix} =
+        Enum.map_reduce(rows, first, fn row, ix ->
+          {values, ix} =
+            Enum.map_reduce(row, ix, fn
+              :default, ix -> {"DEFAULT", ix}
+              {:placeholder, placeholder}, ix -> {["$", Integer.to_string(placeholder)], ix}
+              _value, ix -> {["$", Integer.to_string(ix)], ix + 1}
+            end)
+
+          {["(", Enum.intersperse(values, ", "), ")"], ix}
+        end)
+
+      Enum.intersperse(rows, ", ")
+    end
+
+    defp on_conflict({:raise, _, []}, _header), do: []
+
+    defp on_conflict({:nothing, _, targets}, _header),
+      do: [" ON CONFLICT ", conflict_target(targets) | "DO NOTHING"]
+
+    defp on_conflict({fields, _, targets}, _header) when is_list(fields) do
+      [
+        " ON CONFLICT ",
+        conflict_target(targets),
+        "DO UPDATE SET "
+        | Enum.map_intersperse(fields, ", ", fn field ->
+            quoted = quote_name(field)
+            [quoted, " = EXCLUDED.", quoted]
+          end)
+      ]
+    end
+
+    defp on_conflict({%Ecto.Query{}, _, _}, _header) do
+      raise ArgumentError, "the DuckDB adapter does not support on_conflict with a query"
+    end
+
+    defp conflict_target({:unsafe_fragment, fragment}), do: [fragment, " "]
+    defp conflict_target([]), do: []
+
+    defp conflict_target(targets),
+      do: ["(", Enum.map_intersperse(targets, ", ", &quote_name/1), ") "]
+
+    defp returning([]), do: []
+    defp returning(fields),
+      do: [" RETURNING " | Enum.map_intersperse(fields, ", ", &quote_name/1)]
+
+    ## Query parts
+
+    defp check_unsupported(query) do
+      cond do
+        query.combinations != [] -> error!(query, "unions and intersections are not supported")
+        query.with_ctes -> error!(query, "CTEs are not supported")
+        query.lock -> error!(query, "locks are not supported")
+        true -> :ok
+      end
+    end
+
+    defp check_no_joins(%{joins: []}), do: :ok
+    defp check_no_joins(query),
+      do: error!(query, "joins are not supported in updates and deletes")
+
+    defp select(%{select: %{fields: fields}, distinct: distinct} = query, sources) do
+      ["SELECT ", distinct(distinct, sources, query) | select_fields(fields, sources, query)]
+    end
+
+    defp distinct(nil, _sources, _query), do: []
+    defp distinct(%QueryExpr{expr: true}, _sources, _query), do: "DISTINCT "
+    defp distinct(%QueryExpr{expr: false}, _sources, _query), do: []
+
+    defp distinct(%QueryExpr{expr: exprs}, sources, query) when is_list(exprs) do
+      [
+        "DISTINCT ON (",
+        Enum.map_intersperse(exprs, ", ", fn {_dir, expr} -> expr(expr, sources, query) end),
+        ") "
+      ]
+    end
+
+    defp select_fields([], _sources, _query), do: "TRUE"
+
+    defp select_fields(fields, sources, query) do
+      Enum.map_intersperse(fields, ", ", fn
+        {key, value} -> [select_expr(value, sources, query), " AS " | quote_name(key)]
+        value -> select_expr(value, sources, query)
+      end)
+    end
+
+    # DECIMAL values decode to floats, so decimal schema fields are read as their exact text
+    defp select_expr({{:., _, [{:&, _, [ix]}, field]}, _, []} = expr, sources, query)
+         when is_atom(field) do
+      case elem(sources, ix) do
+        {_table, _name, schema} when schema != nil ->
+          if schema.__schema__(:type, field) == :decimal,
+            do: ["CAST(", expr(expr, sources, query), " AS VARCHAR)"],
+            else: expr(expr, sources, query)
+
+        _ ->
+          expr(expr, sources, query)
+      end
+    end
+
+    defp select_expr(expr, sources, query), do: expr(expr, sources, query)
+
+    defp from(_query, sources) do
+      {table, name, _schema} = elem(sources, 0)
+      [" FROM ", table, " AS " | name]
+    end
+
+    defp join(%{joins: []}, _sources), do: []
+
+    defp join(%{joins: joins} = query, sources) do
+      for %JoinExpr{qual: qual, ix: ix, on: %QueryExpr{expr: on}} <- joins do
+        {table, name, _schema} = elem(sources, ix)
+        [join_qual(qual, query), table, " AS ", name | join_on(qual, on, sources, query)]
+      end
+    end
+
+    defp join_on(:cross, true, _sources, _query), do: []
+    defp join_on(_qual, on, sources, query), do: [" ON " | expr(on, sources, query)]
+
+    defp join_qual(:inner, _query), do: " INNER JOIN "
+    defp join_qual(:left, _query), do: " LEFT OUTER JOIN "
+    defp join_qual(:right, _query), do: " RIGHT OUTER JOIN "
+    defp join_qual(:full, _query), do: " FULL OUTER JOIN "
+    defp join_qual(:cross, _query), do: " CROSS JOIN "
+    defp join_qual(qual, query),
+      do: error!(query, "join qualifier #{inspect(qual)} is not supported")
+
+    defp group_by(%{group_bys: []}, _sources), do: []
+
+    defp group_by(%{group_bys: group_bys} = query, sources) do
+      [
+        " GROUP BY "
+        | Enum.map_intersperse(group_bys, ", ", fn %QueryExpr{expr: exprs} ->
+            Enum.map_intersperse(exprs, ", ", &expr(&1, sources, query))
+          end)
+      ]
+    end
+
+    defp order_by(%{order_bys: []}, _sources), do: []
+
+    defp order_by(%{order_bys: order_bys} = query, sources) do
+      [
+        " ORDER BY "
+        | Enum.map_intersperse(order_bys, ", ", fn %QueryExpr{expr: exprs} ->
+            Enum.map_intersperse(exprs, ", ", fn {dir, expr} ->
+              [expr(expr, sources, query) | order_direction(dir)]
+            end)
+          end)
+      ]
+    end
+
+    defp order_direction(:asc), do: []
+    defp order_direction(:desc), do: " DESC"
+    defp order_direction(:asc_nulls_first), do: " ASC NULLS FIRST"
+    defp order_direction(:asc_nulls_last), do: " ASC NULLS LAST"
+    defp order_direction(:desc_nulls_first), do: " DESC NULLS FIRST"
+    defp order_direction(:desc_nulls_last), do: " DESC NULLS LAST"
+
+    defp limit(%{limit: nil}, _sources), do: []
+    defp limit(%{limit: %{expr: expr}} = query, sources),
+      do: [" LIMIT " | expr(expr, sources, query)]
+
+    defp offset(%{offset: nil}, _sources), do: []
+
+    defp offset(%{offset: %{expr: expr}} = query, sources),
+      do: [" OFFSET " | expr(expr, sources, query)]
+
+    defp returning(%{select: nil}, _sources), do: []
+
+    defp returning(%{select: %{fields: fields}} = query, sources),
+      do: [" RETURNING " | select_fields(fields, sources, query)]
+
+    defp update_fields(%{updates: updates} = query, sources) do
+      fields =
+        for %QueryExpr{expr: expr} <- updates, {op, values} <- expr, {key, value} <- values do
+          update_op(op, key, value, sources, query)
+        end
+
+      Enum.intersperse(fields, ", ")
+    end
+
+    defp update_op(:set, key, value, sources, query),
+      do: [quote_name(key), " = " | expr(value, sources, query)]
+
+    defp update_op(:inc, key, value, sources, query) do
+      quoted = quote_name(key)
+      [quoted, " = ", quoted, " + " | expr(value, sources, query)]
+    end
+
+    defp update_op(op, _key, _value, _sources, query),
+      do: error!(query, "update operation #{inspect(op)} is not supported")
+
+    defp boolean(_name, [], _sources, _query), do: []
+
+    defp boolean(name, [%BooleanExpr{expr: expr, op: op} | rest], sources, query) do
+      {_op, sql} =
+        Enum.reduce(rest, {op, paren_expr(expr, sources, query)}, fn
+          %BooleanExpr{expr: expr, op: op}, {op, acc} ->
+            {op, [acc, boolean_op(op) | paren_expr(expr, sources, query)]}
+
+          %BooleanExpr{expr: expr, op: op}, {_previous, acc} ->
+            {op, ["(", acc, ")", boolean_op(op) | paren_expr(expr, sources, query)]}
+        end)
+
+      [name | sql]
+    end
+
+    defp boolean_op(:and), do: " AND "
+    defp boolean_op(:or), do: " OR "
+
+    ## Expressions
+
+    defp paren_expr(expr, sources, query), do: ["(", expr(expr, sources, query), ")"]
+
+    defp expr({:^, [], [ix]}, _sources, _query), do: ["$" | Integer.to_string(ix + 1)]
+
+    defp expr({{:., _, [{:&, _, [ix]}, field]}, _, []}, sources, _query) when is_atom(field) do
+      {_table, name, _schema} = elem(sources, ix)
+      [name, "." | quote_name(field)]
+    end
+
+    defp expr({:&, _, [ix]}, sources, _query) do
+      {_table, name, _schema} = elem(sources, ix)
+      name
+    end
+
+    defp expr({:in, _, [_left, []]}, _sources, _query), do: "FALSE"
+
+    defp expr({:in, _, [left, right]}, sources, query) when is_list(right) do
+      [
+        expr(left, sources, query),
+        " IN (",
+        Enum.map_intersperse(right, ", ", &expr(&1, sources, query)),
+        ")"
+      ]
+    end
+
+    defp expr({:in, _, [_left, {:^, _, [_ix, 0]}]}, _sources, _query), do: "FALSE"
+
+    # `in ^list` takes `length` consecutive parameters starting at `ix`
+    defp expr({:in, _, [left, {:^, _, [ix, length]}]}, sources, query) do
+      [
+        expr(left, sources, query),
+        " IN (",
+        Enum.map_intersperse((ix + 1)..(ix + length), ", ", &["$" | Integer.to_string(&1)]),
+        ")"
+      ]
+    end
+
+    defp expr({:is_nil, _, [arg]}, sources, query),
+      do: [operand(arg, sources, query), " IS NULL"]
+
+    defp expr({:not, _, [expr]}, sources, query), do: ["NOT (", expr(expr, sources, query), ")"]
+
+    defp expr({:fragment, _, parts}, sources, query) do
+      Enum.map(parts, fn
+        {:raw, part} -> part
+        {:expr, expr} -> expr(expr, sources, query)
+      end)
+    end
+
+    defp expr({:count, _, []}, _sources, _query), do: "count(*)"
+
+    defp expr({fun, _, [datetime, count, interval]}, sources, query)
+         when fun in [:datetime_add, :date_add] do
+      function =
+        Map.get(@interval_functions, interval) ||
+          error!(query, "interval #{inspect(interval)} is not supported")
+
+      cast = if fun == :date_add, do: "DATE", else: "TIMESTAMP"
+
+      [
+        "CAST(",
+        expr(datetime, sources, query),
+        " + ",
+        function,
+        "(",
+        expr(count, sources, query),
+        ") AS ",
+        cast,
+        ")"
+      ]
+    end
+
+    defp expr({:selected_as, _, [name]}, _sources, _query), do: quote_name(name)
+
+    defp expr({:{}, _, elems}, sources, query),
+      do: ["(", Enum.map_intersperse(elems, ", ", &expr(&1, sources, query)), ")"]
+
+    defp expr(%Ecto.SubQuery{}, _sources, query),
+      do: error!(query, "subqueries are not supported")
+
+    defp expr({:exists, _, _}, _sources, query), do: error!(query, "exists is not supported")
+
+    defp expr({op, _, [left, right]}, sources, query) when op in @binary_op_names do
+      [
+        operand(left, sources, query),
+        Keyword.fetch!(@binary_ops, op) | operand(right, sources, query)
+      ]
+    end
+
+    defp expr({fun, _, args}, sources, query) when is_atom(fun) and is_list(args) do
+      {modifier, args} =
+        case args do
+          [arg, :distinct] -> {"DISTINCT ", [arg]}
+          _ -> {[], args}
+        end
+
+      [
+        Atom.to_string(fun),
+        "(",
+        modifier,
+        Enum.map_intersperse(args, ", ", &expr(&1, sources, query)),
+        ")"
+      ]
+    end
+
+    defp expr(%Tagged{value: value, type: type}, sources, query),
+      do: ["CAST(", expr(value, sources, query), " AS ", column_type(type), ")"]
+
+    defp expr(list, sources, query) when is_list(list),
+      do: ["[", Enum.map_intersperse(list, ", ", &expr(&1, sources, query)), "]"]
+
+    defp expr(%Decimal{} = decimal, _sources, _query), do: Decimal.to_string(decimal, :normal)
+    defp expr(nil, _sources, _query), do: "NULL"
+    defp expr(true, _sources, _query), do: "TRUE"
+    defp expr(false, _sources, _query), do: "FALSE"
+    defp expr(literal, _sources, _query) when is_binary(literal), do: quote_literal(literal)
+    defp expr(literal, _sources, _query) when is_integer(literal), do: Integer.to_string(literal)
+    defp expr(literal, _sources, _query) when is_float(literal), do: Float.to_string(literal)
+
+    defp expr(expr, _sources, query),
+      do: error!(query, "unsupported expression #{inspect(expr)}")
+
+    # Nested binary operators and IS NULL checks are parenthesized to keep their precedence
+    defp operand({op, _, [_, _]} = expr, sources, query) when op in @binary_op_names,
+      do: paren_expr(expr, sources, query)
+
+    defp operand({:is_nil, _, [_]} = expr, sources, query), do: paren_expr(expr, sources, query)
+    defp operand(expr, sources, query), do: expr(expr, sources, query)
+
+    ## Helpers
+
+    defp create_names(%{sources: sources} = query) do
+      sources
+      |> Tuple.to_list()
+      |> Enum.with_index()
+      |> Enum.map(fn
+        {{source, schema, prefix}, ix} when is_binary(source) ->
+          {quote_table(prefix, source), "t#{ix}", schema}
+
+        {{:fragment, _, _}, _ix} ->
+          error!(query, "fragment sources are not supported")
+
+        {%Ecto.SubQuery{}, _ix} ->
+          error!(query, "subqueries are not supported")
+      end)
+      |> List.to_tuple()
+    end
+
+    def column_type(:id), do: "BIGINT"
+    def column_type(:integer), do: "BIGINT"
+    def column_type(:float), do: "DOUBLE"
+    def column_type(:boolean), do: "BOOLEAN"
+    def column_type(:string), do: "VARCHAR"
+    def column_type(:binary), do: "BLOB"
+    def column_type(:binary_id), do: "UUID"
+    def column_type(:uuid), do: "UUID"
+    def column_type(:map), do: "JSON"
+    def column_type({:map, _}), do: "JSON"
+    def column_type(:decimal), do: "DECIMAL"
+    def column_type(:date), do: "DATE"
+    def column_type(type) when type in [:time, :time_usec], do: "TIME"
+
+    def column_type(type)
+        when type in [:naive_datetime, :naive_datetime_usec, :utc_datetime, :utc_datetime_usec],
+        do: "TIMESTAMP"
+
+    def column_type({:array, type}), do: column_type(type) <> "[]"
+    def column_type(type) when is_atom(type), do: type |> Atom.to_string() |> String.upcase()
+
+    defp quote_table(nil, table), do: quote_name(table)
+    defp quote_table(prefix, table), do: [quote_name(prefix), "." | quote_name(table)]
+
+    defp quote_name(name) when is_atom(name), do: quote_name(Atom.to_string(name))
+    defp quote_name(name), do: [?", String.replace(name, ~s("), ~s("")), ?"]
+
+    defp quote_literal(text), do: [?', String.replace(text, "'", "''"), ?']
+
+    defp error!(query, message) do
+      raise Ecto.QueryError, query: query, message: "DuckDB adapter: #{message}"
+    end
+  end
+end
@@ -9,6 +9,7 @@ defmodule DuckdbEx.MixProject do
       compilers: [:elixir_make] ++ Mix.compilers(),
       make_targets: ["all"],
       make_clean: ["clean"],
+      elixirc_paths: elixirc_paths(Mix.env()),
       start_permanent: Mix.env() == :prod,
       deps: deps(),
       docs: docs(),
@@ -24,15 +25,21 @@ defmodule DuckdbEx.MixProject do
 
   def application do
     [
+      mod: {DuckdbEx.Application, []},
       extra_applications: [:logger]
     ]
   end
 
+  defp elixirc_paths(:test), do: ["lib", "test/support"]
+  defp elixirc_paths(_), do: ["lib"]
+
   defp deps do
     [
       {:elixir_make, "~> 0.8", runtime: false},
       {:ex_doc, "~> 0.31", only: :dev, runtime: false},
-      {:jason, "~> 1.4"}
+      {:jason, "~> 1.4"},
+      {:ecto, "~> 3.10", optional: true},
+      {:gen_stage, "~> 1.2", optional: true}
     ]
   end
 
@@ -144,8 +151,8 @@ defmodule DuckdbEx.MixProject do
       api_reference: true,
       formatters: ["html"],
       filter_modules: fn module, _metadata ->
-        # Only include modules that start with DuckdbEx
-        String.starts_with?(to_string(module), "Elixir.DuckdbEx")
+        # Only include modules that start with DuckdbEx, and the Ecto adapter
+        String.starts_with?(to_string(module), ["Elixir.DuckdbEx", "Elixir.Ecto.Adapters.DuckDB"])
       end
     ]
   end
@@ -187,12 +194,12 @@ defmodule DuckdbEx.MixProject do
     priv_dir = "priv"
 
     if File.exists?(priv_dir) do
-      [
-        Path.join(priv_dir, "duckdb_ex.so"),
-        Path.join(priv_dir, "duckdb_ex.dll"),
-        Path.join(priv_dir, "libduckdb.dylib"),
-        Path.join(priv_dir, "libduckdb.so")
-      ]
+      ([
+         Path.join(priv_dir, "duckdb_ex.so"),
+         Path.join(priv_dir, "duckdb_ex.dll"),
+         Path.join(priv_dir, "libduckdb.dylib"),
+         Path.join(priv_dir, "libduckdb.so")
+       ] ++ Path.wildcard(Path.join(priv_dir, "duckdb_ex-*.{so,dll}")))
       |> Enum.each(fn file ->
         if File.exists?(file) do
           File.rm!(file)
@@ -539,7 +539,7 @@ defmodule DuckdbEx.AllTypesTest do
         # UUID is returned as 32-character hex string (without dashes) in chunked API
         assert String.length(uuid_val) == 36
         assert is_float(decimal_val) or is_binary(decimal_val) or is_number(decimal_val)
-        assert is_binary(timestamp_s)
+        assert timestamp_s == ~U[2023-12-25 14:30:45Z]
       end)
     end
   end
@@ -59,4 +59,23 @@ defmodule DuckdbEx.ChunkedTest do
 
     DuckdbEx.destroy_result(result)
   end
+
+  test "rows_chunked keeps row order across multiple chunks", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, "SELECT i, 'row_' || i AS label FROM range(10000) t(i) ORDER BY i")
+
+    assert DuckdbEx.chunk_count(result) > 1
+
+    rows = DuckdbEx.Result.rows_chunked(result)
+    assert length(rows) == 10_000
+    assert rows == Enum.map(0..9_999, &{&1, "row_#{&1}"})
+
+    DuckdbEx.destroy_result(result)
+  end
+
+  test "rows_chunked returns an empty list for empty results", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT 1 AS a WHERE false")
+
+    assert DuckdbEx.Result.rows_chunked(result) == []
+  end
 end
@@ -15,9 +15,33 @@ defmodule DuckdbEx.ChunkedUuidTest do
     assert uuid_str =~ ~r/^[0-9a-f]{8}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{12}$/i
 
     regular_rows = DuckdbEx.rows(result)
-    assert is_list(regular_rows)
-    assert length(regular_rows) == 1
-    assert [{nil}] = regular_rows
+    assert regular_rows == chunked_rows
+
+    DuckdbEx.close_connection(conn)
+    DuckdbEx.close_database(db)
+  end
+
+  test "UUIDs are formatted in canonical order" do
+    {:ok, db} = DuckdbEx.open()
+    {:ok, conn} = DuckdbEx.connect(db)
+
+    {:ok, result} =
+      DuckdbEx.query(conn, """
+      SELECT '550e8400-e29b-41d4-a716-446655440000'::UUID AS a,
+             'ffffffff-0000-4000-8000-000000000001'::UUID AS b,
+             NULL::UUID AS c
+      """)
+
+    assert [
+             {"550e8400-e29b-41d4-a716-446655440000", "ffffffff-0000-4000-8000-000000000001",
+              nil}
+           ] = DuckdbEx.Result.rows_chunked(result)
+
+    assert [{a, b, nil}] = DuckdbEx.Result.rows_chunked(result, uuid: :raw)
+    assert a == Base.decode16!("550E8400E29B41D4A716446655440000")
+    assert b == Base.decode16!("FFFFFFFF000040008000000000000001")
+
+    assert [{"550e8400-e29b-41d4-a716-446655440000", _, nil}] = DuckdbEx.rows(result)
 
     DuckdbEx.close_connection(conn)
     DuckdbEx.close_database(db)
@@ -11,24 +11,25 @@ defmodule DuckdbEx.ColumnOrderTest do
     rows1 = DuckdbEx.rows(result1)
     assert is_list(rows1)
     assert length(rows1) == 1
-    # When UUID is present in multi-column context, regular API returns nil for all columns
-    assert [nil: nil] = rows1
+    # Results with UUID columns are decoded from chunks, keeping every column
+    assert [{123, uuid}] = rows1
+    assert String.length(uuid) == 36
 
     # Test 2: Three columns with UUID in middle
     {:ok, result2} = DuckdbEx.query(conn, "SELECT 1 as col1, uuid() as uuid_col, 3 as col3")
     rows2 = DuckdbEx.rows(result2)
     assert is_list(rows2)
     assert length(rows2) == 1
-    # With UUID in multi-column context, all columns return nil
-    assert [{nil, nil, nil}] = rows2
+    assert [{1, uuid, 3}] = rows2
+    assert String.length(uuid) == 36
 
     # Test 3: Two UUIDs
     {:ok, result3} = DuckdbEx.query(conn, "SELECT uuid() as uuid1, uuid() as uuid2")
     rows3 = DuckdbEx.rows(result3)
     assert is_list(rows3)
     assert length(rows3) == 1
-    # Multiple UUIDs also return nil for all columns
-    assert [nil: nil] = rows3
+    assert [{uuid1, uuid2}] = rows3
+    assert uuid1 != uuid2
 
     DuckdbEx.close_connection(conn)
     DuckdbEx.close_database(db)
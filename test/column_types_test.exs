@@ -0,0 +1,52 @@
+defmodule DuckdbEx.ColumnTypesTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  alias DuckdbEx.Result
+
+  setup :open_connection
+
+  test "full mode describes nested logical types", %{conn: conn} do
+    {:ok, _} = DuckdbEx.query(conn, "CREATE TYPE mood AS ENUM ('sad', 'happy')")
+
+    {:ok, result} =
+      DuckdbEx.query(conn, """
+      SELECT 1.5::DECIMAL(10,3) AS d,
+             [1, 2]::INTEGER[] AS l,
+             [1.0, 2.0, 3.0]::FLOAT[3] AS a,
+             {'id': 1, 'tags': ['x']} AS s,
+             MAP {'k': 1.0::DOUBLE} AS m,
+             'happy'::mood AS e
+      """)
+
+    assert [d, l, a, s, m, e] = Result.columns(result, types: :full)
+
+    assert %{name: "d", type: :decimal, logical_type: %{type: :decimal, width: 10, scale: 3}} = d
+    assert l.logical_type == %{type: :list, child: %{type: :integer}}
+    assert a.logical_type == %{type: :array, child: %{type: :float}, size: 3}
+
+    assert s.logical_type == %{
+             type: :struct,
+             fields: [
+               {"id", %{type: :integer}},
+               {"tags", %{type: :list, child: %{type: :varchar}}}
+             ]
+           }
+
+    assert m.logical_type == %{type: :map, key: %{type: :varchar}, value: %{type: :double}}
+    assert e.logical_type == %{type: :enum, values: ["sad", "happy"]}
+
+    assert Result.columns(result) == Enum.map([d, l, a, s, m, e], &Map.delete(&1, :logical_type))
+  end
+
+  test "descriptors are cached and survive until the result is destroyed", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT 1 AS x")
+
+    first = DuckdbEx.columns(result, types: :full)
+    assert first == DuckdbEx.columns(result, types: :full)
+
+    Result.destroy(result)
+    assert {:error, "Result has been destroyed"} = Result.columns(result, types: :full)
+  end
+end
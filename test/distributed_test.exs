@@ -0,0 +1,133 @@
+defmodule DuckdbEx.DistributedTest do
+  # Shards are registered in :persistent_term and the peer test starts distribution
+  use ExUnit.Case, async: false
+
+  import DuckdbEx.TestHelpers
+
+  alias DuckdbEx.Distributed
+
+  @shards [:east, :west, :north]
+
+  setup do
+    for {shard, offset} <- Enum.with_index(@shards) do
+      conn = open_connection()
+
+      {:ok, _} =
+        DuckdbEx.query(conn, """
+        CREATE TABLE sales AS
+        SELECT CASE WHEN i % 2 = 0 THEN 'a' ELSE 'b' END AS region,
+               (i + #{offset * 100})::BIGINT AS amount
+        FROM range(10) t(i)
+        """)
+
+      :ok = Distributed.register_shard(shard, conn)
+    end
+
+    on_exit(fn -> Enum.each(@shards, &Distributed.unregister_shard/1) end)
+
+    %{targets: Enum.map(@shards, &{node(), &1})}
+  end
+
+  test "decomposable aggregates are merged from shard partials", %{targets: targets} do
+    shard_sql = """
+    SELECT region, sum(amount) AS total, count(*) AS n, min(amount) AS lo, max(amount) AS hi
+    FROM sales GROUP BY region
+    """
+
+    assert {:ok, {columns, rows}} =
+             Distributed.query(targets, shard_sql,
+               group_by: [:region],
+               aggregates: [total: :sum, n: :count, lo: :min, hi: :max, mean: {:avg, :total, :n}]
+             )
+
+    assert Enum.map(columns, & &1.name) == ["region", "total", "n", "lo", "hi", "mean"]
+
+    # Shard k holds amounts k*100 .. k*100+9; region a gets the even ones
+    assert rows == [
+             {"a", 1560, 15, 0, 208, 104.0},
+             {"b", 1575, 15, 1, 209, 105.0}
+           ]
+  end
+
+  test "an explicit merge query and plain concatenation", %{targets: targets} do
+    assert {:ok, {_, [{3000}]}} =
+             Distributed.query(targets, "SELECT count(*) AS n FROM sales",
+               merge: "SELECT sum(n)::BIGINT * 100 FROM partials"
+             )
+
+    assert {:ok, {_, rows}} = Distributed.query(targets, "SELECT max(amount) FROM sales;")
+    assert Enum.sort(rows) == [{9}, {109}, {209}]
+
+    assert {:ok, {_, rows}} = Distributed.query(targets, "SELECT min(amount) FROM sales -- low")
+    assert Enum.sort(rows) == [{0}, {100}, {200}]
+  end
+
+  test "shard failures name the target", %{targets: [first | _] = targets} do
+    missing = {node(), :missing}
+
+    assert {:error, {^missing, reason}} = Distributed.query([missing | targets], "SELECT 1")
+    assert reason =~ "no shard :missing"
+
+    # The requests still outstanding after the failure never reply to the caller
+    refute_receive _, 200
+
+    assert {:error, {^first, reason}} = Distributed.query([first], "SELECT * FROM nope")
+    assert is_binary(reason)
+  end
+
+  @tag timeout: 120_000
+  test "shards on a peer node are merged with local ones", %{targets: targets} do
+    unless Node.alive?() do
+      {:ok, _} = Node.start(:"duckdb_ex_distributed_test@127.0.0.1", :longnames)
+    end
+
+    {:ok, peer, peer_node} =
+      :peer.start_link(%{
+        name: :peer.random_name(),
+        host: ~c"127.0.0.1",
+        longnames: true,
+        args: [~c"-setcookie", Atom.to_charlist(Node.get_cookie())]
+      })
+
+    try do
+      :ok = :erpc.call(peer_node, :code, :add_paths, [:code.get_path()])
+      {:ok, _} = :erpc.call(peer_node, Application, :ensure_all_started, [:duckdb_ex])
+
+      # Evaluated on the peer so the shard's connection stays referenced there
+      shard_setup = """
+      {:ok, db} = DuckdbEx.open()
+      {:ok, conn} = DuckdbEx.connect(db)
+      sql = "SELECT 'c' AS region, (i + 1000)::BIGINT AS amount FROM range(10) t(i)"
+      {:ok, _} = DuckdbEx.query(conn, "CREATE TABLE sales AS " <> sql)
+      DuckdbEx.Distributed.register_shard(conn)
+      """
+
+      {:ok, _binding} = :erpc.call(peer_node, Code, :eval_string, [shard_setup])
+
+      shard_sql = "SELECT region, sum(amount) AS total FROM sales GROUP BY region"
+
+      assert {:ok, {_, rows}} =
+               Distributed.query([peer_node | targets], shard_sql,
+                 group_by: [:region],
+                 aggregates: [total: :sum]
+               )
+
+      assert rows == [{"a", 1560}, {"b", 1575}, {"c", 10_045}]
+
+      missing = {peer_node, :missing}
+      assert {:error, {^missing, reason}} = Distributed.query([missing, peer_node], "SELECT 1")
+      assert reason =~ "no shard :missing"
+      refute_receive _, 200
+    after
+      :peer.stop(peer)
+    end
+  end
+
+  test "merge_sql builds the re-aggregation query" do
+    assert Distributed.merge_sql([:region], total: :sum, n: :count) ==
+             ~s(SELECT "region", sum("total") AS "total", sum("n")::BIGINT AS "n" ) <>
+               ~s(FROM partials GROUP BY "region" ORDER BY "region")
+
+    assert_raise ArgumentError, fn -> Distributed.merge_sql([], x: :median) end
+  end
+end
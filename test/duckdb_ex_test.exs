@@ -22,6 +22,19 @@ defmodule DuckdbExTest do
     assert is_reference(conn)
   end
 
+  test "closed connections and databases refuse further use", %{db: db, conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT 1")
+
+    assert :ok = DuckdbEx.close_connection(conn)
+    assert {:error, "Connection has been closed"} = DuckdbEx.query(conn, "SELECT 1")
+    assert {:error, "Connection has been closed"} = DuckdbEx.begin_transaction(conn)
+    assert DuckdbEx.rows(result) == [{1}]
+
+    assert :ok = DuckdbEx.close_database(db)
+    assert {:error, "Database has been closed"} = DuckdbEx.connect(db)
+    assert :ok = DuckdbEx.close_database(db)
+  end
+
   test "executes simple query", %{conn: conn} do
     {:ok, result} = DuckdbEx.query(conn, "SELECT 42 as answer, 'hello' as greeting")
 
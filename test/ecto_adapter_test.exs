@@ -0,0 +1,151 @@
+defmodule DuckdbEx.EctoAdapterTest do
+  use ExUnit.Case, async: false
+
+  import Ecto.Query
+
+  alias Ecto.Adapters.DuckDB
+
+  defmodule Repo do
+    use Ecto.Repo, otp_app: :duckdb_ex, adapter: Ecto.Adapters.DuckDB
+  end
+
+  defmodule Event do
+    use Ecto.Schema
+
+    schema "events" do
+      field(:kind, :string)
+      field(:amount, :decimal)
+      field(:occurred_at, :utc_datetime_usec)
+      field(:ref, Ecto.UUID)
+      field(:payload, :map)
+    end
+  end
+
+  setup do
+    start_supervised!({Repo, database: nil})
+
+    {:ok, _} = DuckDB.query(Repo, "CREATE SEQUENCE events_id START 1")
+
+    {:ok, _} =
+      DuckDB.query(Repo, """
+      CREATE TABLE events (
+        id BIGINT PRIMARY KEY DEFAULT nextval('events_id'),
+        kind VARCHAR,
+        amount DECIMAL(10, 2),
+        occurred_at TIMESTAMP,
+        ref UUID,
+        payload JSON
+      )
+      """)
+
+    :ok
+  end
+
+  test "inserted rows load back into their Ecto types" do
+    ref = Ecto.UUID.generate()
+
+    event =
+      Repo.insert!(%Event{
+        kind: "click",
+        amount: Decimal.new("12.34"),
+        occurred_at: ~U[2024-05-01 10:00:00.123456Z],
+        ref: ref,
+        payload: %{"x" => 1}
+      })
+
+    assert is_integer(event.id)
+
+    loaded = Repo.get!(Event, event.id)
+    assert loaded.kind == "click"
+    assert Decimal.equal?(loaded.amount, Decimal.new("12.34"))
+    assert loaded.occurred_at == ~U[2024-05-01 10:00:00.123456Z]
+    assert loaded.ref == ref
+    assert loaded.payload == %{"x" => 1}
+  end
+
+  test "queries take parameters, lists and aggregates" do
+    for {kind, amount} <- [{"click", "1.50"}, {"view", "2.25"}, {"click", "3.00"}] do
+      Repo.insert!(%Event{kind: kind, amount: Decimal.new(amount)})
+    end
+
+    assert Repo.all(from(e in Event, where: e.kind == ^"click", select: e.amount, order_by: e.id))
+           |> Enum.map(&Decimal.to_string/1) == ["1.50", "3.00"]
+
+    assert Repo.aggregate(from(e in Event, where: e.kind in ^["click", "view"]), :count) == 3
+
+    assert Repo.all(
+             from(e in Event,
+               group_by: e.kind,
+               order_by: e.kind,
+               select: {e.kind, count(e.id)}
+             )
+           ) == [{"click", 2}, {"view", 1}]
+
+    clicks = from(e in Event, where: e.kind == "click")
+    assert {2, nil} = Repo.update_all(clicks, set: [kind: "tap"])
+    assert {1, nil} = Repo.delete_all(from(e in Event, where: e.kind == "view"))
+    assert Repo.all(from(e in Event, select: e.kind)) == ["tap", "tap"]
+  end
+
+  test "insert_all appends the entries" do
+    entries =
+      for i <- 1..5000 do
+        %{kind: "k#{rem(i, 3)}", amount: Decimal.new(i), occurred_at: ~U[2024-01-01 00:00:00Z]}
+      end
+
+    assert {5000, nil} = Repo.insert_all(Event, entries)
+    assert Repo.aggregate(Event, :count) == 5000
+    assert Decimal.equal?(Repo.aggregate(Event, :sum, :amount), Decimal.new(12_502_500))
+
+    # Entries setting different fields go through INSERT and leave the rest to the defaults
+    assert {2, nil} = Repo.insert_all(Event, [%{kind: "a"}, %{amount: Decimal.new(1)}])
+    assert Repo.aggregate(Event, :count) == 5002
+  end
+
+  test "stream reads the results a chunk at a time" do
+    Repo.insert_all(Event, for(i <- 1..5000, do: %{kind: "k", amount: Decimal.new(i)}))
+
+    assert {:ok, 5000} =
+             Repo.transaction(fn ->
+               from(e in Event, where: e.kind == ^"k", select: e.id)
+               |> Repo.stream()
+               |> Enum.count()
+             end)
+  end
+
+  test "transactions commit and roll back" do
+    assert {:ok, _} = Repo.transaction(fn -> Repo.insert!(%Event{kind: "kept"}) end)
+
+    assert {:error, :nope} =
+             Repo.transaction(fn ->
+               Repo.insert!(%Event{kind: "dropped"})
+               Repo.rollback(:nope)
+             end)
+
+    assert Repo.all(from(e in Event, select: e.kind)) == ["kept"]
+  end
+
+  test "the statement cache drops only the least recently used statement" do
+    for i <- 2..300 do
+      {:ok, _} = DuckDB.query(Repo, "SELECT #{i}")
+      {:ok, _} = DuckDB.query(Repo, "SELECT 1")
+    end
+
+    [statements] =
+      for {{DuckDB, :statements, _db}, {statements, _tick}} <- Process.get(), do: statements
+
+    assert map_size(statements) == 256
+    assert Map.has_key?(statements, "SELECT 1")
+    assert Map.has_key?(statements, "SELECT 300")
+    refute Map.has_key?(statements, "SELECT 2")
+  end
+
+  test "updating a deleted row is stale" do
+    event = Repo.insert!(%Event{kind: "click"})
+    Repo.delete!(event)
+
+    assert_raise Ecto.StaleEntryError, fn ->
+      event |> Ecto.Changeset.change(kind: "view") |> Repo.update!()
+    end
+  end
+end
@@ -0,0 +1,49 @@
+defmodule DuckdbEx.FixedWidthDecodingTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  setup :open_connection
+
+  test "fully valid, mixed and all-NULL validity words decode alike", %{conn: conn} do
+    # Rows 0..63 are all valid, 64..127 mix NULLs, 128..191 are all NULL, the rest straddle
+    # the 2048-row vector boundary
+    {:ok, result} =
+      DuckdbEx.query(conn, """
+      SELECT
+        CASE WHEN i < 64 OR (i < 128 AND i % 3 <> 0) OR i >= 192 THEN i END::INTEGER AS n,
+        CASE WHEN i % 5 <> 0 THEN i % 2 = 0 END AS b,
+        CASE WHEN i % 7 <> 0 THEN ((i % 200) - 100)::TINYINT END AS t,
+        CASE WHEN i % 11 <> 0 THEN i * 1000000000000 END::UBIGINT AS u,
+        CASE WHEN i % 13 <> 0 THEN i / 4 END::FLOAT AS f
+      FROM range(2100) t(i)
+      ORDER BY i
+      """)
+
+    chunked = DuckdbEx.Result.rows_chunked(result)
+
+    expected =
+      for i <- 0..2099 do
+        n = if i < 64 or (i < 128 and rem(i, 3) != 0) or i >= 192, do: i
+        b = if rem(i, 5) != 0, do: rem(i, 2) == 0
+        t = if rem(i, 7) != 0, do: rem(i, 200) - 100
+        u = if rem(i, 11) != 0, do: i * 1_000_000_000_000
+        f = if rem(i, 13) != 0, do: i / 4
+        {n, b, t, u, f}
+      end
+
+    assert chunked == expected
+    assert chunked == DuckdbEx.Result.rows(result)
+  end
+
+  test "NULL floats in mixed words are not mistaken for NaN", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, """
+      SELECT CASE WHEN i % 2 = 0 THEN i::DOUBLE WHEN i = 5 THEN 'nan'::DOUBLE END
+      FROM range(8) t(i) ORDER BY i
+      """)
+
+    assert DuckdbEx.Result.rows_chunked(result) ==
+             [{0.0}, {nil}, {2.0}, {nil}, {4.0}, {:nan}, {6.0}, {nil}]
+  end
+end
@@ -0,0 +1,6 @@
+CREATE TABLE events (
+    id BIGINT,
+    user_id BIGINT,
+    kind VARCHAR,
+    payload JSON
+);
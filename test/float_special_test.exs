@@ -0,0 +1,68 @@
+defmodule DuckdbEx.FloatSpecialTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  setup :open_connection
+
+  @specials """
+  SELECT * FROM (VALUES
+    (1.5::FLOAT, 2.5::DOUBLE),
+    ('nan'::FLOAT, 'nan'::DOUBLE),
+    ('inf'::FLOAT, 'inf'::DOUBLE),
+    ('-inf'::FLOAT, '-inf'::DOUBLE),
+    (NULL, NULL)
+  )
+  """
+
+  test "chunked and row decoding agree on NaN and infinities", %{conn: conn} do
+    expected = [
+      {1.5, 2.5},
+      {:nan, :nan},
+      {:infinity, :infinity},
+      {:negative_infinity, :negative_infinity},
+      {nil, nil}
+    ]
+
+    {:ok, result} = DuckdbEx.query(conn, @specials)
+    assert DuckdbEx.Result.rows_chunked(result) == expected
+    assert DuckdbEx.Result.rows(result) == expected
+  end
+
+  test "nan: nil returns non-finite values as nil", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, @specials)
+
+    assert DuckdbEx.Result.rows_chunked(result, nan: nil) == [
+             {1.5, 2.5},
+             {nil, nil},
+             {nil, nil},
+             {nil, nil},
+             {nil, nil}
+           ]
+  end
+
+  test "non-finite list elements and packed cells", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT ['nan'::DOUBLE, 1.0, '-inf'::DOUBLE]")
+    assert DuckdbEx.Result.rows_chunked(result) == [{[:nan, 1.0, :negative_infinity]}]
+
+    {:ok, result} = DuckdbEx.query(conn, "SELECT ['inf'::FLOAT, 2.0]::FLOAT[2]")
+    assert [{<<inf::binary-size(4), two::float-32-native>>}] =
+             DuckdbEx.Result.rows_chunked(result, numeric_lists: :packed)
+
+    assert inf == <<0x7F800000::32-native>>
+    assert two == 2.0
+  end
+
+  test "FLOAT is widened the same way by both paths", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT 0.1::FLOAT FROM range(3000)")
+    chunked = DuckdbEx.Result.rows_chunked(result)
+
+    assert length(chunked) == 3000
+    assert Enum.uniq(chunked) == Enum.uniq(DuckdbEx.Result.rows(result))
+  end
+
+  test "invalid nan option raises", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT 1.0::DOUBLE")
+    assert_raise ArgumentError, fn -> DuckdbEx.Result.rows_chunked(result, nan: :string) end
+  end
+end
@@ -0,0 +1,120 @@
+defmodule DuckdbEx.JsonTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  alias DuckdbEx.Appender
+
+  setup :open_connection
+
+  defp decode(conn, sql, opts \\ []) do
+    {:ok, result} = DuckdbEx.query(conn, sql)
+    DuckdbEx.Result.rows_chunked(result, [json: :decode] ++ opts)
+  end
+
+  test "JSON columns stay text by default", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, ~s(SELECT '{"a": 1}'::JSON))
+    assert [{text}] = DuckdbEx.Result.rows_chunked(result)
+    assert Jason.decode!(text) == %{"a" => 1}
+  end
+
+  test "objects, arrays and scalars decode to terms", %{conn: conn} do
+    sql = """
+    SELECT '{"id": 7, "score": -1.5e2, "tags": ["a", "b"], "ok": true, "none": null,
+             "nested": {"big": 18446744073709551616, "empty": {}, "list": []}}'::JSON
+    """
+
+    assert [{doc}] = decode(conn, sql)
+
+    assert doc == %{
+             "id" => 7,
+             "score" => -150.0,
+             "tags" => ["a", "b"],
+             "ok" => true,
+             "none" => nil,
+             "nested" => %{"big" => 18_446_744_073_709_551_616, "empty" => %{}, "list" => []}
+           }
+  end
+
+  test "numbers beyond int64 and double ranges keep their value", %{conn: conn} do
+    long = String.duplicate("9", 80)
+    sql = ~s(SELECT '[-#{long}, 1e400, 0.#{long}]'::JSON)
+
+    assert [{[negative, "1e400", float]}] = decode(conn, sql)
+    assert negative == -String.to_integer(long)
+    assert float == 1.0
+  end
+
+  test "string escapes and surrogate pairs decode to UTF-8", %{conn: conn} do
+    sql = ~S"""
+    SELECT '["line\nbreak", "quote \" slash \/", "\u00e9\u4e2d", "\ud83d\ude00"]'::JSON
+    """
+
+    assert [{["line\nbreak", "quote \" slash /", "é中", "😀"]}] = decode(conn, sql)
+  end
+
+  test "only allow-listed keys become atoms", %{conn: conn} do
+    sql = ~s(SELECT '{"name": "x", "kind": 1, "json_test_unknown_key": 2}'::JSON)
+
+    assert [{doc}] = decode(conn, sql, json_keys: [:name])
+    assert doc == %{:name => "x", "kind" => 1, "json_test_unknown_key" => 2}
+  end
+
+  test "NULL, plain VARCHAR and duplicate keys", %{conn: conn} do
+    sql = """
+    SELECT * FROM (VALUES ('{"a": 1, "a": 2}'::JSON, '{"a": 1}'), (NULL, NULL))
+    """
+
+    assert decode(conn, sql, dedup_strings: true) == [{%{"a" => 2}, ~s({"a": 1})}, {nil, nil}]
+  end
+
+  test "invalid decode options raise", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT 1")
+
+    assert_raise ArgumentError, fn -> DuckdbEx.Result.rows_chunked(result, json: :maps) end
+    assert_raise ArgumentError, fn -> DuckdbEx.Result.rows_chunked(result, json_keys: ["a"]) end
+  end
+
+  test "appended maps and lists round-trip through JSON columns", %{conn: conn} do
+    {:ok, _} = DuckdbEx.query(conn, "CREATE TABLE events (id INTEGER, payload JSON)")
+    {:ok, appender} = Appender.create(conn, nil, "events")
+
+    payload = %{"user" => "ana", "values" => [1, 2.5, nil, true], "meta" => %{"q" => "a\"b\n"}}
+
+    :ok = Appender.append_row(appender, [1, payload])
+    :ok = Appender.append_row(appender, [2, [%{kind: "atom key"}]])
+    :ok = Appender.close(appender)
+    :ok = Appender.destroy(appender)
+
+    assert decode(conn, "SELECT payload FROM events ORDER BY id") == [
+             {payload},
+             {[%{"kind" => "atom key"}]}
+           ]
+
+    {:ok, result} = DuckdbEx.query(conn, "SELECT payload->>'$.meta.q' FROM events WHERE id = 1")
+    assert DuckdbEx.Result.rows_chunked(result) == [{"a\"b\n"}]
+  end
+
+  test "atoms outside Latin-1 are written as UTF-8 keys and strings", %{conn: conn} do
+    {:ok, _} = DuckdbEx.query(conn, "CREATE TABLE docs (payload JSON)")
+    {:ok, appender} = Appender.create(conn, nil, "docs")
+
+    :ok = Appender.append_row(appender, [%{:"ключ" => :"значение", nil: true}])
+    :ok = Appender.close(appender)
+    :ok = Appender.destroy(appender)
+
+    assert decode(conn, "SELECT payload FROM docs") == [{%{"ключ" => "значение", "nil" => true}}]
+  end
+
+  test "values without a JSON form are rejected", %{conn: conn} do
+    {:ok, _} = DuckdbEx.query(conn, "CREATE TABLE docs (payload JSON)")
+    {:ok, appender} = Appender.create(conn, nil, "docs")
+
+    assert {:error, _} = Appender.append_json(appender, %{"t" => {1, 2}})
+    assert {:error, _} = Appender.append_json(appender, %{"d" => ~D[2024-01-01]})
+    assert {:error, _} = Appender.append_json(appender, [1 | 2])
+    assert {:error, _} = Appender.append_row(appender, [~c"abc"])
+
+    :ok = Appender.destroy(appender)
+  end
+end
@@ -0,0 +1,36 @@
+defmodule DuckdbEx.NifDownloaderTest do
+  use ExUnit.Case, async: false
+
+  alias DuckdbEx.NifDownloader
+
+  test "supported variants match the host architecture" do
+    variants = NifDownloader.supported_variants()
+    arch = to_string(:erlang.system_info(:system_architecture))
+
+    assert Enum.all?(variants, &(&1 in ["x86-64-v3", "armv8.2-a"]))
+
+    if String.contains?(arch, "x86_64") do
+      refute "armv8.2-a" in variants
+    end
+  end
+
+  test "nif_path points at an installed build" do
+    path = NifDownloader.nif_path()
+    assert Path.basename(path) =~ ~r/^duckdb_ex(-[\w.-]+)?$/
+    assert File.exists?(path <> ".so") or File.exists?(path <> ".dll")
+  end
+
+  test "cache directory honours DUCKDB_EX_NIF_CACHE_DIR" do
+    previous = System.get_env("DUCKDB_EX_NIF_CACHE_DIR")
+
+    try do
+      System.put_env("DUCKDB_EX_NIF_CACHE_DIR", "/tmp/duckdb_ex_nif_cache")
+      assert NifDownloader.cache_dir() == "/tmp/duckdb_ex_nif_cache"
+
+      System.delete_env("DUCKDB_EX_NIF_CACHE_DIR")
+      assert NifDownloader.cache_dir() == :filename.basedir(:user_cache, "duckdb_ex")
+    after
+      if previous, do: System.put_env("DUCKDB_EX_NIF_CACHE_DIR", previous)
+    end
+  end
+end
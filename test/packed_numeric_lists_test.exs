@@ -0,0 +1,47 @@
+defmodule DuckdbEx.PackedNumericListsTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  setup :open_connection
+
+  defp floats(bin), do: for(<<x::float-32-native <- bin>>, do: x)
+
+  test "FLOAT arrays decode to packed f32 binaries", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, """
+      SELECT [i, i + 0.5, -i - 1]::FLOAT[3] AS embedding FROM range(3) t(i) ORDER BY i
+      """)
+
+    rows = DuckdbEx.Result.rows_chunked(result, numeric_lists: :packed)
+    assert Enum.all?(rows, fn {bin} -> byte_size(bin) == 12 end)
+
+    assert Enum.map(rows, fn {bin} -> floats(bin) end) == [
+             [0.0, 0.5, -1.0],
+             [1.0, 1.5, -2.0],
+             [2.0, 2.5, -3.0]
+           ]
+
+    assert [{[_, 0.5, -1.0]} | _] = DuckdbEx.Result.rows_chunked(result)
+  end
+
+  test "LIST cells are sliced at their own offsets", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, """
+      SELECT * FROM (VALUES ([1, 2, 3]::BIGINT[]), ([]::BIGINT[]), ([4]::BIGINT[]), (NULL))
+      """)
+
+    assert [{a}, {b}, {c}, {nil}] = DuckdbEx.rows_chunked(result, numeric_lists: :packed)
+    assert a == <<1::64-signed-native, 2::64-signed-native, 3::64-signed-native>>
+    assert b == <<>>
+    assert c == <<4::64-signed-native>>
+  end
+
+  test "cells with NULL elements and non-numeric lists stay lists", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, "SELECT [1.0, NULL]::DOUBLE[] AS d, ['a', 'b'] AS s, [true] AS b")
+
+    assert [{[1.0, nil], ["a", "b"], [true]}] =
+             DuckdbEx.Result.rows_chunked(result, numeric_lists: :packed)
+  end
+end
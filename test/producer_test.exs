@@ -0,0 +1,96 @@
+defmodule DuckdbEx.ProducerTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  alias DuckdbEx.Producer
+
+  defmodule Sink do
+    use GenStage
+
+    def start_link(test, decode), do: GenStage.start_link(__MODULE__, {test, decode})
+
+    @impl true
+    def init(state), do: {:consumer, state}
+
+    @impl true
+    def handle_events(events, _from, {test, decode} = state) do
+      rows = Enum.flat_map(events, decode)
+      send(test, {:rows, self(), rows})
+      {:noreply, [], state}
+    end
+  end
+
+  setup :open_connection
+
+  # Subscribes `count` sinks and collects their rows until they all stop with the producer
+  defp consume(producer, count, decode) do
+    sinks =
+      for _ <- 1..count do
+        {:ok, sink} = Sink.start_link(self(), decode)
+        ref = Process.monitor(sink)
+        {:ok, _} = GenStage.sync_subscribe(sink, to: producer, max_demand: 2, min_demand: 1)
+        {sink, ref}
+      end
+
+    collect(Map.new(sinks, fn {sink, ref} -> {ref, sink} end), [])
+  end
+
+  defp collect(sinks, rows) when map_size(sinks) == 0, do: rows
+
+  defp collect(sinks, rows) do
+    receive do
+      {:rows, _sink, batch} -> collect(sinks, batch ++ rows)
+      {:DOWN, ref, :process, _sink, :normal} -> collect(Map.delete(sinks, ref), rows)
+    after
+      10_000 -> flunk("sinks did not finish")
+    end
+  end
+
+  test "emits decoded chunks to parallel consumers until exhausted", %{conn: conn} do
+    Process.flag(:trap_exit, true)
+
+    {:ok, producer} =
+      Producer.start_link(connection: conn, query: "SELECT i FROM range(10000) t(i)")
+
+    rows = consume(producer, 3, & &1)
+    assert Enum.sort(rows) == for(i <- 0..9999, do: {i})
+  end
+
+  test "emits raw chunks that consumers decode", %{conn: conn} do
+    Process.flag(:trap_exit, true)
+
+    {:ok, producer} =
+      Producer.start_link(
+        connection: conn,
+        query: "SELECT i, i * 2 FROM range($1) t(i)",
+        params: [5000],
+        emit: :chunks
+      )
+
+    rows = consume(producer, 2, &DuckdbEx.data_chunk_get_data/1)
+    assert length(rows) == 5000
+    assert Enum.all?(rows, fn {i, double} -> double == i * 2 end)
+  end
+
+  test "notifies instead of stopping when done", %{conn: conn} do
+    {:ok, producer} =
+      Producer.start_link(
+        connection: conn,
+        query: "SELECT 1",
+        on_done: {:notify, self()}
+      )
+
+    {:ok, sink} = Sink.start_link(self(), & &1)
+    {:ok, _} = GenStage.sync_subscribe(sink, to: producer)
+
+    assert_receive {:rows, ^sink, [{1}]}
+    assert_receive {:duckdb_ex_producer_done, ^producer}
+    assert Process.alive?(producer)
+  end
+
+  test "fails to start on an invalid query", %{conn: conn} do
+    Process.flag(:trap_exit, true)
+    assert {:error, _reason} = Producer.start_link(connection: conn, query: "SELECT nope")
+  end
+end
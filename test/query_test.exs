@@ -0,0 +1,116 @@
+defmodule DuckdbEx.QueryTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  defmodule Event do
+    defstruct [:id, :kind]
+  end
+
+  defmodule Queries do
+    use DuckdbEx.Query, schema: "test/fixtures/query_schema.sql"
+
+    defquery :kinds_for, "SELECT id, kind FROM events WHERE user_id = $1 ORDER BY id"
+
+    defquery :count_after,
+             "SELECT count(*) AS n, max(id) AS last FROM events WHERE user_id = $1 AND id > $2",
+             as: :maps
+
+    defquery :event, "SELECT id, kind FROM events WHERE id = $1", as: Event
+
+    defquery :payloads, "SELECT payload FROM events ORDER BY id", decode: [json: :decode]
+  end
+
+  setup :open_connection
+
+  setup %{conn: conn} do
+    {:ok, _} = DuckdbEx.query(conn, File.read!("test/fixtures/query_schema.sql"))
+
+    {:ok, _} =
+      DuckdbEx.query(conn, """
+      INSERT INTO events VALUES
+        (1, 10, 'click', '{"x": 1}'), (2, 10, 'view', '[]'), (3, 20, 'click', NULL)
+      """)
+
+    on_exit(fn -> Queries.release(conn) end)
+    :ok
+  end
+
+  test "parameter counts become function arities" do
+    assert function_exported?(Queries, :kinds_for, 2)
+    assert function_exported?(Queries, :count_after, 3)
+    assert function_exported?(Queries, :payloads, 1)
+
+    assert %{params: [:bigint, :bigint], columns: [%{name: "n"}, %{name: "last"}]} =
+             Queries.__query__(:count_after)
+  end
+
+  test "queries run with and without prepare_all", %{conn: conn} do
+    assert {:ok, [{1, "click"}, {2, "view"}]} = Queries.kinds_for(conn, 10)
+
+    assert :ok = Queries.prepare_all(conn)
+
+    assert {:ok, [{1, "click"}, {2, "view"}]} = Queries.kinds_for(conn, 10)
+    assert {:ok, [%{n: 1, last: 2}]} = Queries.count_after(conn, 10, 1)
+    assert {:ok, [%Event{id: 3, kind: "click"}]} = Queries.event(conn, 3)
+    assert {:ok, []} = Queries.event(conn, 99)
+    assert {:ok, [{%{"x" => 1}}, {[]}, {nil}]} = Queries.payloads(conn)
+  end
+
+  test "processes sharing a prepared query get their own rows", %{conn: conn} do
+    :ok = Queries.prepare_all(conn)
+
+    expected = %{10 => [{1, "click"}, {2, "view"}], 20 => [{3, "click"}], 30 => []}
+
+    1..200
+    |> Task.async_stream(fn i ->
+      user = Enum.at([10, 20, 30], rem(i, 3))
+      {user, Queries.kinds_for(conn, user)}
+    end)
+    |> Enum.each(fn {:ok, {user, result}} -> assert result == {:ok, expected[user]} end)
+  end
+
+  test "prepared statements are released with the connection", %{conn: conn} do
+    :ok = Queries.prepare_all(conn)
+    assert length(:ets.match(DuckdbEx.Query, {{Queries, conn, :_}, :_})) == 4
+
+    :ok = Queries.release(conn)
+    assert :ets.match(DuckdbEx.Query, {{Queries, conn, :_}, :_}) == []
+
+    :ok = Queries.prepare_all(conn)
+    DuckdbEx.close_connection(conn)
+    assert :ets.match(DuckdbEx.Query, {{:_, conn, :_}, :_}) == []
+  end
+
+  test "prepare_all reports a schema that no longer matches", %{conn: conn} do
+    {:ok, _} = DuckdbEx.query(conn, "ALTER TABLE events RENAME COLUMN kind TO category")
+
+    assert {:error, {name, reason}} = Queries.prepare_all(conn)
+    assert name in [:kinds_for, :event]
+    assert reason =~ "kind"
+  end
+
+  test "invalid SQL fails compilation" do
+    source = """
+    defmodule DuckdbEx.QueryTest.Broken do
+      use DuckdbEx.Query, schema: "test/fixtures/query_schema.sql"
+      defquery :broken, "SELECT missing_column FROM events"
+    end
+    """
+
+    error = assert_raise CompileError, fn -> Code.compile_string(source) end
+    assert Exception.message(error) =~ "defquery :broken is invalid"
+  end
+
+  test "unvalidated queries take their parameter count from options", %{conn: conn} do
+    [{module, _}] =
+      Code.compile_string("""
+      defmodule DuckdbEx.QueryTest.Unvalidated do
+        use DuckdbEx.Query, validate: false
+        defquery :kind, "SELECT kind FROM events WHERE id = $1", params: 1
+      end
+      """)
+
+    assert {:ok, [{"view"}]} = module.kind(conn, 2)
+  end
+end
@@ -0,0 +1,128 @@
+defmodule DuckdbEx.ReplicationTest do
+  use ExUnit.Case, async: false
+
+  alias DuckdbEx.{Appender, Replication}
+  alias DuckdbEx.Replication.{Follower, Leader}
+
+  @create "CREATE TABLE events (id INTEGER, kind VARCHAR, score DOUBLE)"
+
+  defp open_database do
+    {:ok, db} = DuckdbEx.open()
+    {:ok, conn} = DuckdbEx.connect(db)
+    {:ok, _} = DuckdbEx.query(conn, @create)
+    {db, conn}
+  end
+
+  setup do
+    {_leader_db, leader_conn} = open_database()
+    {follower_db, _} = open_database()
+
+    follower = start_supervised!({Follower, database: follower_db})
+    leader = start_supervised!({Leader, followers: [follower], heartbeat: 50})
+
+    %{conn: leader_conn, leader: leader, follower: follower}
+  end
+
+  test "batches are columnar-encoded and decoded losslessly" do
+    rows = [[1, "a", 0.5], [2, nil, 1.5], [3, "a", nil]]
+    payload = Replication.encode_batch(nil, "events", rows)
+
+    assert {nil, "events", ^rows} = Replication.decode_batch(payload)
+    assert {"s", "t", []} = Replication.decode_batch(Replication.encode_batch("s", "t", []))
+  end
+
+  test "flushed batches are applied on followers in order", ctx do
+    opts = [replicate: ctx.leader]
+    :ok = Appender.insert_rows(ctx.conn, nil, "events", [[1, "a", 0.5], [2, "b", 1.5]], opts)
+    :ok = Appender.insert_rows(ctx.conn, nil, "events", [[3, "a", 2.5]], opts)
+
+    # The leader's reply comes after the sends, so the follower has both batches queued
+    assert %{applied_seq: 2, lag_ms: 0} = Follower.status(ctx.follower)
+
+    assert {:ok, {_, rows}} = Follower.query(ctx.follower, "SELECT * FROM events ORDER BY id")
+    assert rows == [{1, "a", 0.5}, {2, "b", 1.5}, {3, "a", 2.5}]
+
+    assert %{seq: 2, followers: %{}} = Leader.lag(ctx.leader)
+    Process.sleep(100)
+    assert Leader.lag(ctx.leader).followers[ctx.follower] == 0
+  end
+
+  test "out-of-order batches wait for the gap and lagging reads are refused", ctx do
+    second = Replication.encode_batch(nil, "events", [[2, "late", 0.0]])
+    first = Replication.encode_batch(nil, "events", [[1, "early", 0.0]])
+
+    send(ctx.follower, {:duckdb_ex_batch, self(), :test, 2, second})
+    assert %{applied_seq: 0, leader_seq: 2} = Follower.status(ctx.follower)
+
+    Process.sleep(20)
+    assert {:error, {:lagging, lag}} = Follower.query(ctx.follower, "SELECT 1", max_lag: 10)
+    assert lag >= 10
+
+    send(ctx.follower, {:duckdb_ex_batch, self(), :test, 1, first})
+    assert %{applied_seq: 2, lag_ms: 0} = Follower.status(ctx.follower)
+    assert_received {:duckdb_ex_ack, :test, 2}
+
+    assert {:ok, {_, [{2}]}} = Follower.query(ctx.follower, "SELECT count(*) FROM events")
+  end
+
+  test "batches lost on the way are sent again on the heartbeat", ctx do
+    # Nothing is registered under the name yet, so the first sends go nowhere
+    late = {:replication_test_late_follower, node()}
+    leader = start_supervised!({Leader, followers: [late], heartbeat: 50}, id: :late_leader)
+
+    :ok = Appender.insert_rows(ctx.conn, nil, "events", [[1, "a", 0.5]], replicate: leader)
+    :ok = Appender.insert_rows(ctx.conn, nil, "events", [[2, "b", 1.5]], replicate: leader)
+
+    {follower_db, _} = open_database()
+
+    follower =
+      start_supervised!(
+        {Follower, database: follower_db, name: :replication_test_late_follower},
+        id: :late_follower
+      )
+
+    Process.sleep(200)
+    assert %{applied_seq: 2, lag_ms: 0} = Follower.status(follower)
+    assert Leader.lag(leader).followers[late] == 0
+  end
+
+  test "followers added later catch up from their applied sequence number", ctx do
+    opts = [replicate: ctx.leader]
+    :ok = Appender.insert_rows(ctx.conn, nil, "events", [[1, "a", 0.5]], opts)
+    :ok = Appender.insert_rows(ctx.conn, nil, "events", [[2, "b", 1.5]], opts)
+
+    # The new follower's database already holds the first batch
+    {follower_db, follower_conn} = open_database()
+    {:ok, _} = DuckdbEx.query(follower_conn, "INSERT INTO events VALUES (1, 'a', 0.5)")
+
+    follower =
+      start_supervised!({Follower, database: follower_db, applied_seq: 1}, id: :added)
+
+    assert :ok = Leader.add_follower(ctx.leader, follower, 1)
+    assert %{applied_seq: 2} = Follower.status(follower)
+
+    assert {:ok, {_, rows}} = Follower.query(follower, "SELECT id FROM events ORDER BY id")
+    assert rows == [{1}, {2}]
+
+    assert {:error, :ahead_of_leader} = Leader.add_follower(ctx.leader, :other, 3)
+  end
+
+  test "followers behind the retained batches need a snapshot", ctx do
+    leader = start_supervised!({Leader, followers: [ctx.follower], retain: 0}, id: :no_retain)
+
+    :ok = Appender.insert_rows(ctx.conn, nil, "events", [[1, "a", 0.5]], replicate: leader)
+    assert %{applied_seq: 1} = Follower.status(ctx.follower)
+    Process.sleep(20)
+
+    assert {:error, :snapshot_required} = Leader.add_follower(leader, self(), 0)
+    assert :ok = Leader.add_follower(leader, self(), 1)
+  end
+
+  test "a batch that cannot be applied stops reads", ctx do
+    bad = Replication.encode_batch(nil, "missing_table", [[1]])
+    send(ctx.follower, {:duckdb_ex_batch, self(), :test, 1, bad})
+
+    assert %{failed: {1, _}} = Follower.status(ctx.follower)
+    assert {:error, {:apply_failed, {1, _}}} = Follower.query(ctx.follower, "SELECT 1")
+  end
+end
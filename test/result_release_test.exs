@@ -0,0 +1,106 @@
+defmodule DuckdbEx.ResultReleaseTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  alias DuckdbEx.Result
+
+  setup :open_connection
+
+  test "destroyed results return errors instead of data", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT 1 as a")
+    {:ok, chunk} = Result.get_chunk(result, 0)
+
+    assert :ok = Result.destroy(result)
+    assert :ok = Result.destroy(result)
+
+    assert {:error, "Result has been destroyed"} = Result.rows(result)
+    assert {:error, "Result has been destroyed"} = Result.rows_chunked(result)
+    assert {:error, "Result has been destroyed"} = Result.columns(result)
+    assert {:error, "Result has been destroyed"} = Result.next_chunk(result)
+    assert {:error, "Result has been destroyed"} = DuckdbEx.data_chunk_get_data(chunk)
+  end
+
+  test "results under the limits are fully materialized", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT i FROM range(5000) t(i)", max_rows: 10_000)
+
+    assert Result.row_count(result) == 5000
+    assert Result.chunk_count(result) > 1
+    assert Result.rows_chunked(result) == Enum.map(0..4999, &{&1})
+    assert Result.rows(result) == Enum.map(0..4999, &{&1})
+
+    {:ok, first} = Result.get_chunk(result, 0)
+    {:ok, second} = Result.get_chunk(result, 1)
+    {last} = List.last(DuckdbEx.data_chunk_get_data(first))
+    assert [{next} | _] = DuckdbEx.data_chunk_get_data(second)
+    assert next == last + 1
+  end
+
+  test "max_rows fails the query by default", %{conn: conn} do
+    assert {:error, message} = DuckdbEx.query(conn, "SELECT i FROM range(100000) t(i)", max_rows: 1000)
+    assert message =~ "limit"
+
+    assert {:error, _} =
+             DuckdbEx.query(conn, "SELECT repeat('x', 100) FROM range(100000)", max_result_bytes: 100_000)
+  end
+
+  test "on_limit: :stream hands back the rest of the result", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, "SELECT i FROM range(100000) t(i)", max_rows: 1000, on_limit: :stream)
+
+    assert Result.chunk_count(result) == 0
+    assert {:error, _} = Result.get_chunk(result, 0)
+    assert Enum.to_list(Result.stream(result)) == Enum.map(0..99_999, &{&1})
+    assert Result.next_chunk(result) == :done
+  end
+
+  test "streaming results can be read chunk by chunk or all at once", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT i FROM range(10000) t(i)", stream: true)
+
+    assert {:ok, first} = Result.next_chunk(result)
+    assert hd(first) == {0}
+
+    rest = Result.rows(result)
+    assert first ++ rest == Enum.map(0..9999, &{&1})
+    assert Result.rows(result) == []
+  end
+
+  test "next_chunk walks materialized results", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT i FROM range(3000) t(i)")
+
+    rows =
+      Stream.repeatedly(fn -> Result.next_chunk(result) end)
+      |> Enum.take_while(&(&1 != :done))
+      |> Enum.flat_map(fn {:ok, rows} -> rows end)
+
+    assert rows == Enum.map(0..2999, &{&1})
+    assert Result.next_chunk(result) == :done
+  end
+
+  test "query errors are reported through the bounded path", %{conn: conn} do
+    assert {:error, _} = DuckdbEx.query(conn, "SELECT * FROM missing_table", max_rows: 10)
+  end
+
+  test "the bounded path rejects multi-statement SQL", %{conn: conn} do
+    sql = "CREATE TABLE t AS SELECT 1 AS a; SELECT * FROM t"
+
+    assert {:error, "Streaming and bounded queries take a single SQL statement"} =
+             DuckdbEx.query(conn, sql, max_rows: 10)
+
+    assert {:ok, _} = DuckdbEx.query(conn, sql)
+  end
+
+  test "prefetching streams return every chunk in order", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT i FROM range(200000) t(i)", stream: true, prefetch: 4)
+
+    assert Enum.to_list(Result.stream(result)) == Enum.map(0..199_999, &{&1})
+  end
+
+  test "destroying a prefetching stream stops the producer", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT i FROM range(1000000) t(i)", stream: true, prefetch: 2)
+
+    assert {:ok, [{0} | _]} = Result.next_chunk(result)
+    assert :ok = Result.destroy(result)
+    assert {:error, "Result has been destroyed"} = Result.next_chunk(result)
+  end
+end
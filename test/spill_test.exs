@@ -0,0 +1,75 @@
+defmodule DuckdbEx.SpillTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  alias DuckdbEx.Result
+
+  setup :open_connection
+
+  setup do
+    spill_dir =
+      Path.join(System.tmp_dir!(), "duckdb_ex_spill_test_#{System.unique_integer([:positive])}")
+
+    File.mkdir_p!(spill_dir)
+    on_exit(fn -> File.rm_rf!(spill_dir) end)
+
+    {:ok, spill_dir: spill_dir}
+  end
+
+  test "oversized results are spilled to parquet and streamed back", %{conn: conn, spill_dir: spill_dir} do
+    {:ok, result} =
+      DuckdbEx.query(conn, "SELECT i, 'row_' || i AS name FROM range(50000) t(i);",
+        max_rows: 1000,
+        on_limit: :spill,
+        spill_dir: spill_dir
+      )
+
+    assert [spill_file] = File.ls!(spill_dir)
+    assert String.ends_with?(spill_file, ".parquet")
+
+    assert [%{name: "i"}, %{name: "name"}] = Result.columns(result)
+
+    assert Enum.to_list(Result.stream(result)) == Enum.map(0..49_999, &{&1, "row_#{&1}"})
+
+    assert :ok = Result.destroy(result)
+    assert File.ls!(spill_dir) == []
+  end
+
+  test "spilled queries run only once", %{conn: conn, spill_dir: spill_dir} do
+    {:ok, _} = DuckdbEx.query(conn, "CREATE SEQUENCE seq")
+
+    {:ok, result} =
+      DuckdbEx.query(conn, "SELECT nextval('seq') AS n FROM range(5000)",
+        max_rows: 1000,
+        on_limit: :spill,
+        spill_dir: spill_dir
+      )
+
+    assert result |> Result.stream() |> Enum.count() == 5000
+    Result.destroy(result)
+
+    {:ok, next} = DuckdbEx.query(conn, "SELECT nextval('seq')")
+    assert Result.rows(next) == [{5001}]
+  end
+
+  test "queries ending in a line comment are spilled", %{conn: conn, spill_dir: spill_dir} do
+    {:ok, result} =
+      DuckdbEx.query(conn, "SELECT i FROM range(5000) t(i) -- every row",
+        max_rows: 1000,
+        on_limit: :spill,
+        spill_dir: spill_dir
+      )
+
+    assert result |> Result.stream() |> Enum.count() == 5000
+    Result.destroy(result)
+  end
+
+  test "results under the limit are not spilled", %{conn: conn, spill_dir: spill_dir} do
+    {:ok, result} =
+      DuckdbEx.query(conn, "SELECT 42 AS answer", max_rows: 1000, on_limit: :spill, spill_dir: spill_dir)
+
+    assert File.ls!(spill_dir) == []
+    assert Result.rows(result) == [{42}]
+  end
+end
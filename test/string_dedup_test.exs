@@ -0,0 +1,73 @@
+defmodule DuckdbEx.StringDedupTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  alias DuckdbEx.Result
+
+  setup :open_connection
+
+  test "repeated strings share one binary across chunks", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, """
+      SELECT i, CASE i % 3 WHEN 0 THEN 'active' WHEN 1 THEN 'pending' ELSE NULL END AS status
+      FROM range(6000) t(i)
+      """)
+
+    rows = Result.rows_chunked(result, dedup_strings: true)
+    assert length(rows) == 6000
+
+    actives = for {i, status} <- rows, rem(i, 3) == 0, do: status
+    assert Enum.all?(actives, &(&1 == "active"))
+    assert Enum.all?(actives, &:erts_debug.same(&1, hd(actives)))
+
+    assert Enum.all?(for({i, status} <- rows, rem(i, 3) == 2, do: status), &is_nil/1)
+  end
+
+  test "high cardinality columns fall back to plain copies", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT 'value_' || (i % 100) AS v FROM range(1000) t(i)")
+
+    rows = Result.rows_chunked(result, dedup_strings: 10)
+    assert rows == Enum.map(0..999, &{"value_#{rem(&1, 100)}"})
+  end
+
+  test "dedup works with next_chunk and streaming results", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT 'x' AS v FROM range(3000)", stream: true)
+
+    rows = result |> Result.stream(dedup_strings: true) |> Enum.to_list()
+    assert length(rows) == 3000
+    assert Enum.all?(rows, &(&1 == {"x"}))
+  end
+
+  test "next_chunk shares dictionaries across the chunks of a result", %{conn: conn} do
+    sql = "SELECT repeat('x', 100) AS v FROM range(5000)"
+    {:ok, result} = DuckdbEx.query(conn, sql, stream: true)
+
+    values = for {v} <- Result.stream(result, dedup_strings: true), do: v
+    assert length(values) == 5000
+    assert Enum.all?(values, &(&1 == String.duplicate("x", 100)))
+
+    # Every chunk refers to the one off-heap binary made for the first occurrence
+    {:binary, binaries} = Process.info(self(), :binary)
+    assert [_] = for({_address, 100, _refs} <- binaries, do: :ok)
+  end
+
+  test "changing dedup_strings between chunks starts new dictionaries", %{conn: conn} do
+    sql = "SELECT 'value_' || (i % 50) AS v FROM range(6000) t(i)"
+    {:ok, result} = DuckdbEx.query(conn, sql, stream: true)
+
+    assert {:ok, first} = Result.next_chunk(result, dedup_strings: true)
+    assert {:ok, second} = Result.next_chunk(result, dedup_strings: 10)
+    assert {:ok, third} = Result.next_chunk(result, dedup_strings: true)
+
+    rows = first ++ second ++ third
+    assert rows == Enum.map(0..(length(rows) - 1), &{"value_#{rem(&1, 50)}"})
+  end
+
+  test "invalid decode options raise", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT 'x' AS v")
+
+    assert_raise ArgumentError, fn -> Result.rows_chunked(result, dedup_strings: -1) end
+    assert_raise ArgumentError, fn -> Result.rows_chunked(result, dedup_strings: 2_000_000) end
+  end
+end
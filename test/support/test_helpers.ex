@@ -0,0 +1,28 @@
+defmodule DuckdbEx.TestHelpers do
+  @moduledoc false
+
+  import ExUnit.Callbacks, only: [on_exit: 1]
+
+  @doc """
+  Opens an in-memory database and a connection to it, both closed when the test exits.
+  """
+  def open_connection() do
+    {:ok, db} = DuckdbEx.open()
+    {:ok, conn} = DuckdbEx.connect(db)
+
+    on_exit(fn ->
+      DuckdbEx.close_connection(conn)
+      DuckdbEx.close_database(db)
+    end)
+
+    conn
+  end
+
+  @doc """
+  Setup callback putting a connection from `open_connection/0` into the context as `:conn`.
+
+      import DuckdbEx.TestHelpers
+      setup :open_connection
+  """
+  def open_connection(_context), do: %{conn: open_connection()}
+end
@@ -0,0 +1,48 @@
+defmodule DuckdbEx.TemporalRawTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  setup :open_connection
+
+  test "temporal: :raw returns storage integers", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, """
+      SELECT DATE '1970-01-11' AS d,
+             TIME '01:00:00.5' AS t,
+             TIMESTAMP '1970-01-01 00:00:01' AS ts,
+             TIMESTAMP_S '1970-01-01 00:01:00' AS ts_s,
+             TIMESTAMP_MS '1970-01-01 00:00:02' AS ts_ms,
+             TIMESTAMP_NS '1970-01-01 00:00:00.000000123' AS ts_ns,
+             DATE '1969-12-31' AS before_epoch,
+             NULL::DATE AS null_date
+      """)
+
+    assert [{10, 3_600_500_000, 1_000_000, 60, 2_000, 123, -1, nil}] =
+             DuckdbEx.Result.rows_chunked(result, temporal: :raw)
+  end
+
+  test "intervals are {months, days, micros} on both row paths", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(
+        conn,
+        "SELECT INTERVAL '1 month 2 days 3 seconds' AS i, INTERVAL 0 DAY AS z"
+      )
+
+    assert [{{1, 2, 3_000_000}, {0, 0, 0}}] = DuckdbEx.Result.rows(result)
+    assert DuckdbEx.Result.rows(result) == DuckdbEx.Result.rows_chunked(result, temporal: :raw)
+  end
+
+  test "raw values survive the type conversion pass", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT DATE '2024-01-01' AS d")
+
+    assert [{19_723}] = DuckdbEx.rows_chunked(result, temporal: :raw)
+    assert [{~D[2024-01-01]}] = DuckdbEx.rows_chunked(result)
+  end
+
+  test "rejects unknown temporal modes", %{conn: conn} do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT DATE '2024-01-01'")
+
+    assert_raise ArgumentError, fn -> DuckdbEx.Result.rows_chunked(result, temporal: :iso) end
+  end
+end
@@ -0,0 +1,146 @@
+defmodule DuckdbEx.TenantRegistryTest do
+  use ExUnit.Case, async: true
+
+  alias DuckdbEx.TenantRegistry
+
+  setup do
+    dir = Path.join(System.tmp_dir!(), "duckdb_ex_tenants_#{System.unique_integer([:positive])}")
+    on_exit(fn -> File.rm_rf!(dir) end)
+    %{dir: dir}
+  end
+
+  defp count(conn) do
+    {:ok, result} = DuckdbEx.query(conn, "SELECT count(*) FROM t")
+    [{n}] = DuckdbEx.Result.rows_chunked(result)
+    n
+  end
+
+  # Evicted databases are closed by a task, so the registry catches up shortly after
+  defp eventually(fun, attempts \\ 100) do
+    if attempts > 1 and not fun.() do
+      Process.sleep(10)
+      eventually(fun, attempts - 1)
+    else
+      assert fun.()
+    end
+  end
+
+  test "databases open lazily and keep their data across eviction", %{dir: dir} do
+    registry = start_supervised!({TenantRegistry, dir: dir, max_open: 2})
+
+    for tenant <- ["a", "b", "c"] do
+      TenantRegistry.with_tenant(registry, tenant, fn conn ->
+        {:ok, _} = DuckdbEx.query(conn, "CREATE TABLE t AS SELECT * FROM range(10)")
+      end)
+    end
+
+    assert File.exists?(Path.join(dir, "a.duckdb"))
+    eventually(fn -> not TenantRegistry.open?(registry, "a") end)
+    assert %{open: 2, in_use: 0} = TenantRegistry.stats(registry)
+
+    # "a" is reopened from its file, evicting "b", the least recently used
+    assert TenantRegistry.with_tenant(registry, "a", &count/1) == 10
+    assert TenantRegistry.open?(registry, "a")
+    eventually(fn -> not TenantRegistry.open?(registry, "b") end)
+    assert TenantRegistry.open?(registry, "c")
+  end
+
+  test "databases in use are not evicted", %{dir: dir} do
+    registry = start_supervised!({TenantRegistry, dir: dir, max_open: 1})
+
+    {:ok, conn} = TenantRegistry.checkout(registry, "busy")
+    {:ok, _} = DuckdbEx.query(conn, "CREATE TABLE t (x INTEGER)")
+
+    TenantRegistry.with_tenant(registry, "other", fn _ -> :ok end)
+
+    assert TenantRegistry.open?(registry, "busy")
+    eventually(fn -> not TenantRegistry.open?(registry, "other") end)
+    assert %{open: 1, in_use: 1} = TenantRegistry.stats(registry)
+
+    :ok = TenantRegistry.checkin(registry, "busy")
+    assert %{open: 1, in_use: 0} = TenantRegistry.stats(registry)
+  end
+
+  test "checkin closes the connection and eviction releases the file", %{dir: dir} do
+    registry = start_supervised!({TenantRegistry, dir: dir, max_open: 1})
+
+    {:ok, conn} = TenantRegistry.checkout(registry, "a")
+    {:ok, _} = DuckdbEx.query(conn, "CREATE TABLE t AS SELECT * FROM range(5)")
+    :ok = TenantRegistry.checkin(registry, "a")
+    assert {:error, "Connection has been closed"} = DuckdbEx.query(conn, "SELECT 1")
+
+    TenantRegistry.with_tenant(registry, "b", fn _ -> :ok end)
+    eventually(fn -> not TenantRegistry.open?(registry, "a") end)
+
+    # Nothing of the evicted instance is left to conflict with another one on the file
+    {:ok, db} = DuckdbEx.open(Path.join(dir, "a.duckdb"))
+    {:ok, other} = DuckdbEx.connect(db)
+    {:ok, _} = DuckdbEx.query(other, "INSERT INTO t VALUES (5)")
+    DuckdbEx.close_connection(other)
+    DuckdbEx.close_database(db)
+
+    assert TenantRegistry.with_tenant(registry, "a", &count/1) == 6
+  end
+
+  test "connections held by a process are released when it exits", %{dir: dir} do
+    registry = start_supervised!({TenantRegistry, dir: dir, max_open: 1})
+    parent = self()
+
+    {pid, ref} =
+      spawn_monitor(fn ->
+        {:ok, _conn} = TenantRegistry.checkout(registry, "x")
+        send(parent, :checked_out)
+      end)
+
+    assert_receive :checked_out
+    assert_receive {:DOWN, ^ref, :process, ^pid, _}
+
+    assert %{in_use: 0} = TenantRegistry.stats(registry)
+    TenantRegistry.with_tenant(registry, "y", fn _ -> :ok end)
+    eventually(fn -> not TenantRegistry.open?(registry, "x") end)
+  end
+
+  test "memory budget evicts idle databases", %{dir: dir} do
+    registry =
+      start_supervised!(
+        {TenantRegistry, path: &Path.join(dir, "db_#{&1}.duckdb"), memory_budget: 1}
+      )
+
+    File.mkdir_p!(dir)
+
+    TenantRegistry.with_tenant(registry, 1, fn conn ->
+      {:ok, _} = DuckdbEx.query(conn, "CREATE TABLE t AS SELECT range AS x FROM range(100000)")
+      assert count(conn) == 100_000
+    end)
+
+    assert File.exists?(Path.join(dir, "db_1.duckdb"))
+    eventually(fn -> match?(%{open: 0}, TenantRegistry.stats(registry)) end)
+  end
+
+  test "a slow open does not hold up other tenants", %{dir: dir} do
+    File.mkdir_p!(dir)
+    parent = self()
+
+    path = fn
+      "slow" ->
+        send(parent, {:opening, self()})
+
+        receive do
+          :go -> Path.join(dir, "slow.duckdb")
+        end
+
+      tenant ->
+        Path.join(dir, "#{tenant}.duckdb")
+    end
+
+    registry = start_supervised!({TenantRegistry, path: path})
+    slow = Task.async(fn -> TenantRegistry.with_tenant(registry, "slow", fn _ -> :slow end) end)
+    assert_receive {:opening, opener}
+
+    assert TenantRegistry.with_tenant(registry, "fast", fn _ -> :fast end) == :fast
+    refute TenantRegistry.open?(registry, "slow")
+
+    send(opener, :go)
+    assert Task.await(slow) == :slow
+  end
+end
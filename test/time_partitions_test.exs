@@ -0,0 +1,130 @@
+defmodule DuckdbEx.TimePartitionsTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  alias DuckdbEx.TimePartitions
+
+  setup :open_connection
+
+  setup %{conn: conn} do
+    dir = Path.join(System.tmp_dir!(), "duckdb_ex_cold_#{System.unique_integer([:positive])}")
+    on_exit(fn -> File.rm_rf!(dir) end)
+
+    events =
+      start_supervised!(
+        {TimePartitions,
+         connection: conn,
+         table: "events",
+         columns: "id BIGINT, ts TIMESTAMP, kind VARCHAR",
+         time_column: "ts",
+         granularity: :day,
+         hot_for: 3600,
+         rotate_interval: nil,
+         cold_dir: dir}
+      )
+
+    %{events: events, dir: dir}
+  end
+
+  defp select(conn, sql) do
+    {:ok, result} = DuckdbEx.query(conn, sql)
+    DuckdbEx.Result.rows_chunked(result)
+  end
+
+  test "rows land in daily partitions behind the view", %{conn: conn, events: events} do
+    assert select(conn, "SELECT count(*) FROM events") == [{0}]
+
+    rows = [
+      [1, ~N[2024-01-01 10:00:00], "a"],
+      [2, ~U[2024-01-02 23:59:59Z], "b"],
+      [3, ~D[2024-01-02], "c"],
+      [4, DateTime.new!(~D[2024-01-03], ~T[01:00:00], "Etc/UTC"), "d"]
+    ]
+
+    assert :ok = TimePartitions.insert_rows(events, rows)
+
+    assert TimePartitions.partitions(events).hot ==
+             ["events_p20240101", "events_p20240102", "events_p20240103"]
+
+    assert select(conn, "SELECT id, ts FROM events ORDER BY id") == [
+             {1, ~U[2024-01-01 10:00:00Z]},
+             {2, ~U[2024-01-02 23:59:59Z]},
+             {3, ~U[2024-01-02 00:00:00Z]},
+             {4, ~U[2024-01-03 01:00:00Z]}
+           ]
+  end
+
+  test "aged partitions move to Parquet and stay queryable", %{conn: conn, events: events} do
+    :ok =
+      TimePartitions.insert_rows(events, [
+        [1, ~N[2024-01-01 10:00:00], "a"],
+        [2, ~N[2024-01-02 10:00:00], "b"],
+        [3, ~N[2024-01-03 10:00:00], "c"]
+      ])
+
+    # The 2024-01-02 partition ended less than an hour before
+    assert {:ok, ["events_p20240101"]} =
+             TimePartitions.rotate(events, ~U[2024-01-03 00:30:00Z])
+
+    assert %{hot: ["events_p20240102", "events_p20240103"], cold: [cold]} =
+             TimePartitions.partitions(events)
+
+    assert Path.basename(cold) == "events_p20240101.parquet"
+
+    tables = "SELECT count(*) FROM duckdb_tables() WHERE table_name = 'events_p20240101'"
+    assert select(conn, tables) == [{0}]
+
+    assert select(conn, "SELECT id, kind FROM events ORDER BY id") ==
+             [{1, "a"}, {2, "b"}, {3, "c"}]
+
+    assert {:ok, []} = TimePartitions.rotate(events, ~U[2024-01-03 00:30:00Z])
+  end
+
+  test "late rows for a rotated partition are written to a second file", %{
+    conn: conn,
+    events: events,
+    dir: dir
+  } do
+    :ok = TimePartitions.insert_rows(events, [[1, ~N[2024-01-01 10:00:00], "a"]])
+    {:ok, ["events_p20240101"]} = TimePartitions.rotate(events, ~U[2024-02-01 00:00:00Z])
+
+    :ok = TimePartitions.insert_rows(events, [[2, ~N[2024-01-01 11:00:00], "late"]])
+    assert select(conn, "SELECT count(*) FROM events") == [{2}]
+
+    {:ok, ["events_p20240101"]} = TimePartitions.rotate(events, ~U[2024-02-01 00:00:00Z])
+
+    # Another table's export sharing the name prefix is not a partition of this one
+    File.write!(Path.join(dir, "events_pageviews_p20240101.parquet"), "")
+
+    assert %{hot: [], cold: cold} = TimePartitions.partitions(events)
+    assert Enum.map(cold, &Path.basename/1) ==
+             ["events_p20240101.parquet", "events_p20240101_1.parquet"]
+    assert select(conn, "SELECT id FROM events ORDER BY id") == [{1}, {2}]
+  end
+
+  test "partitions survive a restart", %{conn: conn, events: events, dir: dir} do
+    :ok = TimePartitions.insert_rows(events, [[1, ~N[2024-01-01 10:00:00], "a"]])
+    :ok = stop_supervised(TimePartitions)
+
+    {:ok, restarted} =
+      TimePartitions.start_link(
+        connection: conn,
+        table: "events",
+        columns: "id BIGINT, ts TIMESTAMP, kind VARCHAR",
+        time_column: "ts",
+        granularity: :day,
+        rotate_interval: nil,
+        cold_dir: dir
+      )
+
+    assert TimePartitions.partitions(restarted).hot == ["events_p20240101"]
+    assert select(conn, "SELECT count(*) FROM events") == [{1}]
+  end
+
+  test "rows need a temporal time column value", %{events: events} do
+    assert {:error, message} = TimePartitions.insert_rows(events, [[1, 1_704_067_200, "a"]])
+    assert message =~ "ts must be a DateTime"
+    assert TimePartitions.partitions(events).hot == []
+  end
+end
@@ -57,7 +57,7 @@ defmodule DuckdbEx.TimestampTest do
     columns = DuckdbEx.columns(result)
     assert columns == [%{name: "bit_val", type: :bit}]
     chunked_rows = DuckdbEx.rows_chunked(result)
-    assert chunked_rows == [{"\x02\xEA"}]
+    assert chunked_rows == [{<<0b101010::size(6)>>}]
     DuckdbEx.destroy_result(result)
   end
 end
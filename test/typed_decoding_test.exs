@@ -0,0 +1,78 @@
+defmodule DuckdbEx.TypedDecodingTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  setup :open_connection
+
+  test "VARCHAR elements that look like dates stay strings", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, "SELECT ['2023-01-01', '12:00:00'] AS s, [DATE '2023-01-01'] AS d")
+
+    assert [{["2023-01-01", "12:00:00"], [~D[2023-01-01]]}] = DuckdbEx.rows_chunked(result)
+  end
+
+  test "nested struct and map values are typed", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, """
+      SELECT {'day': DATE '2024-02-29', 'at': TIME '08:15:00'} AS s,
+             MAP {'start': TIMESTAMP '2024-01-01 00:00:00'} AS m,
+             [[DATE '2024-01-01']] AS nested
+      """)
+
+    assert [{s, m, [[~D[2024-01-01]]]}] = DuckdbEx.rows_chunked(result)
+    assert s == %{"day" => ~D[2024-02-29], "at" => ~T[08:15:00.000000]}
+    assert %{"start" => ~U[2024-01-01 00:00:00.000000Z]} = m
+  end
+
+  test "precision and time zone timestamps decode to UTC DateTimes", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, """
+      SELECT TIMESTAMP_S '2024-01-01 10:00:00' AS s,
+             TIMESTAMP_MS '2024-01-01 10:00:00.123' AS ms,
+             '1969-12-31 23:59:59.999999500'::TIMESTAMP_NS AS ns,
+             TIMESTAMPTZ '2024-01-01 10:00:00+02:00' AS tz,
+             [TIMESTAMP_S '2024-01-01 10:00:00'] AS list,
+             {'at': TIMESTAMPTZ '2024-01-01 10:00:00+02:00'} AS struct
+      """)
+
+    assert DuckdbEx.rows_chunked(result) == [
+             {~U[2024-01-01 10:00:00Z], ~U[2024-01-01 10:00:00.123Z],
+              ~U[1969-12-31 23:59:59.999999Z], ~U[2024-01-01 08:00:00.000000Z],
+              [~U[2024-01-01 10:00:00Z]], %{"at" => ~U[2024-01-01 08:00:00.000000Z]}}
+           ]
+  end
+
+  test "HUGEINT and UHUGEINT decode to exact integers", %{conn: conn} do
+    sql = """
+    SELECT 170141183460469231731687303715884105727::HUGEINT AS h_max,
+           (-170141183460469231731687303715884105727 - 1)::HUGEINT AS h_min,
+           (-18446744073709551616)::HUGEINT AS h_neg,
+           340282366920938463463374607431768211455::UHUGEINT AS u_max,
+           18446744073709551616::UHUGEINT AS u_mid
+    """
+
+    expected = [
+      {170_141_183_460_469_231_731_687_303_715_884_105_727,
+       -170_141_183_460_469_231_731_687_303_715_884_105_728, -18_446_744_073_709_551_616,
+       340_282_366_920_938_463_463_374_607_431_768_211_455, 18_446_744_073_709_551_616}
+    ]
+
+    {:ok, result} = DuckdbEx.query(conn, sql)
+    assert DuckdbEx.rows(result) == expected
+    assert DuckdbEx.rows_chunked(result) == expected
+  end
+
+  test "row API builds calendar structs without a conversion pass", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, """
+      SELECT DATE '2023-12-25' AS d,
+             TIMESTAMP '2023-12-25 14:30:45.123' AS ts,
+             'infinity'::DATE AS inf,
+             12.50::DECIMAL(6,2) AS dec
+      """)
+
+    assert [{~D[2023-12-25], ~U[2023-12-25 14:30:45.123Z], "infinity", 12.5}] =
+             DuckdbEx.Result.rows(result)
+  end
+end
@@ -399,7 +399,7 @@ defmodule DuckdbEx.TypesTest do
 
         assert is_binary(uuid_val)
         assert is_float(decimal_val) or is_binary(decimal_val)
-        assert is_binary(timestamp_s_val)
+        assert timestamp_s_val == ~U[2023-12-25 14:30:45Z]
         assert is_list(list_val)
         assert list_val == [1, 2, 3]
       end)
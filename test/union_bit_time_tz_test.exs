@@ -0,0 +1,51 @@
+defmodule DuckdbEx.UnionBitTimeTzTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  setup :open_connection
+
+  test "UNION values decode to {tag, value}", %{conn: conn} do
+    {:ok, _} =
+      DuckdbEx.query(conn, "CREATE TABLE events (payload UNION(click INTEGER, page VARCHAR))")
+
+    {:ok, _} =
+      DuckdbEx.query(conn, """
+      INSERT INTO events VALUES
+        (union_value(click := 3)),
+        (union_value(page := '/home')),
+        (NULL)
+      """)
+
+    {:ok, result} = DuckdbEx.query(conn, "SELECT payload FROM events")
+
+    assert DuckdbEx.rows_chunked(result) == [{{:click, 3}}, {{:page, "/home"}}, {nil}]
+  end
+
+  test "UNION members can be nested types", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, """
+      SELECT union_value(tags := ['a', 'b'])::UNION(tags VARCHAR[], id BIGINT) AS u
+      """)
+
+    assert [{{:tags, ["a", "b"]}}] = DuckdbEx.rows_chunked(result)
+  end
+
+  test "BIT values decode to bitstrings", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, """
+      SELECT '1'::BIT AS one, '10101010'::BIT AS byte, '1010101010'::BIT AS ten,
+             '0000000011'::BIT AS padded
+      """)
+
+    assert [{<<1::1>>, <<0xAA>>, <<0b1010101010::10>>, <<0b0000000011::10>>}] =
+             DuckdbEx.rows_chunked(result)
+  end
+
+  test "TIME_TZ decodes to {Time, offset}", %{conn: conn} do
+    {:ok, result} =
+      DuckdbEx.query(conn, "SELECT '14:30:45+02:00'::TIME_TZ AS t, NULL::TIME_TZ AS n")
+
+    assert [{{~T[14:30:45.000000], 7200}, nil}] = DuckdbEx.rows_chunked(result)
+  end
+end
@@ -0,0 +1,130 @@
+defmodule DuckdbEx.VSSBulkLoadTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  alias DuckdbEx.{Appender, VSS}
+  alias DuckdbEx.VSS.BulkLoad
+
+  setup :open_connection
+
+  defp select(conn, sql) do
+    {:ok, result} = DuckdbEx.query(conn, sql)
+    DuckdbEx.Result.rows_chunked(result)
+  end
+
+  defp ids(range), do: for(id <- range, into: <<>>, do: <<id::signed-native-64>>)
+  defp vectors(range), do: VSS.pack(for i <- range, do: [i * 1.0, 1.0, -0.5])
+
+  test "append_columns appends packed columns across several chunks", %{conn: conn} do
+    {:ok, _} =
+      DuckdbEx.query(conn, "CREATE TABLE items (id BIGINT, score DOUBLE, embedding FLOAT[3])")
+
+    {:ok, appender} = Appender.create(conn, nil, "items")
+    scores = for i <- 1..5000, into: <<>>, do: <<i / 2::float-native-64>>
+
+    assert :ok = Appender.append_columns(appender, [ids(1..5000), scores, vectors(1..5000)])
+    assert :ok = Appender.append_columns(appender, [<<>>, <<>>, <<>>])
+    :ok = Appender.close(appender)
+    :ok = Appender.destroy(appender)
+
+    assert select(conn, "SELECT count(*), sum(id) FROM items") == [{5000, 12_502_500}]
+
+    assert select(conn, "SELECT id, score, embedding FROM items WHERE id IN (1, 4097)") == [
+             {1, 0.5, [1.0, 1.0, -0.5]},
+             {4097, 2048.5, [4097.0, 1.0, -0.5]}
+           ]
+  end
+
+  test "append_columns rejects columns that don't fit", %{conn: conn} do
+    {:ok, _} = DuckdbEx.query(conn, "CREATE TABLE items (id BIGINT, embedding FLOAT[3])")
+    {:ok, _} = DuckdbEx.query(conn, "CREATE TABLE named (name VARCHAR)")
+    {:ok, appender} = Appender.create(conn, nil, "items")
+
+    assert {:error, "Expected one binary per appender column"} =
+             Appender.append_columns(appender, [ids(1..2)])
+
+    assert {:error, "All column binaries must hold the same number of rows"} =
+             Appender.append_columns(appender, [ids(1..2), vectors(1..3)])
+
+    assert {:error, message} = Appender.append_columns(appender, [ids(1..2), <<1, 2, 3>>])
+    assert message =~ "not a multiple"
+
+    {:ok, named} = Appender.create(conn, nil, "named")
+    assert {:error, message} = Appender.append_columns(named, ["abc"])
+    assert message =~ "numeric"
+
+    :ok = Appender.destroy(appender)
+    :ok = Appender.destroy(named)
+  end
+
+  test "bulk loads build the index and swap generations", %{conn: conn} do
+    case DuckdbEx.install_and_load(conn, "vss") do
+      :ok ->
+        {:ok, _} = DuckdbEx.query(conn, "CREATE TABLE items (id BIGINT, embedding FLOAT[3])")
+
+        for {range, generation} <- [{1..3000, "items_g1"}, {1..100, "items_g2"}] do
+          {:ok, load} = BulkLoad.new(conn, "items", columns: "id BIGINT, embedding FLOAT[3]")
+          assert load.generation == generation
+
+          :ok = BulkLoad.append(load, [ids(range), vectors(range)])
+          {:ok, ref} = BulkLoad.finish(load, metric: :l2, index_options: [m: 8])
+
+          assert_receive {:duckdb_ex_index_progress, ^ref, 100.0}, 60_000
+          assert BulkLoad.await(ref, 60_000) == :ok
+
+          assert select(conn, "SELECT count(*) FROM items") == [{Enum.count(range)}]
+        end
+
+        assert select(conn, "SELECT table_name FROM duckdb_tables() ORDER BY 1") ==
+                 [{"items_g2"}]
+
+        indexes = "SELECT count(*) FROM duckdb_indexes() WHERE table_name = 'items_g2'"
+        assert select(conn, indexes) == [{1}]
+
+        query = VSS.pack([[42.2, 1, -0.5]])
+        {:ok, [{ids, _}]} = VSS.search(conn, "items", "embedding", query, 1, :l2, id: "id")
+        assert ids == <<42::signed-native-64>>
+
+      {:error, _} ->
+        :ok
+    end
+  end
+
+  test "a failed index build leaves the current data in place", %{conn: conn} do
+    {:ok, _} = DuckdbEx.query(conn, "CREATE VIEW items AS SELECT 1::BIGINT AS id")
+    {:ok, load} = BulkLoad.new(conn, "items", columns: "id BIGINT, embedding FLOAT[3]")
+    :ok = BulkLoad.append(load, [ids(1..10), vectors(1..10)])
+
+    # An unknown HNSW option fails the build with or without the vss extension
+    {:ok, ref} = BulkLoad.finish(load, index_options: [no_such_option: 1])
+    assert {:error, _} = BulkLoad.await(ref, 60_000)
+
+    assert select(conn, "SELECT id FROM items") == [{1}]
+    tables = "SELECT count(*) FROM duckdb_tables() WHERE table_name = 'items_g1'"
+    assert select(conn, tables) == [{0}]
+  end
+
+  test "a crashed index build ends in an error result", %{conn: conn} do
+    {:ok, load} = BulkLoad.new(conn, "items", columns: "id BIGINT, embedding FLOAT[3]")
+    :ok = BulkLoad.append(load, [ids(1..10), vectors(1..10)])
+
+    # An invalid interval raises in the build process while it polls for progress
+    {:ok, ref} = BulkLoad.finish(load, progress_interval: :never)
+    assert {:error, _reason} = BulkLoad.await(ref, 60_000)
+
+    tables = "SELECT count(*) FROM duckdb_tables() WHERE table_name = 'items_g1'"
+    assert select(conn, tables) == [{0}]
+  end
+
+  test "an appender that cannot be closed drops the new generation", %{conn: conn} do
+    columns = "id BIGINT PRIMARY KEY, embedding FLOAT[3]"
+    {:ok, load} = BulkLoad.new(conn, "items", columns: columns)
+    :ok = BulkLoad.append(load, [ids([1, 1]), vectors(1..2)])
+
+    assert {:error, _} = BulkLoad.finish(load)
+
+    tables = "SELECT count(*) FROM duckdb_tables() WHERE table_name = 'items_g1'"
+    assert select(conn, tables) == [{0}]
+  end
+end
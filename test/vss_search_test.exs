@@ -0,0 +1,112 @@
+defmodule DuckdbEx.VSSSearchTest do
+  use ExUnit.Case, async: true
+
+  import DuckdbEx.TestHelpers
+
+  alias DuckdbEx.VSS
+
+  setup :open_connection
+
+  setup %{conn: conn} do
+    {:ok, _} =
+      DuckdbEx.query(conn, """
+      CREATE TABLE items AS
+      SELECT i AS id, [i, 0, 0]::FLOAT[3] AS embedding, i % 2 = 0 AS even
+      FROM range(100) t(i)
+      """)
+
+    :ok
+  end
+
+  defp ids(binary), do: for(<<id::signed-native-64 <- binary>>, do: id)
+  defp floats(binary), do: for(<<d::float-native-32 <- binary>>, do: d)
+
+  test "each query vector gets its k nearest rows", %{conn: conn} do
+    queries = VSS.pack([[10.2, 0, 0], [50.0, 0, 0], [-5.0, 0, 0]])
+
+    assert {:ok, [{a_ids, a_dist}, {b_ids, b_dist}, {c_ids, _}]} =
+             VSS.search(conn, "items", "embedding", queries, 3, :l2, id: "id")
+
+    assert ids(a_ids) == [10, 11, 9]
+    assert [d1, d2, d3] = floats(a_dist)
+    assert_in_delta d1, 0.2, 1.0e-5
+    assert_in_delta d2, 0.8, 1.0e-5
+    assert_in_delta d3, 1.2, 1.0e-5
+
+    assert hd(ids(b_ids)) == 50
+    assert hd(floats(b_dist)) == 0.0
+    assert ids(c_ids) == [0, 1, 2]
+  end
+
+  test "filters, default ids and other metrics", %{conn: conn} do
+    query = VSS.pack([[7.0, 0, 0]])
+    between = VSS.pack([[6.8, 0, 0]])
+
+    assert {:ok, [{ids, _}]} =
+             VSS.search(conn, "items", "embedding", between, 2, :l2, id: "id", where: "even")
+
+    assert ids(ids) == [6, 8]
+
+    # rowid follows insertion order, so it equals id here
+    assert {:ok, [{ids, _}]} = VSS.search(conn, "items", "embedding", query, 1)
+    assert ids(ids) == [7]
+
+    assert {:ok, [{_, distances}]} =
+             VSS.search(conn, "items", "embedding", VSS.pack([[0, 1, 0]]), 2, :cosine)
+
+    assert Enum.all?(floats(distances), &(abs(&1 - 1.0) < 1.0e-6))
+
+    assert {:ok, [{ids, _}]} =
+             VSS.search(conn, "items", "embedding", query, 1, :inner_product, id: "id")
+
+    assert ids(ids) == [99]
+  end
+
+  test "rows with a NULL id or embedding are left out", %{conn: conn} do
+    {:ok, _} =
+      DuckdbEx.query(conn, """
+      INSERT INTO items VALUES (100, NULL, true), (NULL, [1, 0, 0]::FLOAT[3], false)
+      """)
+
+    query = VSS.pack([[0.0, 0, 0]])
+
+    assert {:ok, [{ids, distances}]} =
+             VSS.search(conn, "items", "embedding", query, 200, :l2, id: "id")
+
+    assert length(ids(ids)) == 100
+    assert length(floats(distances)) == 100
+    assert Enum.take(ids(ids), 2) == [0, 1]
+    refute 100 in ids(ids)
+  end
+
+  test "an empty batch and invalid input", %{conn: conn} do
+    assert {:ok, []} = VSS.search(conn, "items", "embedding", <<>>, 5)
+
+    assert {:error, message} = VSS.search(conn, "items", "embedding", VSS.pack([[1, 2]]), 5)
+    assert message =~ "not a multiple of 3 floats"
+
+    assert {:error, "query vectors must be finite"} =
+             VSS.search(conn, "items", "embedding", <<0::32, 0::32, 0x7FC00000::32-native>>, 1)
+
+    assert {:error, message} = VSS.search(conn, "items", "id", VSS.pack([[1]]), 1)
+    assert message =~ "FLOAT[n]"
+
+    assert {:error, _} = VSS.search(conn, "missing", "embedding", VSS.pack([[1, 2, 3]]), 1)
+    assert_raise ArgumentError, fn -> VSS.search(conn, "items", "embedding", <<>>, 1, :dot) end
+  end
+
+  test "searches use an HNSW index when vss is available", %{conn: conn} do
+    case DuckdbEx.install_and_load(conn, "vss") do
+      :ok ->
+        {:ok, _} = DuckdbEx.query(conn, "CREATE INDEX items_hnsw ON items USING HNSW (embedding)")
+
+        queries = VSS.pack(for i <- 0..99, do: [i + 0.1, 0, 0])
+
+        assert {:ok, results} = VSS.search(conn, "items", "embedding", queries, 1, :l2, id: "id")
+        assert Enum.map(results, fn {ids, _} -> hd(ids(ids)) end) == Enum.to_list(0..99)
+
+      {:error, _} ->
+        :ok
+    end
+  end
+end
@@ -295,9 +295,7 @@ defmodule DuckdbEx.WorkingTypesTest do
         # UUID is returned as 36-character string with dashes after the fix
         assert String.length(uuid_val) == 36
         assert is_float(decimal_val) or is_binary(decimal_val) or is_number(decimal_val)
-        assert is_binary(timestamp_s)
-        # timestamp_s is returned as seconds since epoch
-        assert String.match?(timestamp_s, ~r/^\d+$/)
+        assert timestamp_s == ~U[2023-12-25 14:30:45Z]
       end)
     end
 